@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for the CPU random number generators in contrib/random.
+Set TVM_NUM_THREADS to control the number of threads.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te
+from tvm.contrib import random
+
+
+def build_random_fill(shape, dtype):
+    out = te.extern(
+        shape,
+        [],
+        lambda ins, outs: tvm.tir.call_packed("tvm.contrib.random.random_fill", outs[0]),
+        dtype=dtype,
+        name="random_fill",
+    )
+    return tvm.build(te.create_schedule(out.op), [out], "llvm")
+
+
+def build(kernel, shape):
+    if kernel == "uniform":
+        out = random.uniform(0, 1, size=shape)
+    elif kernel == "normal":
+        out = random.normal(0, 1, size=shape)
+    elif kernel == "randint":
+        out = random.randint(-127, 128, size=shape, dtype="int32")
+    else:
+        return build_random_fill(shape, kernel.split(":")[1])
+    return tvm.build(te.create_schedule(out.op), [out], "llvm")
+
+
+def benchmark(kernel, shape, repeat):
+    dev = tvm.cpu(0)
+    func = build(kernel, shape)
+    dtype = kernel.split(":")[1] if kernel.startswith("random_fill") else None
+    out = tvm.nd.empty(shape, dtype or ("int32" if kernel == "randint" else "float32"), dev)
+    ftimer = func.time_evaluator(func.entry_name, dev, number=10, repeat=repeat)
+    prof_res = np.array(ftimer(out).results)
+    num_bytes = np.prod(shape) * np.dtype(out.dtype).itemsize
+    print(
+        "%-20s %-16s %-12s %-12s"
+        % (
+            kernel,
+            str(shape),
+            "%.3f ms" % (np.mean(prof_res) * 1000),
+            "%.2f GB/s" % (num_bytes / np.mean(prof_res) / 1e9),
+        )
+    )
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--size", type=int, default=1 << 24, help="The number of elements.")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    print("-" * 64)
+    print("%-20s %-16s %-12s %-12s" % ("Kernel", "Shape", "Mean Time", "Throughput"))
+    print("-" * 64)
+    for kernel in [
+        "uniform",
+        "normal",
+        "randint",
+        "random_fill:float32",
+        "random_fill:float16",
+        "random_fill:int8",
+    ]:
+        benchmark(kernel, (args.size,), args.repeat)
@@ -0,0 +1,132 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for the CPU sort kernels in contrib/sort.
+The shapes are taken from the post-processing of common object detectors.
+Set TVM_NUM_THREADS to control the number of threads.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+# (name, shape, k) of the scores sorted in detection post-processing.
+WORKLOADS = [
+    ("ssd_mobilenet", (1, 1917), 100),
+    ("ssd_resnet34", (1, 15130), 200),
+    ("yolov5", (1, 25200), 1000),
+    ("retinanet", (1, 120087), 1000),
+    ("faster_rcnn_rpn", (1, 261888), 6000),
+    ("batched_nms", (16, 25200), 1000),
+    ("per_class_nms", (80, 15130), 200),
+]
+
+
+def build_argsort_nms(shape, dtype):
+    data = te.placeholder(shape, name="data", dtype=dtype)
+    sort_num = te.placeholder(shape[:-1], name="sort_num", dtype="int32")
+    out = te.extern(
+        shape,
+        [data, sort_num],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.sort.argsort_nms", ins[0], ins[1], outs[0], -1, False
+        ),
+        dtype="int32",
+        name="argsort_nms",
+    )
+    return tvm.build(te.create_schedule(out.op), [data, sort_num, out], "llvm")
+
+
+def build_argsort(shape, dtype):
+    data = te.placeholder(shape, name="data", dtype=dtype)
+    out = te.extern(
+        shape,
+        [data],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.sort.argsort", ins[0], outs[0], -1, False
+        ),
+        dtype="int32",
+        name="argsort",
+    )
+    return tvm.build(te.create_schedule(out.op), [data, out], "llvm")
+
+
+def build_topk(shape, dtype, k):
+    data = te.placeholder(shape, name="data", dtype=dtype)
+    out_shape = shape[:-1] + (k,)
+    values, indices = te.extern(
+        [out_shape, out_shape],
+        [data],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.sort.topk", ins[0], outs[0], outs[1], k, -1, "both", False
+        ),
+        dtype=[dtype, "int32"],
+        name="topk",
+    )
+    return tvm.build(te.create_schedule(values.op), [data, values, indices], "llvm")
+
+
+def evaluate(func, args, dev, repeat):
+    ftimer = func.time_evaluator(func.entry_name, dev, number=10, repeat=repeat)
+    prof_res = np.array(ftimer(*args).results) * 1000  # multiply 1000 for converting to millisecond
+    return "%.3f ms" % np.mean(prof_res), "%.3f ms" % np.std(prof_res)
+
+
+def benchmark(name, shape, k, dtype, repeat):
+    dev = tvm.cpu(0)
+    np_data = np.random.uniform(size=shape).astype(dtype)
+    data = tvm.nd.array(np_data, dev)
+    sort_num = tvm.nd.array(np.full(shape[:-1], shape[-1], dtype="int32"), dev)
+    indices = tvm.nd.empty(shape, "int32", dev)
+    topk_values = tvm.nd.empty(shape[:-1] + (k,), dtype, dev)
+    topk_indices = tvm.nd.empty(shape[:-1] + (k,), "int32", dev)
+
+    results = []
+    if dtype == "float32":
+        func = build_argsort_nms(shape, dtype)
+        results.append(("argsort_nms", evaluate(func, [data, sort_num, indices], dev, repeat)))
+    results.append(("argsort", evaluate(build_argsort(shape, dtype), [data, indices], dev, repeat)))
+    results.append(
+        (
+            "topk(k=%d)" % k,
+            evaluate(build_topk(shape, dtype, k), [data, topk_values, topk_indices], dev, repeat),
+        )
+    )
+    for kernel, (mean, std) in results:
+        print("%-20s %-16s %-14s %-19s (%s)" % (name, str(shape), kernel, mean, std))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--workload",
+        type=str,
+        choices=[workload[0] for workload in WORKLOADS],
+        help="The name of the workload. All workloads are run by default.",
+    )
+    parser.add_argument("--dtype", type=str, choices=["float32", "float16"], default="float32")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    print("-" * 90)
+    print("%-20s %-16s %-14s %-20s" % ("Workload", "Shape", "Kernel", "Mean Time (std dev)"))
+    print("-" * 90)
+    for name, shape, k in WORKLOADS:
+        if args.workload is None or args.workload == name:
+            benchmark(name, shape, k, args.dtype, args.repeat)
@@ -0,0 +1,80 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for the JSON and binary serialization of IR modules.
+The modules are Relay models with their weights bound as constants.
+see README.md for the usage of this script.
+"""
+import argparse
+import timeit
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+
+WORKLOADS = {
+    "mlp": lambda: testing.mlp.get_workload(batch_size=1),
+    "resnet-18": lambda: testing.resnet.get_workload(num_layers=18),
+    "mobilenet": lambda: testing.mobilenet.get_workload(),
+    "vgg-16": lambda: testing.vgg.get_workload(batch_size=1, num_layers=16),
+}
+
+
+def get_module(name):
+    mod, params = WORKLOADS[name]()
+    func = relay.build_module.bind_params_by_name(mod["main"], params)
+    return tvm.IRModule.from_expr(func)
+
+
+def evaluate(func, repeat):
+    results = np.array(timeit.repeat(func, number=1, repeat=repeat)) * 1000
+    return "%.1f ms" % np.mean(results)
+
+
+def benchmark(name, repeat):
+    mod = get_module(name)
+    json_str = tvm.ir.save_json(mod)
+    blob = tvm.ir.save_binary(mod)
+    tvm.ir.assert_structural_equal(tvm.ir.load_binary(blob), mod)
+    for fmt, size, save, load in [
+        ("json", len(json_str), lambda: tvm.ir.save_json(mod), lambda: tvm.ir.load_json(json_str)),
+        ("binary", len(blob), lambda: tvm.ir.save_binary(mod), lambda: tvm.ir.load_binary(blob)),
+    ]:
+        print(
+            "%-12s %-8s %-12s %-12s %-12s"
+            % (name, fmt, "%.2f MB" % (size / 2**20), evaluate(save, repeat), evaluate(load, repeat))
+        )
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--workload",
+        type=str,
+        choices=list(WORKLOADS),
+        help="The name of the workload. All workloads are run by default.",
+    )
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    print("-" * 60)
+    print("%-12s %-8s %-12s %-12s %-12s" % ("Workload", "Format", "Size", "Save", "Load"))
+    print("-" * 60)
+    for name in WORKLOADS:
+        if args.workload is None or args.workload == name:
+            benchmark(name, args.repeat)
@@ -0,0 +1,71 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for copying tensors to and from a RPC server on the same host,
+through the shared memory session and the socket session.
+see README.md for the usage of this script.
+"""
+import argparse
+import time
+
+import numpy as np
+
+import tvm
+from tvm import rpc
+
+
+def benchmark(name, remote, size, repeat):
+    dev = remote.cpu(0)
+    x_np = np.random.uniform(size=(size,)).astype("float32")
+    x = tvm.nd.empty(x_np.shape, x_np.dtype, dev)
+    y = tvm.nd.empty(x_np.shape, x_np.dtype, tvm.cpu(0))
+    # warmup
+    x.copyfrom(x_np)
+    x.copyto(y)
+    np.testing.assert_equal(y.numpy(), x_np)
+
+    to_remote, from_remote = [], []
+    for _ in range(repeat):
+        start = time.perf_counter()
+        x.copyfrom(x_np)
+        to_remote.append(time.perf_counter() - start)
+        start = time.perf_counter()
+        x.copyto(y)
+        from_remote.append(time.perf_counter() - start)
+    print(
+        "%-16s %-12s %-16s %-16s"
+        % (
+            name,
+            "%d MB" % (x_np.nbytes >> 20),
+            "%.2f GB/s" % (x_np.nbytes / np.mean(to_remote) / 1e9),
+            "%.2f GB/s" % (x_np.nbytes / np.mean(from_remote) / 1e9),
+        )
+    )
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--size", type=int, default=1 << 24, help="The number of elements.")
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    print("-" * 64)
+    print("%-16s %-12s %-16s %-16s" % ("Session", "Size", "To Remote", "From Remote"))
+    print("-" * 64)
+    server = rpc.Server(host="127.0.0.1")
+    benchmark("socket", rpc.connect("127.0.0.1", server.port), args.size, args.repeat)
+    benchmark("shared memory", rpc.connect_shared_memory(), args.size, args.repeat)
+    server.terminate()
@@ -37,4 +37,5 @@
 #include "../../src/runtime/system_library.cc"
 #include "../../src/runtime/thread_pool.cc"
 #include "../../src/runtime/threading_backend.cc"
+#include "../../src/runtime/tracing.cc"
 #include "../../src/runtime/workspace_pool.cc"
@@ -33,6 +33,7 @@
 #include "src/runtime/registry.cc"
 #include "src/runtime/thread_pool.cc"
 #include "src/runtime/threading_backend.cc"
+#include "src/runtime/tracing.cc"
 #include "src/runtime/workspace_pool.cc"
 
 // NOTE: all the files after this are optional modules
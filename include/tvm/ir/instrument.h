@@ -151,6 +151,15 @@ class PassInstrument : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(PassInstrument, ObjectRef, PassInstrumentNode);
 };
 
+/*!
+ * \brief Record lookups of memoized function-level pass results, which the
+ *  PassTimingInstrument reports for the pass currently running.
+ * \param num_lookups The number of lookups.
+ * \param num_hits The number of lookups that found a result.
+ * \sa transform::FunctionPassMemo
+ */
+TVM_DLL void RecordFunctionPassMemoLookups(int num_lookups, int num_hits);
+
 }  // namespace instrument
 }  // namespace tvm
 
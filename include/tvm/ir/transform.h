@@ -63,6 +63,8 @@
 #include <tvm/runtime/container/string.h>
 #include <tvm/support/with.h>
 
+#include <atomic>
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -352,6 +354,12 @@ class PassInfoNode : public Object {
   /*! \brief The passes that are required to perform the current pass. */
   Array<String> required;
 
+  /*!
+   * \brief The parameters of the pass, for a function-level pass whose results can be memoized.
+   *  Undefined for the passes that are never memoized, see FunctionPassMemo.
+   */
+  Optional<Array<ObjectRef>> memo_key;
+
   PassInfoNode() = default;
 
   void VisitAttrs(AttrVisitor* v) {
@@ -359,6 +367,7 @@ class PassInfoNode : public Object {
     v->Visit("name", &name);
     v->Visit("required", &required);
     v->Visit("traceable", &traceable);
+    v->Visit("memo_key", &memo_key);
   }
 
   static constexpr const char* _type_key = "transform.PassInfo";
@@ -378,8 +387,10 @@ class PassInfo : public ObjectRef {
    * \param name Name of the pass.
    * \param required  The passes that are required to perform the current pass.
    * \param traceable Boolean that tells whether the pass is traceable.
+   * \param memo_key The parameters of a function-level pass that can be memoized.
    */
-  TVM_DLL PassInfo(int opt_level, String name, Array<runtime::String> required, bool traceable);
+  TVM_DLL PassInfo(int opt_level, String name, Array<runtime::String> required, bool traceable,
+                   Optional<Array<ObjectRef>> memo_key = NullOpt);
 
   TVM_DEFINE_OBJECT_REF_METHODS(PassInfo, ObjectRef, PassInfoNode);
 };
@@ -541,6 +552,105 @@ class Sequential : public Pass {
   using ContainerType = SequentialNode;
 };
 
+/*!
+ * \brief Whether a pass config value can be structurally hashed into the key of a cache. Other
+ *  values, such as the passes of "tir.add_lower_pass", disable the caches keyed on the config.
+ *
+ * \param value The config value, or a map of config values.
+ *
+ * \return Whether the value can be hashed.
+ */
+TVM_DLL bool IsHashableConfigValue(const ObjectRef& value);
+
+/*!
+ * \brief Memoization of the results of a function-level pass.
+ *
+ *  When the "ir.incremental_passes" config is set, the function-level passes that define a
+ *  PassInfoNode::memo_key look each function up in a process-wide cache before transforming it,
+ *  so a rebuild after a small edit only reruns them on the functions that changed. Results are
+ *  keyed by the structural hash of the function, the pass name and memo key, the PassContext,
+ *  the current target, the attributes of the module and the signatures of its functions; the
+ *  structural hashes of the results are kept as well, so an unchanged function is not rehashed
+ *  by the next pass.
+ *
+ *  A pass may only define a memo key if its result depends on nothing but the function it
+ *  transforms, the above context and the key, which must hold every parameter the pass function
+ *  captures. Passes without a memo key, such as the passes written in Python, always run.
+ */
+class FunctionPassMemo {
+ public:
+  /*!
+   * \brief Prepare the memoization of a function-level pass.
+   *
+   * \param pass_info The pass being applied.
+   * \param mod The module the pass is applied on, before any of its functions are updated.
+   * \param pass_ctx The context the pass executes on.
+   */
+  TVM_DLL FunctionPassMemo(const PassInfo& pass_info, const IRModule& mod,
+                           const PassContext& pass_ctx);
+
+  /*! \brief Report the lookups to the instruments of the current pass. */
+  TVM_DLL ~FunctionPassMemo();
+
+  /*!
+   * \brief Apply the pass on a function, or reuse its result from an earlier application.
+   *
+   * \param func The function to transform.
+   * \param fpass Applies the pass on a function.
+   *
+   * \return The transformed function.
+   */
+  template <typename TFunc, typename FPass>
+  TFunc Apply(TFunc func, FPass fpass) const {
+    if (!enabled_) return fpass(std::move(func));
+    uint64_t func_hash;
+    ObjectRef result;
+    if (!Lookup(func, &func_hash, &result)) {
+      result = fpass(func);
+      Update(func_hash, func, result);
+    }
+    return Downcast<TFunc>(std::move(result));
+  }
+
+  /*! \brief Whether memoization is enabled for this application of the pass. */
+  bool enabled() const { return enabled_; }
+
+  /*! \brief Drop all the memoized results. */
+  TVM_DLL static void Clear();
+
+ private:
+  TVM_DLL bool Lookup(const BaseFunc& func, uint64_t* func_hash, ObjectRef* result) const;
+  TVM_DLL void Update(uint64_t func_hash, const BaseFunc& func, const ObjectRef& result) const;
+
+  /*! \brief Whether memoization is enabled. */
+  bool enabled_{false};
+  /*! \brief The hash of everything besides the function which the results depend on. */
+  uint64_t context_hash_{0};
+  /*!
+   * \brief The number of lookups, and of lookups that found a result. These are counted here
+   *  rather than reported as they happen, as the pass may run its functions on other threads.
+   */
+  mutable std::atomic<int> num_lookups_{0};
+  mutable std::atomic<int> num_hits_{0};
+};
+
+/*!
+ * \brief Run the per-function tasks of a function-level pass in parallel.
+ *
+ *  Each task runs in the scope of the PassContext and of the current target of the caller, as
+ *  these scopes are thread local. The tasks should only read the module the pass is applied on,
+ *  and write their results to separate slots, which the caller then applies in order.
+ *  If a task throws, the remaining tasks are skipped and the first error is rethrown as is.
+ *
+ * \param pass_ctx The context the pass executes on.
+ * \param num_tasks The number of tasks.
+ * \param num_threads The number of threads to use, or 0 to use all the cores. With a single
+ *        thread the tasks run in order on the calling thread.
+ * \param ftask Runs the task of the given index.
+ */
+TVM_DLL void ParallelForFunctions(const PassContext& pass_ctx, int num_tasks, int num_threads,
+                                  const std::function<void(int)>& ftask);
+
 /*
  * \brief Create a module pass.
  *
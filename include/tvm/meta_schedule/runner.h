@@ -23,6 +23,7 @@
 #include <tvm/meta_schedule/arg_info.h>
 #include <tvm/node/reflection.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/optional.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/object.h>
@@ -74,10 +75,13 @@ class RunnerResultNode : public runtime::Object {
   Optional<Array<FloatImm>> run_secs;
   /*! \brief The error message, if any. */
   Optional<String> error_msg;
+  /*! \brief The hardware performance counters of a run, if they are collected. */
+  Optional<Map<String, FloatImm>> perf_counters;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("run_secs", &run_secs);
     v->Visit("error_msg", &error_msg);
+    v->Visit("perf_counters", &perf_counters);
   }
 
   static constexpr const char* _type_key = "meta_schedule.RunnerResult";
@@ -94,8 +98,10 @@ class RunnerResult : public runtime::ObjectRef {
    * \brief Constructor
    * \brief The run time in seconds.
    * \brief The error message, if any.
+   * \brief The hardware performance counters of a run, if they are collected.
    */
-  TVM_DLL explicit RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg);
+  TVM_DLL explicit RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg,
+                                Optional<Map<String, FloatImm>> perf_counters = NullOpt);
   TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(RunnerResult, runtime::ObjectRef, RunnerResultNode);
 };
 
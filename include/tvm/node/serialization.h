@@ -47,5 +47,22 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief save the node as well as all the node it depends on in a compact binary format.
+ *  Strings are stored once in a table, and the NDArray data is stored raw and aligned
+ *  instead of base64-encoded, which makes it much smaller and faster to load than json.
+ *
+ * \return the binary representation of the node.
+ */
+TVM_DLL std::string SaveBinary(const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load tvm Node object from the binary format created by SaveBinary.
+ * \param blob The bytes to load from.
+ *
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(const std::string& blob);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
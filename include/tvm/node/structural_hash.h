@@ -26,6 +26,7 @@
 #include <tvm/node/functor.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/support/with.h>
 
 #include <cmath>
 #include <functional>
@@ -103,6 +104,51 @@ class StructuralHash : public BaseValueHash {
   TVM_DLL uint64_t operator()(const ObjectRef& key) const;
 };
 
+/*!
+ * \brief A scoped cache of structural hash values on the current thread.
+ *
+ *  While in scope, the hash handlers memoize the hash of each object they hash, as well as of
+ *  each subtree whose hash does not depend on its context, i.e. which contains neither graph
+ *  nodes nor variables, such as constants and types. Hashing the same or a partially shared IR
+ *  again then skips the parts that were hashed before. StructuralEqual also returns early when
+ *  the cached hashes of its operands differ.
+ *
+ *  The cache keeps a reference to each cached object, so the object is no longer unique and
+ *  CopyOnWrite copies it instead of modifying it in place. IR modified through CopyOnWrite is
+ *  thus a new object. IRModule, whose Add and Update modify it in place, is never cached, nor
+ *  is any object containing one. Other in-place modifications, such as writing into the
+ *  NDArray of a constant, are not detected: the IR hashed in the scope must not be modified
+ *  this way until the scope exits. Scopes can be nested, the cache is cleared when the
+ *  outermost scope exits.
+ *
+ * \code
+ *
+ *  {
+ *    With<StructuralHashCache> scope;
+ *    // hashing is memoized here.
+ *  }
+ *
+ * \endcode
+ */
+class StructuralHashCache {
+ public:
+  /*!
+   * \brief Get the cached structural hash of an object, as computed by StructuralHash.
+   * \param object The object.
+   * \param hash_value The cached hash value.
+   * \return Whether the hash is cached, which is never the case when not in scope.
+   */
+  TVM_DLL static bool Lookup(const ObjectRef& object, uint64_t* hash_value);
+
+ private:
+  friend class With<StructuralHashCache>;
+  StructuralHashCache() = default;
+  /*! \brief Enter the scope, the first scope on the thread creates the cache. */
+  TVM_DLL void EnterWithScope();
+  /*! \brief Exit the scope, the last scope on the thread clears the cache. */
+  TVM_DLL void ExitWithScope();
+};
+
 /*!
  * \brief A Reducer class to reduce the structural hash value.
  *
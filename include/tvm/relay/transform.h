@@ -79,12 +79,15 @@ using FTVMRelayToTIR = tvm::transform::Pass;
  * \param opt_level The optimization level of the function pass.
  * \param name The name of the function pass.
  * \param required The list of the passes that the function pass is dependent on.
+ * \param memo_key The parameters of the pass if its results can be memoized, see
+ *        transform::FunctionPassMemo.
  *
  * \return The created function pass.
  */
 TVM_DLL Pass CreateFunctionPass(
     const runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable = false);
+    int opt_level, String name, tvm::Array<String> required, bool traceable = false,
+    Optional<Array<ObjectRef>> memo_key = NullOpt);
 
 /*! \brief Remove let-bound expressions which do not effect the program result.
  *
@@ -68,6 +68,27 @@ struct NDArrayCacheMetadata {
                                 std::string* raw_data_buffer,    //
                                 Optional<NDArray>* staging_buffer = nullptr) const;
 
+    /*!
+     * \brief Load the parameters of a FileRecord from the already read content of its shard.
+     * \param device The device to load the parameters onto.
+     * \param raw_data The content of the shard file.
+     * \param staging_buffer The staging buffer, see ParamRecord::Load.
+     */
+    TVM_DLL Array<NDArray> LoadFromBytes(Device device, const std::string& raw_data,
+                                         Optional<NDArray>* staging_buffer = nullptr) const;
+
+    /*!
+     * \brief Load a FileRecord by memory-mapping the shard file.
+     * \details The parameters that are stored in raw format with a matching size and an
+     * aligned offset are returned as NDArrays that view the mapped pages directly when loading
+     * onto CPU. Such NDArrays are paged in lazily and share the page cache across processes.
+     * The other parameters are copied out of the mapping as in Load.
+     * \note The mapping is read-only, so the zero-copy parameters must not be written to.
+     */
+    TVM_DLL Array<NDArray> LoadMapped(Device device,                   //
+                                      const std::string& path_prefix,  //
+                                      Optional<NDArray>* staging_buffer = nullptr) const;
+
     /*! \brief Relative path to the bin file */
     std::string data_path;
     /*! \brief Format of the file */
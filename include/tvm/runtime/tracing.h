@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file include/tvm/runtime/tracing.h
+ * \brief Low overhead tracing of the runtime, exported as a Chrome trace.
+ *
+ *  Unlike the profiler, which aggregates the calls into a report, tracing keeps every event,
+ *  so that the timeline of a slow run can be inspected in chrome://tracing or Perfetto.
+ *  Each thread records its events into its own buffer without locking, and recording costs
+ *  a single flag check while tracing is stopped.
+ */
+#ifndef TVM_RUNTIME_TRACING_H_
+#define TVM_RUNTIME_TRACING_H_
+
+#include <tvm/runtime/c_runtime_api.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief The maximum length of the name of a trace event, longer names are truncated. */
+constexpr size_t kMaxTraceNameLength = 64;
+
+/*! \return Whether the trace events are being recorded. */
+TVM_DLL bool TracingEnabled();
+
+/*!
+ * \brief Discard the recorded events and start recording.
+ * \param events_per_thread The number of events each thread can record, after which the
+ *  events of the thread are dropped.
+ */
+TVM_DLL void StartTracing(int64_t events_per_thread = 1 << 16);
+
+/*! \brief Stop recording, keeping the recorded events for export. */
+TVM_DLL void StopTracing();
+
+/*!
+ * \brief Export the recorded events in the Chrome trace event format.
+ * \return The JSON string, which can be loaded by chrome://tracing or Perfetto.
+ */
+TVM_DLL std::string ExportChromeTrace();
+
+/*!
+ * \brief Name the current thread in the exported trace.
+ * \param name The name of the thread.
+ */
+TVM_DLL void SetTraceThreadName(const std::string& name);
+
+/*! \return The monotonic time used by the trace events, in nanoseconds. */
+TVM_DLL int64_t TraceClockNs();
+
+/*!
+ * \brief Record an event of the current thread.
+ * \param category The category of the event, which must be a string literal.
+ * \param name The name of the event, which is copied.
+ * \param begin_ns The start time of the event from TraceClockNs.
+ * \param end_ns The end time of the event from TraceClockNs.
+ */
+TVM_DLL void RecordTraceEvent(const char* category, const char* name, int64_t begin_ns,
+                              int64_t end_ns);
+
+/*!
+ * \brief Record the lifetime of the scope as a trace event, if tracing is enabled when the
+ *  scope is entered.
+ */
+class TraceScope {
+ public:
+  /*!
+   * \brief Enter a traced scope.
+   * \param category The category of the event, which must be a string literal.
+   * \param name The name of the event.
+   */
+  TraceScope(const char* category, const char* name) {
+    if (TracingEnabled()) Enter(category, name, std::strlen(name));
+  }
+  /*!
+   * \brief Enter a traced scope.
+   * \param category The category of the event, which must be a string literal.
+   * \param name The name of the event.
+   */
+  TraceScope(const char* category, const std::string& name) {
+    if (TracingEnabled()) Enter(category, name.data(), name.size());
+  }
+  /*! \brief Exit the traced scope and record its event. */
+  ~TraceScope() {
+    if (category_ != nullptr) RecordTraceEvent(category_, name_, begin_ns_, TraceClockNs());
+  }
+  TraceScope(const TraceScope& other) = delete;
+  TraceScope(TraceScope&& other) = delete;
+  TraceScope& operator=(const TraceScope& other) = delete;
+  TraceScope& operator=(TraceScope&& other) = delete;
+
+ private:
+  void Enter(const char* category, const char* name, size_t length) {
+    length = std::min(length, kMaxTraceNameLength - 1);
+    std::memcpy(name_, name, length);
+    name_[length] = '\0';
+    category_ = category;
+    begin_ns_ = TraceClockNs();
+  }
+
+  /*! \brief The category of the event, or nullptr if the scope is not traced. */
+  const char* category_ = nullptr;
+  /*! \brief The start time of the event. */
+  int64_t begin_ns_ = 0;
+  /*! \brief The name of the event, which is copied as the caller may release it. */
+  char name_[kMaxTraceNameLength];
+};
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_TRACING_H_
@@ -26,7 +26,9 @@
 
 #include <tvm/runtime/c_runtime_api.h>
 
+#include <algorithm>
 #include <functional>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -63,6 +65,8 @@ TVM_DLL std::vector<std::vector<int>> rr_partitioner(int begin, int end, int ste
  * partitioner by default.
  * \note 1. Currently do not support nested parallel_for; 2. The order of execution in each thread
  * is not guaranteed, the for loop task should be thread independent and thread safe.
+ * 3. The partitions run on a thread pool that persists across calls, the calling thread runs
+ * partitions as well. An error in any task cancels the partitions not yet started.
  */
 TVM_DLL void parallel_for(int begin, int end, const std::function<void(int)>& f, int step = 1,
                           const PartitionerFuncType partitioner = rr_partitioner);
@@ -83,10 +87,65 @@ TVM_DLL void parallel_for(int begin, int end, const std::function<void(int)>& f,
  * \param num_threads The number of threads to be used.
  * \param f The task function to be executed. Takes the thread index and the task index as
  * input with no output.
- * \note `step` support is left for future work.
+ * \note 1. `step` support is left for future work; 2. The calling thread runs as thread 0, the
+ * other threads come from a thread pool that persists across calls, so there is no thread
+ * creation per call. Nested calls are allowed, a thread that is not available in time is simply
+ * not used; 3. An error in any task cancels the tasks not yet started, and is rethrown in the
+ * calling thread once all running tasks finish.
  */
 TVM_DLL void parallel_for_dynamic(int begin, int end, int num_threads,
                                   const std::function<void(int thread_id, int task_id)>& f);
+
+/*!
+ * \brief Run a functor on each index in parallel and collect the results in index order.
+ * The tasks are scheduled the same way as `parallel_for_dynamic`.
+ * \tparam T The result type, which should be default constructible.
+ * \param begin The start index of this parallel loop (inclusive).
+ * \param end The end index of this parallel loop (exclusive).
+ * \param num_threads The number of threads to be used.
+ * \param f The function to be executed. Takes the thread index and the task index as input and
+ * returns the result of the task.
+ * \return The results, where the i-th element is the result of the task `begin + i`.
+ */
+template <typename T>
+std::vector<T> parallel_map(int begin, int end, int num_threads,
+                            const std::function<T(int thread_id, int task_id)>& f) {
+  std::vector<T> results(end > begin ? end - begin : 0);
+  parallel_for_dynamic(begin, end, num_threads, [&](int thread_id, int task_id) {
+    results[task_id - begin] = f(thread_id, task_id);
+  });
+  return results;
+}
+
+/*!
+ * \brief Reduce the results of a functor over each index in parallel.
+ * Each thread reduces the tasks it runs into its own partial result, starting from `init`, and
+ * the partial results are then reduced in thread order. The tasks are scheduled the same way as
+ * `parallel_for_dynamic`, so the reduction should be associative and commutative.
+ * \tparam T The result type.
+ * \param begin The start index of this parallel loop (inclusive).
+ * \param end The end index of this parallel loop (exclusive).
+ * \param num_threads The number of threads to be used.
+ * \param init The identity of the reduction.
+ * \param f The function to be executed. Takes the task index as input and returns its result.
+ * \param reduce The reduction, combining two results into one.
+ * \return The reduction of the results of all tasks.
+ */
+template <typename T>
+T parallel_reduce(int begin, int end, int num_threads, const T& init,
+                  const std::function<T(int task_id)>& f,
+                  const std::function<T(const T&, const T&)>& reduce) {
+  std::vector<T> partials(std::max(num_threads, 1), init);
+  parallel_for_dynamic(begin, end, num_threads, [&](int thread_id, int task_id) {
+    partials[thread_id] = reduce(partials[thread_id], f(task_id));
+  });
+  T result = init;
+  for (const T& partial : partials) {
+    result = reduce(result, partial);
+  }
+  return result;
+}
+
 }  // namespace support
 }  // namespace tvm
 
@@ -76,6 +76,18 @@ runtime::Module DeserializeModuleFromBytes(std::string blob);
 std::string PackImportsToC(const runtime::Module& m, bool system_lib,
                            const std::string& c_symbol_prefix = "");
 
+/*!
+ * \brief Pack imported device library to a C file, like PackImportsToC, but write the
+ *  C source to the file as it is formatted instead of returning it as a string.
+ *
+ * \param m The host module with the imports.
+ * \param system_lib Whether expose as system library.
+ * \param file_name The name of the C file to write.
+ * \param c_symbol_prefix Optional symbol prefix of the blob symbol.
+ */
+void PackImportsToCFile(const runtime::Module& m, bool system_lib, const std::string& file_name,
+                        const std::string& c_symbol_prefix = "");
+
 /*!
  * \brief Pack imported device library to a LLVM module.
  *  Compile the LLVM module and link with the host library
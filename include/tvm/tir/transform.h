@@ -51,12 +51,15 @@ using tvm::transform::Sequential;
  * \param opt_level The optimization level of the function pass.
  * \param name The name of the function pass.
  * \param required The list of the passes that the function pass is dependent on.
+ * \param memo_key The parameters of the pass if its results can be memoized, see
+ *        transform::FunctionPassMemo.
  *
  * \return The created function pass.
  */
 TVM_DLL Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable = false);
+    int opt_level, String name, tvm::Array<String> required, bool traceable = false,
+    Optional<Array<ObjectRef>> memo_key = NullOpt);
 
 /*!
  * \brief Inject prefetch instructions into stmt.
@@ -21,6 +21,7 @@ import subprocess
 
 # pylint: disable=invalid-name
 import sys
+from concurrent.futures import ThreadPoolExecutor
 from typing import Dict
 
 from .._ffi.base import py_str
@@ -342,6 +343,11 @@ def _linux_compile(
             cmd += ["-shared", "-fPIC"]
             if sys.platform == "darwin":
                 cmd += ["-undefined", "dynamic_lookup"]
+            if not isinstance(objects, str):
+                # The directory of the compiled sources is kept until the link is done.
+                objects, _objects_dir = _compile_sources(
+                    objects, options, compile_cmd, cwd, ccache_env
+                )
         elif output.endswith(".obj"):
             cmd += ["-c"]
     else:
@@ -354,6 +360,57 @@ def _linux_compile(
         cmd += objects
     if options:
         cmd += options
+    _run_compile_cmd(cmd, cwd, ccache_env)
+
+
+def _compile_sources(objects, options, compile_cmd, cwd=None, ccache_env=None):
+    """Compile the C/C++ sources among objects to object files in parallel.
+
+    Returns the objects with the sources replaced by the object files, in the same
+    order, and the temporary directory holding the object files.
+    """
+    sources = [obj for obj in objects if obj.endswith((".c", ".cc", ".cpp", ".cxx"))]
+    num_workers = min(len(sources), os.cpu_count() or 1)
+    if num_workers <= 1:
+        return objects, None
+    temp = _utils.tempdir()
+    compiled = {}
+    for index, source in enumerate(sources):
+        compiled[source] = temp.relpath(f"{index}_{os.path.basename(source)}.o")
+    compile_options = _get_compile_options(options)
+    cmds = []
+    for source, obj in compiled.items():
+        cmds.append([compile_cmd, "-c", "-fPIC", "-o", obj, source] + compile_options)
+    with ThreadPoolExecutor(max_workers=num_workers) as pool:
+        for future in [pool.submit(_run_compile_cmd, cmd, cwd, ccache_env) for cmd in cmds]:
+            future.result()
+    return [compiled.get(obj, obj) for obj in objects], temp
+
+
+def _get_compile_options(options):
+    """Drop the link-only options, such as libraries and linker flags, which do not apply
+    when compiling a source to an object file."""
+    if isinstance(options, str):
+        options = [options]
+    link_prefixes = ("-l", "-L", "-Wl,", "-shared", "-static", "-rdynamic")
+    link_inputs = (".o", ".obj", ".a", ".so", ".dylib", ".lib")
+    compile_options = []
+    skip_next = False
+    for opt in options or []:
+        if skip_next:
+            skip_next = False
+            continue
+        if opt in ("-l", "-L", "-Xlinker"):
+            # The argument of the option is the next one.
+            skip_next = True
+            continue
+        if opt.startswith(link_prefixes) or opt.endswith(link_inputs):
+            continue
+        compile_options.append(opt)
+    return compile_options
+
+
+def _run_compile_cmd(cmd, cwd=None, ccache_env=None):
     env = None
     if ccache_env is not None:
         if shutil.which("ccache"):
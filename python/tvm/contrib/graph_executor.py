@@ -381,6 +381,20 @@ class GraphModule(object):
         """
         self._load_params(bytearray(params_bytes))
 
+    def map_params(self, path):
+        """Load parameters by memory mapping a parameter file.
+
+        Parameters of a file saved with ``save_param_dict_to_file(params, path, indexed=True)``
+        are used in place from the mapping instead of being copied, so that executors mapping
+        the same file, or sharing parameters with one that does, share its pages.
+
+        Parameters
+        ----------
+        path : str
+            The path to the parameter file.
+        """
+        self.module["map_params"](path)
+
     def share_params(self, other, params_bytes):
         """Share parameters from pre-existing GraphExecutor instance.
 
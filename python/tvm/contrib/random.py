@@ -112,4 +112,18 @@ def normal(loc, scale, size):
     )
 
 
+def seed(value):
+    """Seed the random engine of the calling thread.
+
+    The kernels drawing from the distributions above then produce the same
+    values on each run, whatever the number of threads they run on.
+
+    Parameters
+    ----------
+    value : int
+        The seed.
+    """
+    tvm.get_global_func("tvm.contrib.random.seed")(int(value))
+
+
 tvm._ffi._init_api("tvm.contrib.random")
@@ -71,6 +71,10 @@ def _calculate_md5(filename):
     return hash_md5.hexdigest()
 
 
+# The byte alignment of each record inside a shard, matching the runtime allocation alignment.
+NDARRAY_CACHE_ALIGNMENT = 64
+
+
 class NDArrayCacheShardingManager:
     """Internal helper to shard ndarrays."""
 
@@ -136,13 +140,17 @@ class NDArrayCacheShardingManager:
 
         self.name_to_record[name] = (self.counter, rec)
 
-        if self.pending_nbytes + len(data) >= self.shard_cap_nbytes:
+        # Align each record so that the loader can view it in place when mmapped.
+        padding = -self.pending_nbytes % NDARRAY_CACHE_ALIGNMENT
+        if self.pending_nbytes + padding + len(data) >= self.shard_cap_nbytes:
             if len(data) * 2 >= self.shard_cap_nbytes:
                 # out of band data
                 rec["byteOffset"] = 0
                 self._commit_internal(data, [rec])
                 return
             self.commit()
+            padding = 0
+        self.curr_data += bytes(padding)
         rec["byteOffset"] = self.pending_nbytes
         self.curr_records.append(rec)
         self.curr_data += data
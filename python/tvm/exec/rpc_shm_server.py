@@ -0,0 +1,42 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Internal RPC server launched by tvm.rpc.connect_shared_memory."""
+import argparse
+
+from tvm.rpc import _ffi_api, server
+
+
+def main():
+    """Main server function"""
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--load-library", type=str, help="Additional library to load, separated by colon"
+    )
+    parser.add_argument("segment_fd", type=int, help="The inherited shared memory segment")
+    args = parser.parse_args()
+    load_library = args.load_library.split(":") if args.load_library else []
+    # Keep the work directory alive while serving.
+    _temp = server._server_env(load_library)  # pylint: disable=protected-access
+    _ffi_api.SharedMemoryServerLoop(args.segment_fd)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (KeyboardInterrupt, IOError):
+        pass
@@ -28,10 +28,13 @@ from .base import (
     Span,
     SequentialSpan,
     assert_structural_equal,
+    load_binary,
     load_json,
+    save_binary,
     save_json,
     structural_equal,
     structural_hash,
+    structural_hash_cache,
 )
 from .container import Array, Map
 from .expr import BaseExpr, GlobalVar, PrimExpr, Range, RelayExpr
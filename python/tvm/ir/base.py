@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """Common base structures."""
+import contextlib
+
 import tvm._ffi
 import tvm.error
 from tvm._ffi import get_global_func, register_object
@@ -146,6 +148,42 @@ def save_json(node) -> str:
     return _ffi_node_api.SaveJSON(node)
 
 
+def load_binary(blob) -> Object:
+    """Load tvm object from the binary format created by save_binary.
+
+    Parameters
+    ----------
+    blob : bytes or bytearray
+        The serialized bytes.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return _ffi_node_api.LoadBinary(bytearray(blob))
+
+
+def save_binary(node) -> bytearray:
+    """Save tvm object in a compact binary format.
+
+    Compared to save_json, strings are deduplicated and NDArray data is
+    stored raw instead of base64-encoded, so the result is smaller and
+    faster to load. The format is not meant to be stable across versions.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    blob : bytearray
+        Saved bytes.
+    """
+    return _ffi_node_api.SaveBinary(node)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
@@ -298,6 +336,31 @@ def structural_hash(node, map_free_vars=False):
     return _ffi_node_api.StructuralHash(node, map_free_vars)  # type: ignore # pylint: disable=no-member
 
 
+@contextlib.contextmanager
+def structural_hash_cache():
+    """Memoize structural hash values within the scope, on the current thread.
+
+    The hash of each hashed object, and of each of its subtrees that contain neither
+    graph nodes nor variables, is kept and reused. The cache keeps the objects alive,
+    so that copy-on-write makes a copy instead of modifying them. IRModules, which are
+    modified in place, are not cached. Other in-place modifications, such as writing
+    into the NDArray of a constant, must not happen within the scope.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        with tvm.ir.structural_hash_cache():
+            # repeated hashing of the same IR is memoized
+            tvm.ir.structural_hash(func)
+    """
+    _ffi_node_api.EnterStructuralHashCache()  # type: ignore # pylint: disable=no-member
+    try:
+        yield
+    finally:
+        _ffi_node_api.ExitStructuralHashCache()  # type: ignore # pylint: disable=no-member
+
+
 def deprecated(
     method_name: str,
     new_method_name: str,
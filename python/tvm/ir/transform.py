@@ -447,6 +447,17 @@ def PrintIR(header="", show_meta_data=False):
     return _ffi_transform_api.PrintIR(header, show_meta_data)
 
 
+def clear_function_pass_memo():
+    """Drop the results of function-level passes memoized under the
+    "ir.incremental_passes" config option.
+
+    With this option, each function-level pass reuses its result for a
+    function it was applied on before, in the same context, instead of
+    transforming the function again.
+    """
+    _ffi_transform_api.ClearFunctionPassMemo()
+
+
 def ApplyPassToFunction(
     transform: Pass,
     func_name_regex: str,
@@ -41,6 +41,10 @@ class EvaluatorConfig(NamedTuple):
         increase the number of runs to the given time (in ms) to reduce the measurement error.
     enable_cpu_cache_flush: bool
         Whether to flush the cache on CPU.
+    perf_counters: bool
+        Whether to collect the hardware performance counters of each candidate on CPU, e.g. its
+        cycles, instructions and cache misses, which tell whether it is compute or memory bound.
+        It requires TVM to be built on Linux with the profiler.
 
     Note
     ----
@@ -52,6 +56,7 @@ class EvaluatorConfig(NamedTuple):
     repeat: int = 1
     min_repeat_ms: int = 100
     enable_cpu_cache_flush: bool = False
+    perf_counters: bool = False
 
     @staticmethod
     def _normalized(config: Optional["EvaluatorConfig"]) -> "EvaluatorConfig":
@@ -62,6 +67,7 @@ class EvaluatorConfig(NamedTuple):
             repeat=config.repeat,
             min_repeat_ms=config.min_repeat_ms,
             enable_cpu_cache_flush=config.enable_cpu_cache_flush,
+            perf_counters=config.perf_counters,
         )
         return config
 
@@ -17,7 +17,7 @@
 """Local Runner"""
 import logging
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 import subprocess
 
 import tvm
@@ -33,6 +33,7 @@ from .utils import (
     T_ARG_INFO_JSON_OBJ_LIST,
     T_ARGUMENT_LIST,
     alloc_argument_common,
+    collect_perf_counters,
     run_evaluator_common,
 )
 
@@ -72,6 +73,8 @@ class LocalRunnerFuture(PyRunnerFuture):
         The optional result as a list of float.
     error_message: Optional[str]
         The optional error message.
+    perf_counters: Optional[Dict[str, float]]
+        The optional hardware performance counters.
 
     Note
     ----
@@ -81,9 +84,13 @@ class LocalRunnerFuture(PyRunnerFuture):
 
     res: Optional[List[float]]
     error_message: Optional[str]
+    perf_counters: Optional[Dict[str, float]]
 
     def __init__(
-        self, res: Optional[List[float]] = None, error_message: Optional[str] = None
+        self,
+        res: Optional[List[float]] = None,
+        error_message: Optional[str] = None,
+        perf_counters: Optional[Dict[str, float]] = None,
     ) -> None:
         """Constructor
 
@@ -93,11 +100,14 @@ class LocalRunnerFuture(PyRunnerFuture):
             The result of this LocalRunnerFuture
         error_message: Optional[str]
             The stringfied error message of any exception during execution
+        perf_counters: Optional[Dict[str, float]]
+            The hardware performance counters of a run, if they are collected
 
         """
         super().__init__()
         self.res = res
         self.error_message = error_message
+        self.perf_counters = perf_counters
 
         # sanity check upon the creation of LocalRunnerFuture object
         if (res is None and error_message is None) or (
@@ -112,7 +122,7 @@ class LocalRunnerFuture(PyRunnerFuture):
         return True
 
     def result(self) -> RunnerResult:
-        return RunnerResult(self.res, self.error_message)
+        return RunnerResult(self.res, self.error_message, self.perf_counters)
 
 
 def _worker_func(
@@ -124,7 +134,7 @@ def _worker_func(
     artifact_path: str,
     device_type: str,
     args_info: T_ARG_INFO_JSON_OBJ_LIST,
-) -> List[float]:
+) -> Tuple[List[float], Optional[Dict[str, float]]]:
     f_alloc_argument: T_ALLOC_ARGUMENT = get_global_func_with_default_on_worker(
         _f_alloc_argument, default_alloc_argument
     )
@@ -162,7 +172,12 @@ def _worker_func(
                 evaluator_config,
                 repeated_args,
             )
-    return costs
+        # Step 4: Collect the performance counters
+        perf_counters: Optional[Dict[str, float]] = None
+        if evaluator_config.perf_counters and repeated_args:
+            with Profiler.timeit("LocalRunner/perf_counters"):
+                perf_counters = collect_perf_counters(None, rt_mod, device, repeated_args[0])
+    return costs, perf_counters
 
 
 @derived_object
@@ -301,8 +316,9 @@ class LocalRunner(PyRunner):
                 str(runner_input.device_type),
                 tuple(arg_info.as_json() for arg_info in runner_input.args_info),
             )
+            perf_counters: Optional[Dict[str, float]] = None
             try:
-                result: List[float] = future.result()
+                result, perf_counters = future.result()
                 error_message: str = None
             except TimeoutError:
                 result = None
@@ -310,7 +326,9 @@ class LocalRunner(PyRunner):
             except Exception as exception:  # pylint: disable=broad-except
                 result = None
                 error_message = "LocalRunner: An exception occurred\n" + str(exception)
-            local_future = LocalRunnerFuture(res=result, error_message=error_message)
+            local_future = LocalRunnerFuture(
+                res=result, error_message=error_message, perf_counters=perf_counters
+            )
             results.append(local_future)  # type: ignore
         return results
 
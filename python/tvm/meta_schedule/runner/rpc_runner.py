@@ -18,7 +18,7 @@
 import concurrent.futures
 import os.path as osp
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 
 from tvm.contrib.popen_pool import PopenPoolExecutor
 from tvm.rpc import RPCSession
@@ -37,6 +37,7 @@ from .utils import (
     T_ARG_INFO_JSON_OBJ_LIST,
     T_ARGUMENT_LIST,
     alloc_argument_common,
+    collect_perf_counters,
     run_evaluator_common,
 )
 
@@ -117,7 +118,7 @@ class RPCRunnerFuture(PyRunnerFuture):
 
     def result(self) -> RunnerResult:
         try:
-            run_secs: List[float] = self.future.result()
+            run_secs, perf_counters = self.future.result()
         except TimeoutError:
             return RunnerResult(
                 None,
@@ -128,7 +129,7 @@ class RPCRunnerFuture(PyRunnerFuture):
                 None,
                 error_msg="RPCRunner: An exception occurred\n" + str(exception),
             )
-        return RunnerResult(run_secs, None)
+        return RunnerResult(run_secs, None, perf_counters)
 
 
 @derived_object
@@ -352,7 +353,7 @@ def _worker_func(
     artifact_path: str,
     device_type: str,
     args_info: T_ARG_INFO_JSON_OBJ_LIST,
-) -> List[float]:
+) -> Tuple[List[float], Optional[Dict[str, float]]]:
     # Step 0. Get the registered functions
     f_create_session: T_CREATE_SESSION = get_global_func_with_default_on_worker(
         _f_create_session, default_create_session
@@ -407,7 +408,12 @@ def _worker_func(
                 evaluator_config,
                 repeated_args,
             )
-    return costs
+        # Step 5: Collect the performance counters
+        perf_counters: Optional[Dict[str, float]] = None
+        if evaluator_config.perf_counters and repeated_args:
+            with Profiler.timeit("RPCRunner/perf_counters"):
+                perf_counters = collect_perf_counters(session, rt_mod, device, repeated_args[0])
+    return costs, perf_counters
 
 
 def default_create_session(rpc_config: RPCConfig) -> RPCSession:
@@ -15,7 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Runners"""
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Union
 
 # isort: off
 from typing_extensions import Literal
@@ -24,6 +24,7 @@ from typing_extensions import Literal
 
 from tvm._ffi import register_object
 from tvm.runtime import Object
+from tvm.tir import FloatImm
 
 from .. import _ffi_api
 from ..arg_info import ArgInfo
@@ -82,15 +83,19 @@ class RunnerResult(Object):
         The run time in seconds.
     error_msg : Optional[str]
         The error message, if any.
+    perf_counters : Optional[Dict[str, float]]
+        The hardware performance counters of a run, if they are collected.
     """
 
     run_secs: Optional[List[float]]
     error_msg: Optional[str]
+    perf_counters: Optional[Dict[str, float]]
 
     def __init__(
         self,
         run_secs: Optional[List[float]],
         error_msg: Optional[str],
+        perf_counters: Optional[Dict[str, float]] = None,
     ) -> None:
         """Constructor
 
@@ -100,11 +105,19 @@ class RunnerResult(Object):
             The run time in seconds.
         error_msg : Optional[str]
             The error message, if any.
+        perf_counters : Optional[Dict[str, float]]
+            The hardware performance counters of a run, if they are collected.
         """
+        if perf_counters is not None:
+            # The counts exceed the precision of float32, which plain floats are converted to.
+            perf_counters = {
+                name: FloatImm("float64", value) for name, value in perf_counters.items()
+            }
         self.__init_handle_by_constructor__(
             _ffi_api.RunnerResult,  # type: ignore # pylint: disable=no-member
             run_secs,
             error_msg,
+            perf_counters,
         )
 
 
@@ -16,11 +16,18 @@
 # under the License.
 """Runner utility functions"""
 import itertools
-from typing import Any, Callable, Dict, List
+import json
+from typing import Any, Callable, Dict, List, Optional
 
+from ..._ffi import get_global_func
+from ...rpc import RPCSession
+from ...rpc.base import RPC_SESS_MASK
 from ...runtime import Device, Module, ndarray
+from ..logging import get_logger
 from .config import EvaluatorConfig
 
+logger = get_logger(__name__)  # pylint: disable=invalid-name
+
 T_ARG_INFO_JSON_OBJ = List[Any]  # pylint: disable=invalid-name
 T_ARG_INFO_JSON_OBJ_LIST = List[T_ARG_INFO_JSON_OBJ]  # pylint: disable=invalid-name
 T_ARGUMENT = Any  # pylint: disable=invalid-name
@@ -118,3 +125,46 @@ def run_evaluator_common(
         repeated_costs.append(profile_result.results)
     costs = [float(cost) for cost in itertools.chain.from_iterable(repeated_costs)]
     return costs
+
+
+def collect_perf_counters(
+    session: Optional[RPCSession],
+    rt_mod: Module,
+    device: Device,
+    args: T_ARGUMENT_LIST,
+) -> Optional[Dict[str, float]]:
+    """Collect the hardware performance counters of a run of the candidate on CPU
+
+    Parameters
+    ----------
+    session: Optional[RPCSession]
+        The RPC session the candidate runs on, or None if it runs locally
+    rt_mod: Module
+        The runtime module
+    device: Device
+        The device to run the candidate
+    args: T_ARGUMENT_LIST
+        The arguments of the run
+
+    Returns
+    -------
+    perf_counters: Optional[Dict[str, float]]
+        The counters, e.g. cycles, instructions, cache-misses, branch-misses and IPC, or None if
+        they cannot be collected
+    """
+    if device.device_type % RPC_SESS_MASK != Device.kDLCPU:
+        logger.warning("Performance counters are only collected on CPU")
+        return None
+    name = "runtime.profiling.ProfileFunctionPerfEvents"
+    if session is None:
+        f_profile = get_global_func(name, allow_missing=True)
+    else:
+        try:
+            f_profile = session.get_function(name)
+        except AttributeError:
+            f_profile = None
+    if f_profile is None:
+        logger.warning("Performance counters require TVM to be built on Linux with the profiler")
+        return None
+    profile = f_profile(rt_mod, rt_mod.entry_name, device, 1)
+    return {counter: float(value) for counter, value in json.loads(profile(*args)).items()}
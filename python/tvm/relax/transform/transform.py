@@ -531,6 +531,12 @@ def StaticPlanBlockMemory() -> tvm.ir.transform.Pass:
     signature will have upper bound 1024. And we will use 1024 as its value
     during memory planning.
 
+    When the PassContext config :code:`"relax.memory_plan.use_arena"` is set
+    to True, the planned storages with constant (upper-bounded) sizes of each
+    function are laid out at compile-time offsets inside a single arena per
+    device, so that the function performs one storage allocation per
+    invocation and carves its tensors out of the arena.
+
     Returns
     -------
     ret : tvm.ir.transform.Pass
@@ -280,6 +280,16 @@ def get_shape(shape):
     return ret
 
 
+@tvm._ffi.register_func("relay.backend.is_autotvm_dispatch_enabled")
+def is_autotvm_dispatch_enabled():
+    """Whether the lowering depends on AutoTVM, either by applying tuning records or by
+    extracting tuning tasks."""
+    env = autotvm.task.TaskExtractEnv.current
+    if env is not None and env.tracing:
+        return True
+    return not isinstance(autotvm.DispatchContext.current, autotvm.FallbackContext)
+
+
 @tvm._ffi.register_func("relay.backend.lower_call")
 def lower_call(call, inputs, target, otype=None):
     """Lower the call expression to op implementation and tensor outputs."""
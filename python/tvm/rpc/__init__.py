@@ -31,6 +31,6 @@ full remote code execution capabilities to anyone who can access this API.
 """
 
 from .server import Server
-from .client import connect, connect_tracker
+from .client import connect, connect_tracker, connect_shared_memory
 from .client import RPCSession, LocalSession, PopenSession, TrackerSession
 from .minrpc import with_minrpc
@@ -23,6 +23,7 @@ import os
 import socket
 import stat
 import struct
+import sys
 import time
 
 import tvm._ffi
@@ -95,6 +96,51 @@ class RPCSession(object):
         dev._rpc_sess = self
         return dev
 
+    def set_bulk_transfer_config(
+        self, chunk_bytes=4 << 20, max_outstanding_chunks=4, compression=False
+    ):
+        """Set how the tensors are copied to and from the remote.
+
+        The copies are split into chunks, and multiple chunks are kept in flight
+        so that the latency of the link is hidden.
+
+        Parameters
+        ----------
+        chunk_bytes : int
+            The maximum number of bytes in each chunk.
+
+        max_outstanding_chunks : int
+            The maximum number of chunks sent before waiting for their acknowledgement.
+
+        compression : bool
+            Whether to compress the chunks with LZ4. It only takes effect when the
+            remote supports it, and a chunk is sent as is when it does not compress.
+        """
+        _ffi_api.SessSetBulkTransferConfig(
+            self._sess, chunk_bytes, max_outstanding_chunks, compression
+        )
+
+    def transfer_stats(self):
+        """Get the counters of the tensor copies through the session.
+
+        Returns
+        -------
+        stats : Dict[str, int]
+            The number of tensor bytes copied to and from the remote, the number of bytes
+            sent over the link after compression, the number of chunks and the total time
+            of the copies in microseconds.
+        """
+        keys = [
+            "bytes_to_remote",
+            "bytes_from_remote",
+            "wire_bytes_to_remote",
+            "wire_bytes_from_remote",
+            "num_chunks",
+            "num_compressed_chunks",
+            "transfer_time_us",
+        ]
+        return dict(zip(keys, [int(x) for x in _ffi_api.SessTransferStats(self._sess)]))
+
     def upload(self, data, target=None):
         """Upload file to remote runtime temp folder
 
@@ -561,6 +607,35 @@ def connect(
     return RPCSession(sess)
 
 
+def connect_shared_memory(ring_bytes=16 << 20, load_library=None):
+    """Start a RPC server on the same host, connected through shared memory.
+
+    The data is exchanged in a pair of ring buffers in a shared memory segment,
+    which avoids the copies through the kernel made by the socket and pipe sessions.
+
+    Parameters
+    ----------
+    ring_bytes : int, optional
+        The capacity of the ring buffer of each direction.
+
+    load_library : List[str], optional
+        Additional libraries to be loaded by the server.
+
+    Returns
+    -------
+    sess : RPCSession
+        The connected session.
+    """
+    cmd = [sys.executable, "-m", "tvm.exec.rpc_shm_server"]
+    if load_library:
+        cmd += ["--load-library", ":".join(load_library)]
+    try:
+        sess = _ffi_api.CreateSharedMemoryClient(ring_bytes, *cmd)
+    except AttributeError:
+        raise RuntimeError("Shared memory RPC is only supported on Linux with USE_RPC=1")
+    return RPCSession(sess)
+
+
 def connect_tracker(url, port):
     """Connect to a RPC tracker
 
@@ -319,13 +319,15 @@ class Session(Object):
             - nccl
             - rccl
             - mpi
+            - cpu, which runs the collectives in shared memory on the CPUs of one host
 
         *device_ids : int
             The device IDs to be used by the underlying communication library.
         """
-        assert ccl in ("nccl", "rccl"), f"Unsupported CCL backend: {ccl}"
+        assert ccl in ("nccl", "rccl", "cpu"), f"Unsupported CCL backend: {ccl}"
         _ffi_api.SessionInitCCL(self, ccl, ShapeTuple(device_ids))  # type: ignore # pylint: disable=no-member
-        self._clear_ipc_memory_pool()
+        if ccl != "cpu":
+            self._clear_ipc_memory_pool()
 
     def broadcast(
         self, src: Union[np.ndarray, NDArray], dst: Optional[DRef] = None, in_group: bool = True
@@ -591,6 +591,8 @@ class Module(object):
                     global_object_format = object_format = "o"
 
             path_obj = os.path.join(workspace_dir, f"lib{index}.{object_format}")
+            # The modules are saved one at a time, as the LLVM code generation shares the
+            # global state of LLVM. The compilation of the saved sources runs in parallel.
             module.save(path_obj)
             files.append(path_obj)
             if module.type_key == "llvm":
@@ -631,8 +633,7 @@ class Module(object):
                 files.append(path_obj)
             else:
                 path_cc = os.path.join(workspace_dir, f"{pack_lib_prefix}devc.c")
-                with open(path_cc, "w") as f:
-                    f.write(_ffi_api.ModulePackImportsToC(self, is_system_lib, pack_lib_prefix))
+                _ffi_api.ModulePackImportsToCFile(self, is_system_lib, path_cc, pack_lib_prefix)
                 files.append(path_cc)
 
         # The imports could contain a c module but the object format could be tar
@@ -62,7 +62,7 @@ def save_param_dict(params):
     return _ffi_api.SaveParams(_to_ndarray(params))
 
 
-def save_param_dict_to_file(params, path):
+def save_param_dict_to_file(params, path, indexed=False):
     """Save parameter dictionary to file.
 
     Parameters
@@ -72,7 +72,14 @@ def save_param_dict_to_file(params, path):
 
     path: str
         The path to the parameter file.
+
+    indexed: bool
+        Whether to save the parameters in the indexed format, whose data is
+        aligned so that the file can be memory mapped by load_param_dict_from_file
+        or GraphModule.map_params.
     """
+    if indexed:
+        return _ffi_api.SaveIndexedParamsToFile(_to_ndarray(params), path)
     return _ffi_api.SaveParamsToFile(_to_ndarray(params), path)
 
 
@@ -94,7 +101,7 @@ def load_param_dict(param_bytes):
     return _ffi_api.LoadParams(param_bytes)
 
 
-def load_param_dict_from_file(path):
+def load_param_dict_from_file(path, mmap=False):
     """Load parameter dictionary from file.
 
     Parameters
@@ -102,9 +109,16 @@ def load_param_dict_from_file(path):
     path: str
         The path to the parameter file to load from.
 
+    mmap: bool
+        Whether to memory map the file instead of reading it. The parameters
+        of a file in the indexed format then share the pages of the file
+        and must not be written to.
+
     Returns
     -------
     params : dict of str to NDArray
         The parameter dictionary.
     """
+    if mmap:
+        return _ffi_api.LoadParamsFromMappedFile(path)
     return _ffi_api.LoadParamsFromFile(path)
@@ -270,6 +270,46 @@ def profile_function(mod, dev, collectors, func_name=None, warmup_iters=10):
     )
 
 
+def start_tracing(events_per_thread: int = 1 << 16):
+    """Discard the recorded trace events and start recording.
+
+    Unlike the profiler, tracing keeps every event, e.g. each operator run by the graph executor
+    or the Relax VM, each thread pool task and each Disco action, so that the timeline of a run
+    can be inspected with `export_chrome_trace`.
+
+    Parameters
+    ----------
+    events_per_thread : int
+        The number of events each thread can record, after which its events are dropped.
+    """
+    _ffi_api.StartTracing(events_per_thread)
+
+
+def stop_tracing():
+    """Stop recording trace events, keeping the recorded events for export."""
+    _ffi_api.StopTracing()
+
+
+def export_chrome_trace(path: Optional[str] = None) -> str:
+    """Export the recorded trace events in the Chrome trace event format.
+
+    Parameters
+    ----------
+    path : Optional[str]
+        The file to write the trace to, which can be opened in chrome://tracing or Perfetto.
+
+    Returns
+    -------
+    trace : str
+        The trace in JSON.
+    """
+    trace = _ffi_api.ExportChromeTrace()
+    if path is not None:
+        with open(path, "w") as f:
+            f.write(trace)
+    return trace
+
+
 # We only enable this class when TVM is build with PAPI support
 if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is not None:
 
@@ -292,3 +332,29 @@ if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=T
             for dev, names in metric_names.items():
                 wrapped[DeviceWrapper(dev)] = names
             self.__init_handle_by_constructor__(_ffi_api.PAPIMetricCollector, wrapped)
+
+
+# The perf_event collector is only built on Linux
+if (
+    _ffi.get_global_func("runtime.profiling.PerfEventMetricCollector", allow_missing=True)
+    is not None
+):
+
+    @_ffi.register_object("runtime.profiling.PerfEventMetricCollector")
+    class PerfEventMetricCollector(MetricCollector):
+        """Collects the hardware performance counters of the CPU through the Linux
+        `perf_event_open` system call, without any extra library.
+        """
+
+        def __init__(self, metrics: Optional[Sequence[str]] = None):
+            """
+            Parameters
+            ----------
+            metrics : Optional[Sequence[str]]
+                The counters to collect, named as in the `perf` tool, e.g. "cycles",
+                "instructions", "cache-misses", "branch-misses", "LLC-load-misses" or
+                "page-faults". Defaults to cycles, instructions, cache misses and branch
+                misses. "IPC" is reported as well when both cycles and instructions are.
+            """
+            metrics = [] if metrics is None else list(metrics)
+            self.__init_handle_by_constructor__(_ffi_api.PerfEventMetricCollector, metrics)
@@ -41,6 +41,7 @@
 #include <cassert>
 #include <cmath>
 #include <numeric>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -1428,11 +1429,13 @@ void GetPerStoreFeaturesFromStates(const Array<State>& states, const SearchTask&
 
   std::atomic<int> error_ct(0);
 
-  support::parallel_for(skip_first_n_feature_extraction, states.size(),
-                        [&task, &states, &max_n_bufs, &features, &error_ct](int i) {
-                          GetPerStoreFeaturesWorkerFunc(task, states[i], max_n_bufs,
-                                                        &(*features)[i], &error_ct);
-                        });
+  // The cost of feature extraction varies a lot between states, so tasks are fetched dynamically.
+  support::parallel_for_dynamic(skip_first_n_feature_extraction, states.size(),
+                                std::thread::hardware_concurrency(),
+                                [&task, &states, &max_n_bufs, &features, &error_ct](int, int i) {
+                                  GetPerStoreFeaturesWorkerFunc(task, states[i], max_n_bufs,
+                                                                &(*features)[i], &error_ct);
+                                });
 }
 
 void GetPerStoreFeaturesFromStates(const Array<State>& states, const std::vector<SearchTask>& tasks,
@@ -1443,11 +1446,13 @@ void GetPerStoreFeaturesFromStates(const Array<State>& states, const std::vector
 
   std::atomic<int> error_ct(0);
 
-  support::parallel_for(skip_first_n_feature_extraction, states.size(),
-                        [&tasks, &states, &max_n_bufs, &features, &error_ct](int i) {
-                          GetPerStoreFeaturesWorkerFunc(tasks[i], states[i], max_n_bufs,
-                                                        &(*features)[i], &error_ct);
-                        });
+  // The cost of feature extraction varies a lot between states, so tasks are fetched dynamically.
+  support::parallel_for_dynamic(skip_first_n_feature_extraction, states.size(),
+                                std::thread::hardware_concurrency(),
+                                [&tasks, &states, &max_n_bufs, &features, &error_ct](int, int i) {
+                                  GetPerStoreFeaturesWorkerFunc(tasks[i], states[i], max_n_bufs,
+                                                                &(*features)[i], &error_ct);
+                                });
 }
 
 void GetPerStoreFeaturesFromFile(const std::string& filename, int max_lines, int max_n_bufs,
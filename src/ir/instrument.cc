@@ -216,6 +216,10 @@ struct PassProfile {
   Duration duration;
   /*! \brief PassProfiles for all sub-passes invoked during the execution of the pass. */
   std::vector<PassProfile> children;
+  /*! \brief The number of memoized function results looked up by the pass. */
+  size_t memo_lookups{0};
+  /*! \brief The number of those lookups that found a result. */
+  size_t memo_hits{0};
 
   explicit PassProfile(String name)
       : name(name), start(Clock::now()), end(Clock::now()), children() {}
@@ -263,6 +267,14 @@ PassProfile* PassProfile::Current() {
   }
 }
 
+void RecordFunctionPassMemoLookups(int num_lookups, int num_hits) {
+  PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
+  if (entry->profile_stack.empty()) return;
+  PassProfile* cur = entry->profile_stack.top();
+  cur->memo_lookups += num_lookups;
+  cur->memo_hits += num_hits;
+}
+
 String RenderPassProfiles() {
   PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
   CHECK(entry->profile_stack.empty()) << "cannot print pass profile while still in a pass!";
@@ -309,7 +321,11 @@ String RenderPassProfiles() {
     os << profile->name << ": ";
     os << std::setprecision(0);
     os << profile->duration.count() << "us [" << self_duration.count() << "us] ";
-    os << std::setprecision(2) << "(" << total_pct << "%; " << parent_pct << "%)\n";
+    os << std::setprecision(2) << "(" << total_pct << "%; " << parent_pct << "%)";
+    if (profile->memo_lookups > 0) {
+      os << " [memo hits: " << profile->memo_hits << "/" << profile->memo_lookups << "]";
+    }
+    os << "\n";
   }
 
   return os.str();
@@ -29,14 +29,23 @@
 #include <tvm/relax/tuning_api.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
+#include <tvm/target/target.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <iomanip>
+#include <list>
+#include <mutex>
 #include <stack>
+#include <thread>
 #include <unordered_set>
 
 #include "../runtime/object_internal.h"
 #include "../runtime/regex.h"
+#include "../support/utils.h"
 
 namespace tvm {
 namespace transform {
@@ -46,6 +55,7 @@ using tvm::runtime::TVMArgs;
 using tvm::runtime::TVMRetValue;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("testing.immutable_module", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("ir.incremental_passes", Bool);
 
 struct PassContextThreadLocalEntry {
   /*! \brief The default pass context. */
@@ -380,12 +390,13 @@ class ModulePass : public Pass {
 };
 
 PassInfo::PassInfo(int opt_level, String name, tvm::Array<runtime::String> required,
-                   bool traceable) {
+                   bool traceable, Optional<Array<ObjectRef>> memo_key) {
   auto pass_info = make_object<PassInfoNode>();
   pass_info->opt_level = opt_level;
   pass_info->name = std::move(name);
   pass_info->required = std::move(required);
   pass_info->traceable = std::move(traceable);
+  pass_info->memo_key = std::move(memo_key);
   data_ = std::move(pass_info);
 }
 
@@ -528,6 +539,250 @@ IRModule SequentialNode::operator()(IRModule mod, const PassContext& pass_ctx) c
   return mod;
 }
 
+namespace {
+
+/*!
+ * \brief The process-wide results of function-level passes, see FunctionPassMemo.
+ *
+ *  The entries are evicted in least recently used order. The structural hashes of the functions
+ *  held by the entries are kept alongside, as the result of one pass is the input of the next.
+ */
+class FunctionPassMemoTable {
+ public:
+  static FunctionPassMemoTable* Global() {
+    static auto* inst = new FunctionPassMemoTable();
+    return inst;
+  }
+
+  uint64_t Hash(const BaseFunc& func) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = known_hashes_.find(func.get());
+      if (it != known_hashes_.end()) return it->second.first;
+    }
+    return StructuralHash()(func);
+  }
+
+  bool Lookup(uint64_t key, const BaseFunc& func, ObjectRef* result) {
+    BaseFunc input;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(key);
+      if (it == entries_.end()) return false;
+      input = it->second->input;
+      *result = it->second->result;
+    }
+    // The key is a hash, so the input is compared as well.
+    if (!input.same_as(func) && !StructuralEqual()(input, func)) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+    }
+    return true;
+  }
+
+  void Update(uint64_t key, const BaseFunc& input, uint64_t input_hash, const ObjectRef& result) {
+    uint64_t result_hash = input_hash;
+    if (result.defined() && !result.same_as(input)) {
+      result_hash = StructuralHash()(result);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      Erase(it->second);
+    }
+    lru_.push_front(Entry{key, input, result});
+    entries_[key] = lru_.begin();
+    Retain(input.get(), input_hash);
+    Retain(result.get(), result_hash);
+    while (lru_.size() > kMaxEntries) {
+      Erase(std::prev(lru_.end()));
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    known_hashes_.clear();
+  }
+
+ private:
+  struct Entry {
+    uint64_t key;
+    BaseFunc input;
+    ObjectRef result;
+  };
+
+  /*! \brief The maximum number of entries, i.e. of functions times passes. */
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  void Retain(const Object* func, uint64_t hash) {
+    if (func == nullptr) return;
+    auto& known = known_hashes_[func];
+    known.first = hash;
+    ++known.second;
+  }
+
+  void Release(const Object* func) {
+    if (func == nullptr) return;
+    auto it = known_hashes_.find(func);
+    if (--it->second.second == 0) {
+      known_hashes_.erase(it);
+    }
+  }
+
+  void Erase(std::list<Entry>::iterator it) {
+    Release(it->input.get());
+    Release(it->result.get());
+    entries_.erase(it->key);
+    lru_.erase(it);
+  }
+
+  std::mutex mutex_;
+  std::list<Entry> lru_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> entries_;
+  /*! \brief The hash and the number of uses of each function held by the entries. */
+  std::unordered_map<const Object*, std::pair<uint64_t, int>> known_hashes_;
+};
+
+}  // namespace
+
+bool IsHashableConfigValue(const ObjectRef& value) {
+  if (const auto* attrs = value.as<DictAttrsNode>()) {
+    return IsHashableConfigValue(attrs->dict);
+  }
+  if (value.as<IntImmNode>() || value.as<FloatImmNode>() || value.as<runtime::StringObj>() ||
+      value.as<BaseAttrsNode>()) {
+    return true;
+  }
+  if (const auto* arr = value.as<runtime::ArrayNode>()) {
+    return std::all_of(arr->begin(), arr->end(), IsHashableConfigValue);
+  }
+  if (const auto* map = value.as<runtime::MapNode>()) {
+    return std::all_of(map->begin(), map->end(), [](const auto& kv) {
+      return IsHashableConfigValue(kv.first) && IsHashableConfigValue(kv.second);
+    });
+  }
+  return false;
+}
+
+FunctionPassMemo::FunctionPassMemo(const PassInfo& pass_info, const IRModule& mod,
+                                   const PassContext& pass_ctx) {
+  if (!pass_info->memo_key.defined() ||
+      !pass_ctx->GetConfig<Bool>("ir.incremental_passes", Bool(false)).value() ||
+      !IsHashableConfigValue(pass_ctx->config) ||
+      (mod->attrs.defined() && !IsHashableConfigValue(mod->attrs))) {
+    return;
+  }
+  enabled_ = true;
+  uint64_t hash_value = std::hash<std::string>()(pass_info->name);
+  hash_value = support::HashCombine(hash_value, pass_info->opt_level);
+  hash_value = support::HashCombine(hash_value, StructuralHash()(pass_info->memo_key));
+  hash_value = support::HashCombine(
+      hash_value, StructuralHash()(Array<ObjectRef>{Integer(pass_ctx->opt_level),
+                                                    pass_ctx->required_pass,
+                                                    pass_ctx->disabled_pass, pass_ctx->config}));
+  Target target = Target::Current();
+  if (target.defined()) {
+    hash_value = support::HashCombine(hash_value, std::hash<std::string>()(target->str()));
+  }
+  // The signatures of the functions, in an order independent of the module.
+  std::vector<uint64_t> signatures;
+  for (const auto& [gvar, func] : mod->functions) {
+    uint64_t signature = std::hash<std::string>()(gvar->name_hint);
+    signature = support::HashCombine(signature, StructuralHash()(func->checked_type_));
+    signature = support::HashCombine(signature, StructuralHash()(func->struct_info_));
+    signatures.push_back(signature);
+  }
+  std::sort(signatures.begin(), signatures.end());
+  for (uint64_t signature : signatures) {
+    hash_value = support::HashCombine(hash_value, signature);
+  }
+  hash_value = support::HashCombine(hash_value, StructuralHash()(mod->attrs));
+  context_hash_ = support::HashCombine(hash_value, StructuralHash()(mod->global_infos));
+}
+
+FunctionPassMemo::~FunctionPassMemo() {
+  if (num_lookups_ > 0) {
+    instrument::RecordFunctionPassMemoLookups(num_lookups_, num_hits_);
+  }
+}
+
+bool FunctionPassMemo::Lookup(const BaseFunc& func, uint64_t* func_hash,
+                              ObjectRef* result) const {
+  FunctionPassMemoTable* table = FunctionPassMemoTable::Global();
+  *func_hash = table->Hash(func);
+  bool hit = table->Lookup(support::HashCombine(context_hash_, *func_hash), func, result);
+  ++num_lookups_;
+  if (hit) ++num_hits_;
+  return hit;
+}
+
+void FunctionPassMemo::Update(uint64_t func_hash, const BaseFunc& func,
+                              const ObjectRef& result) const {
+  FunctionPassMemoTable::Global()->Update(support::HashCombine(context_hash_, func_hash), func,
+                                          func_hash, result);
+}
+
+void FunctionPassMemo::Clear() { FunctionPassMemoTable::Global()->Clear(); }
+
+namespace {
+
+/*!
+ * \brief Makes a PassContext current on this thread for its lifetime. Unlike entering the
+ *  PassContext with With<PassContext>, this does not run the instruments again.
+ */
+class ThreadPassContextScope {
+ public:
+  explicit ThreadPassContextScope(const PassContext& pass_ctx) {
+    RelayPassContextThreadLocalStore::Get()->context_stack.push(pass_ctx);
+  }
+
+  ~ThreadPassContextScope() { RelayPassContextThreadLocalStore::Get()->context_stack.pop(); }
+};
+
+}  // namespace
+
+void ParallelForFunctions(const PassContext& pass_ctx, int num_tasks, int num_threads,
+                          const std::function<void(int)>& ftask) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  if (num_threads == 1 || num_tasks <= 1) {
+    for (int i = 0; i < num_tasks; ++i) {
+      ftask(i);
+    }
+    return;
+  }
+  Target target = Target::Current();
+  // Keep the first error so that it reaches the caller unchanged, instead of being
+  // rewrapped by parallel_for_dynamic.
+  std::mutex error_mutex;
+  std::exception_ptr error = nullptr;
+  std::atomic<bool> failed{false};
+  support::parallel_for_dynamic(0, num_tasks, num_threads, [&](int thread_id, int task_id) {
+    if (failed.load()) return;
+    try {
+      ThreadPassContextScope ctx_scope(pass_ctx);
+      if (target.defined()) {
+        With<Target> target_scope(target);
+        ftask(task_id);
+      } else {
+        ftask(task_id);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+      failed.store(true);
+    }
+  });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 Pass CreateModulePass(const runtime::TypedPackedFunc<IRModule(IRModule, PassContext)>& pass_func,
                       int opt_level, String name, tvm::Array<String> required, bool traceable) {
   PassInfo pass_info = PassInfo(opt_level, name, required, traceable);
@@ -701,5 +956,7 @@ TVM_REGISTER_GLOBAL("transform.PrintIR").set_body_typed(PrintIR);
 
 TVM_REGISTER_GLOBAL("transform.ListConfigs").set_body_typed(PassContext::ListConfigs);
 
+TVM_REGISTER_GLOBAL("transform.ClearFunctionPassMemo").set_body_typed(FunctionPassMemo::Clear);
+
 }  // namespace transform
 }  // namespace tvm
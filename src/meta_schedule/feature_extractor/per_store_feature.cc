@@ -1393,13 +1393,11 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
   Array<runtime::NDArray> ExtractFrom(const TuneContext& tune_context,
                                       const Array<MeasureCandidate>& candidates) {
     bool is_gpu = tune_context->target.value()->kind->name == "cuda";
-    std::vector<runtime::NDArray> results;
-    results.resize(candidates.size());
     std::unique_ptr<tir::group6::Feature> feature_group6 = nullptr;
     if (extract_workload) {
       feature_group6 = std::make_unique<tir::group6::Feature>(tune_context->mod.value());
     }
-    auto f = [this, is_gpu, &feature_group6, &candidates, &results](int, int task_id) -> void {
+    auto f = [this, is_gpu, &feature_group6, &candidates](int, int task_id) -> runtime::NDArray {
       const auto& candidate = candidates[task_id];
       std::vector<std::vector<double>> features;
       ExtractSingle(DeepCopyIRModule(candidate->sch->mod()), is_gpu, &features);
@@ -1408,10 +1406,10 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
           feature_group6->Export(&feature);
         }
       }
-      results[task_id] = tir::utils::AsNDArray(features, this->feature_vector_length);
+      return tir::utils::AsNDArray(features, this->feature_vector_length);
     };
-    support::parallel_for_dynamic(0, candidates.size(), tune_context->num_threads, f);
-    return results;
+    return support::parallel_map<runtime::NDArray>(0, candidates.size(),
+                                                   tune_context->num_threads, f);
   }
 
   static constexpr const char* _type_key = "meta_schedule.PerStoreFeature";
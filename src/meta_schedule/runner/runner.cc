@@ -29,10 +29,12 @@ RunnerInput::RunnerInput(String artifact_path, String device_type, Array<ArgInfo
   this->data_ = n;
 }
 
-RunnerResult::RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg) {
+RunnerResult::RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg,
+                           Optional<Map<String, FloatImm>> perf_counters) {
   ObjectPtr<RunnerResultNode> n = make_object<RunnerResultNode>();
   n->run_secs = run_secs;
   n->error_msg = error_msg;
+  n->perf_counters = perf_counters;
   this->data_ = n;
 }
 
@@ -62,8 +64,9 @@ TVM_REGISTER_GLOBAL("meta_schedule.RunnerInput")
       return RunnerInput(artifact_path, device_type, args_info);
     });
 TVM_REGISTER_GLOBAL("meta_schedule.RunnerResult")
-    .set_body_typed([](Array<FloatImm> run_secs, Optional<String> error_msg) -> RunnerResult {
-      return RunnerResult(run_secs, error_msg);
+    .set_body_typed([](Array<FloatImm> run_secs, Optional<String> error_msg,
+                       Optional<Map<String, FloatImm>> perf_counters) -> RunnerResult {
+      return RunnerResult(run_secs, error_msg, perf_counters);
     });
 TVM_REGISTER_GLOBAL("meta_schedule.RunnerFuture")
     .set_body_typed([](RunnerFuture::FDone f_done, RunnerFuture::FResult f_result) -> RunnerFuture {
@@ -481,24 +481,20 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickBestFromDatabase(int nu
   }
   int actual_num = measured_traces.size();
   ThreadedTraceApply pp(self->postprocs_);
-  std::vector<Schedule> results(actual_num, Schedule{nullptr});
-  auto f_proc_measured = [this, &measured_traces, &results, &pp](int thread_id,
-                                                                 int trace_id) -> void {
+  auto f_proc_measured = [this, &measured_traces, &pp](int thread_id, int trace_id) -> Schedule {
     PerThreadData& data = this->per_thread_data_.at(thread_id);
     TRandState* rand_state = &data.rand_state;
     const IRModule& mod = data.mod;
     tir::Trace trace = measured_traces.at(trace_id);
-    Schedule& result = results.at(trace_id);
-    ICHECK(!result.defined());
-    if (Optional<Schedule> sch = pp.Apply(mod, trace, rand_state)) {
-      result = sch.value();
-    } else {
+    Optional<Schedule> sch = pp.Apply(mod, trace, rand_state);
+    if (!sch.defined()) {
       LOG(FATAL) << "ValueError: Cannot postprocess the trace:\n" << trace;
       throw;
     }
+    return sch.value();
   };
-  support::parallel_for_dynamic(0, actual_num, self->ctx_->num_threads, f_proc_measured);
-  return results;
+  return support::parallel_map<Schedule>(0, actual_num, self->ctx_->num_threads,
+                                         f_proc_measured);
 }
 
 std::vector<Schedule> EvolutionarySearchNode::State::SampleInitPopulation(int num) {
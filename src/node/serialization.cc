@@ -35,6 +35,8 @@
 #include <cctype>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "../runtime/object_internal.h"
 #include "../support/base64.h"
@@ -500,7 +502,13 @@ struct JSONGraph {
     helper.ReadAllFields(reader);
   }
 
-  static JSONGraph Create(const ObjectRef& root) {
+  /*!
+   * \brief Create the graph of the objects reachable from the root.
+   * \param root The root object.
+   * \param tensors If not nullptr, the NDArrays of the graph are returned through it instead
+   *  of being base64-encoded into the graph.
+   */
+  static JSONGraph Create(const ObjectRef& root, std::vector<DLTensor*>* tensors = nullptr) {
     JSONGraph g;
     NodeIndexer indexer;
     indexer.MakeIndex(const_cast<Object*>(root.get()));
@@ -515,6 +523,10 @@ struct JSONGraph {
     }
     g.attrs["tvm_version"] = TVM_VERSION;
     g.root = indexer.node_index_.at(const_cast<Object*>(root.get()));
+    if (tensors != nullptr) {
+      *tensors = std::move(indexer.tensor_list_);
+      return g;
+    }
     // serialize tensor
     for (DLTensor* tensor : indexer.tensor_list_) {
       std::string blob;
@@ -571,8 +583,45 @@ std::string SaveJSON(const ObjectRef& n) {
   return os.str();
 }
 
-ObjectRef LoadJSON(std::string json_str) {
+/*!
+ * \brief Create the objects of a graph and set their fields.
+ * \param jgraph The graph, whose field dependencies are filled in.
+ * \param tensors The NDArrays referred to by the graph.
+ * \return The root object.
+ */
+ObjectRef CreateObjectGraph(JSONGraph* jgraph, const std::vector<runtime::NDArray>& tensors) {
   ReflectionVTable* reflection = ReflectionVTable::Global();
+  size_t n_nodes = jgraph->nodes.size();
+  // Pass 1: create all non-container objects
+  std::vector<ObjectPtr<Object>> nodes(n_nodes, nullptr);
+  for (size_t i = 0; i < n_nodes; ++i) {
+    const JSONNode& jnode = jgraph->nodes[i];
+    if (jnode.type_key.length() != 0) {
+      nodes[i] = reflection->CreateInitObject(jnode.type_key, jnode.repr_bytes);
+    }
+  }
+  // Pass 2: figure out all field dependency
+  {
+    FieldDependencyFinder dep_finder;
+    for (size_t i = 0; i < n_nodes; ++i) {
+      dep_finder.Find(nodes[i].get(), &jgraph->nodes[i]);
+    }
+  }
+  // Pass 3: topo sort
+  std::vector<size_t> topo_order = jgraph->TopoSort();
+  // Pass 4: set all values
+  {
+    JSONAttrSetter setter;
+    setter.node_list_ = &nodes;
+    setter.tensor_list_ = &tensors;
+    for (size_t i : topo_order) {
+      setter.Set(&nodes[i], &jgraph->nodes[i]);
+    }
+  }
+  return ObjectRef(nodes.at(jgraph->root));
+}
+
+ObjectRef LoadJSON(std::string json_str) {
   JSONGraph jgraph;
   {
     // load in json graph.
@@ -580,7 +629,6 @@ ObjectRef LoadJSON(std::string json_str) {
     dmlc::JSONReader reader(&is);
     jgraph.Load(&reader);
   }
-  size_t n_nodes = jgraph.nodes.size();
   std::vector<runtime::NDArray> tensors;
   {
     // load in tensors
@@ -593,36 +641,174 @@ ObjectRef LoadJSON(std::string json_str) {
       tensors.emplace_back(std::move(temp));
     }
   }
-  // Pass 1: create all non-container objects
-  std::vector<ObjectPtr<Object>> nodes(n_nodes, nullptr);
-  for (size_t i = 0; i < n_nodes; ++i) {
-    const JSONNode& jnode = jgraph.nodes[i];
-    if (jnode.type_key.length() != 0) {
-      nodes[i] = reflection->CreateInitObject(jnode.type_key, jnode.repr_bytes);
-    }
+  return CreateObjectGraph(&jgraph, tensors);
+}
+
+/*! \brief Magic number of the binary format. */
+constexpr uint64_t kTVMBinaryGraphMagic = 0x4E4942474D5654ULL;  // "TVMGBIN"
+/*! \brief Version of the binary format. */
+constexpr uint64_t kTVMBinaryGraphVersion = 1;
+/*! \brief Alignment of the NDArray data in the binary format, which allows it to be mmapped. */
+constexpr size_t kTVMBinaryGraphDataAlignment = 64;
+
+/*!
+ * \brief The strings of the binary format, which are stored once and referred to by index.
+ *  Most of the strings, e.g. type keys, field names and small values, repeat across nodes.
+ */
+class BinaryStringTable {
+ public:
+  uint32_t Intern(const std::string& str) {
+    auto it = index_.find(str);
+    if (it != index_.end()) return it->second;
+    uint32_t index = static_cast<uint32_t>(strings_.size());
+    index_.emplace(str, index);
+    strings_.push_back(str);
+    return index;
   }
-  // Pass 2: figure out all field dependency
-  {
-    FieldDependencyFinder dep_finder;
-    for (size_t i = 0; i < n_nodes; ++i) {
-      dep_finder.Find(nodes[i].get(), &jgraph.nodes[i]);
+
+  std::vector<uint32_t> InternAttrs(const AttrMap& attrs) {
+    std::vector<uint32_t> result;
+    result.reserve(attrs.size() * 2);
+    for (const auto& kv : attrs) {
+      result.push_back(Intern(kv.first));
+      result.push_back(Intern(kv.second));
     }
+    return result;
   }
-  // Pass 3: topo sort
-  std::vector<size_t> topo_order = jgraph.TopoSort();
-  // Pass 4: set all values
+
+  const std::vector<std::string>& strings() const { return strings_; }
+
+ private:
+  std::unordered_map<std::string, uint32_t> index_;
+  std::vector<std::string> strings_;
+};
+
+std::string SaveBinary(const ObjectRef& n) {
+  std::vector<DLTensor*> tensors;
+  JSONGraph jgraph = JSONGraph::Create(n, &tensors);
+  BinaryStringTable table;
+  table.Intern("");
+  std::string nodes_blob;
   {
-    JSONAttrSetter setter;
-    setter.node_list_ = &nodes;
-    setter.tensor_list_ = &tensors;
-    for (size_t i : topo_order) {
-      setter.Set(&nodes[i], &jgraph.nodes[i]);
+    dmlc::MemoryStringStream strm(&nodes_blob);
+    for (const JSONNode& jnode : jgraph.nodes) {
+      std::vector<uint32_t> keys;
+      for (const std::string& key : jnode.keys) {
+        keys.push_back(table.Intern(key));
+      }
+      strm.Write(table.Intern(jnode.type_key));
+      strm.Write(table.Intern(jnode.repr_bytes));
+      strm.Write(table.InternAttrs(jnode.attrs));
+      strm.Write(keys);
+      std::vector<uint64_t> data(jnode.data.begin(), jnode.data.end());
+      strm.Write(data);
+    }
+  }
+  std::vector<uint32_t> graph_attrs = table.InternAttrs(jgraph.attrs);
+  // Lay out the tensors, padded so that the data of each one is aligned.
+  std::string tensors_blob;
+  std::vector<uint64_t> tensor_offsets;
+  {
+    dmlc::MemoryStringStream strm(&tensors_blob);
+    for (DLTensor* tensor : tensors) {
+      // SaveDLTensor writes a 32-byte header, the shape and the data size before the data.
+      size_t data_offset = tensors_blob.size() + 32 + sizeof(int64_t) * (tensor->ndim + 1);
+      size_t padding = (kTVMBinaryGraphDataAlignment - data_offset % kTVMBinaryGraphDataAlignment) %
+                       kTVMBinaryGraphDataAlignment;
+      tensors_blob.append(padding, '\0');
+      strm.Seek(tensors_blob.size());
+      tensor_offsets.push_back(tensors_blob.size());
+      runtime::SaveDLTensor(&strm, tensor);
     }
   }
-  return ObjectRef(nodes.at(jgraph.root));
+  std::string blob;
+  dmlc::MemoryStringStream strm(&blob);
+  strm.Write(kTVMBinaryGraphMagic);
+  strm.Write(kTVMBinaryGraphVersion);
+  strm.Write(table.strings());
+  strm.Write(static_cast<uint64_t>(jgraph.root));
+  strm.Write(static_cast<uint64_t>(jgraph.nodes.size()));
+  strm.Write(nodes_blob.data(), nodes_blob.size());
+  strm.Write(graph_attrs);
+  strm.Write(tensor_offsets);
+  blob.append((kTVMBinaryGraphDataAlignment - blob.size() % kTVMBinaryGraphDataAlignment) %
+                  kTVMBinaryGraphDataAlignment,
+              '\0');
+  blob.append(tensors_blob);
+  return blob;
+}
+
+ObjectRef LoadBinary(const std::string& blob) {
+  dmlc::MemoryFixedSizeStream strm(const_cast<char*>(blob.data()), blob.size());
+  uint64_t magic, version, root, n_nodes;
+  ICHECK(strm.Read(&magic) && magic == kTVMBinaryGraphMagic) << "Invalid binary IR format";
+  ICHECK(strm.Read(&version)) << "Invalid binary IR format";
+  ICHECK_EQ(version, kTVMBinaryGraphVersion) << "Unsupported binary IR format version";
+  std::vector<std::string> strings;
+  ICHECK(strm.Read(&strings) && strm.Read(&root) && strm.Read(&n_nodes))
+      << "Invalid binary IR format";
+  auto get_string = [&strings](uint32_t index) -> const std::string& {
+    ICHECK_LT(index, strings.size()) << "Invalid binary IR format";
+    return strings[index];
+  };
+  auto get_attrs = [&get_string](const std::vector<uint32_t>& indices, AttrMap* attrs) {
+    ICHECK_EQ(indices.size() % 2, 0U) << "Invalid binary IR format";
+    for (size_t i = 0; i < indices.size(); i += 2) {
+      attrs->emplace(get_string(indices[i]), get_string(indices[i + 1]));
+    }
+  };
+  JSONGraph jgraph;
+  jgraph.root = root;
+  jgraph.nodes.resize(n_nodes);
+  std::vector<uint32_t> attrs, keys;
+  std::vector<uint64_t> data;
+  for (JSONNode& jnode : jgraph.nodes) {
+    uint32_t type_key, repr_bytes;
+    ICHECK(strm.Read(&type_key) && strm.Read(&repr_bytes) && strm.Read(&attrs) &&
+           strm.Read(&keys) && strm.Read(&data))
+        << "Invalid binary IR format";
+    jnode.type_key = get_string(type_key);
+    jnode.repr_bytes = get_string(repr_bytes);
+    get_attrs(attrs, &jnode.attrs);
+    for (uint32_t key : keys) {
+      jnode.keys.push_back(get_string(key));
+    }
+    for (uint64_t index : data) {
+      ICHECK_LT(index, n_nodes) << "Invalid binary IR format";
+      jnode.data.push_back(index);
+    }
+  }
+  ICHECK_LT(root, n_nodes) << "Invalid binary IR format";
+  std::vector<uint64_t> tensor_offsets;
+  ICHECK(strm.Read(&attrs) && strm.Read(&tensor_offsets)) << "Invalid binary IR format";
+  get_attrs(attrs, &jgraph.attrs);
+  size_t tensors_begin = (strm.Tell() + kTVMBinaryGraphDataAlignment - 1) /
+                         kTVMBinaryGraphDataAlignment * kTVMBinaryGraphDataAlignment;
+  std::vector<runtime::NDArray> tensors;
+  for (uint64_t offset : tensor_offsets) {
+    ICHECK_LE(tensors_begin + offset, blob.size()) << "Invalid binary IR format";
+    dmlc::MemoryFixedSizeStream tensor_strm(const_cast<char*>(blob.data()) + tensors_begin + offset,
+                                            blob.size() - tensors_begin - offset);
+    runtime::NDArray temp;
+    ICHECK(temp.Load(&tensor_strm));
+    tensors.emplace_back(std::move(temp));
+  }
+  return CreateObjectGraph(&jgraph, tensors);
 }
 
 TVM_REGISTER_GLOBAL("node.SaveJSON").set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON").set_body_typed(LoadJSON);
+
+TVM_REGISTER_GLOBAL("node.SaveBinary").set_body([](TVMArgs args, TVMRetValue* rv) {
+  std::string blob = SaveBinary(args[0]);
+  TVMByteArray arr;
+  arr.data = blob.data();
+  arr.size = blob.size();
+  *rv = arr;
+});
+
+TVM_REGISTER_GLOBAL("node.LoadBinary").set_body_typed([](std::string blob) {
+  return LoadBinary(blob);
+});
 }  // namespace tvm
@@ -25,6 +25,7 @@
 #include <tvm/node/object_path.h>
 #include <tvm/node/reflection.h>
 #include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
 
 #include <optional>
@@ -578,6 +579,12 @@ TVM_REGISTER_GLOBAL("node.GetFirstStructuralMismatch")
 
 bool StructuralEqual::operator()(const ObjectRef& lhs, const ObjectRef& rhs,
                                  bool map_free_params) const {
+  // Structurally equal objects have the same hash, so differing cached hashes prove inequality.
+  uint64_t lhs_hash, rhs_hash;
+  if (!map_free_params && StructuralHashCache::Lookup(lhs, &lhs_hash) &&
+      StructuralHashCache::Lookup(rhs, &rhs_hash) && lhs_hash != rhs_hash) {
+    return false;
+  }
   return SEqualHandlerDefault(false, nullptr, false).Equal(lhs, rhs, map_free_params);
 }
 
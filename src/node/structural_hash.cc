@@ -31,7 +31,9 @@
 #include <tvm/target/codegen.h>
 
 #include <algorithm>
+#include <typeindex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "../support/base64.h"
 #include "../support/str_escape.h"
@@ -50,6 +52,94 @@ void ReflectionVTable::SHashReduce(const Object* self, SHashReducer reducer) con
   fshash_reduce_[tindex](self, reducer);
 }
 
+/*!
+ * \brief The structural hash cache of a thread, see StructuralHashCache.
+ *  Values are keyed by the handler type, as handlers may hash differently, and by the flags
+ *  the object was hashed with.
+ */
+class SHashCacheTable {
+ public:
+  /*! \brief Whether the hash value is of the root of a hash, rather than of a subtree. */
+  static constexpr int kRoot = 1;
+  /*! \brief Whether free variables were mapped. */
+  static constexpr int kMapFreeVars = 2;
+
+  /*!
+   * \brief Whether an object may be modified in place while it is referenced, bypassing
+   *  CopyOnWrite, as IRModuleNode::Add and Update do. The hashes of such objects, and of the
+   *  objects containing them, are not cached.
+   */
+  static bool IsModifiedInPlace(const Object* object) {
+    static const uint32_t module_type_index = Object::TypeKey2Index("IRModule");
+    return object->type_index() == module_type_index;
+  }
+
+  /*! \return The table of the current thread, or nullptr if not in scope. */
+  static SHashCacheTable* Current() {
+    SHashCacheTable* table = ThreadLocal();
+    return table->depth_ != 0 ? table : nullptr;
+  }
+
+  static SHashCacheTable* ThreadLocal() {
+    static thread_local SHashCacheTable table;
+    return &table;
+  }
+
+  bool Lookup(const std::type_index& handler, const ObjectRef& object, int flags,
+              uint64_t* hash_value) const {
+    auto it = values_.find(Key{handler, object, flags});
+    if (it == values_.end()) return false;
+    *hash_value = it->second;
+    return true;
+  }
+
+  void Update(const std::type_index& handler, const ObjectRef& object, int flags,
+              uint64_t hash_value) {
+    values_[Key{handler, object, flags}] = hash_value;
+  }
+
+  void Enter() { ++depth_; }
+
+  void Exit() {
+    ICHECK_GT(depth_, 0);
+    if (--depth_ == 0) {
+      values_.clear();
+    }
+  }
+
+ private:
+  struct Key {
+    std::type_index handler;
+    /*! \brief The object, kept alive so that it is neither modified nor freed. */
+    ObjectRef object;
+    int flags;
+
+    bool operator==(const Key& other) const {
+      return handler == other.handler && object.same_as(other.object) && flags == other.flags;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      uint64_t hash_value = support::HashCombine(key.handler.hash_code(), key.flags);
+      return support::HashCombine(hash_value, std::hash<const Object*>()(key.object.get()));
+    }
+  };
+
+  int depth_{0};
+  std::unordered_map<Key, uint64_t, KeyHash> values_;
+};
+
+void StructuralHashCache::EnterWithScope() { SHashCacheTable::ThreadLocal()->Enter(); }
+
+void StructuralHashCache::ExitWithScope() { SHashCacheTable::ThreadLocal()->Exit(); }
+
+bool StructuralHashCache::Lookup(const ObjectRef& object, uint64_t* hash_value) {
+  SHashCacheTable* cache = SHashCacheTable::Current();
+  return cache != nullptr && cache->Lookup(typeid(SHashHandlerDefault), object,
+                                           SHashCacheTable::kRoot, hash_value);
+}
+
 // Hash handler that handles free vars
 // by assigning an unique counter in the order of their occurrence.
 //
@@ -79,6 +169,12 @@ class SHashHandlerDefault::Impl {
     bool graph_node_hash{false};
     /*! \brief whether to map the free variables. */
     bool map_free_vars;
+    /*!
+     * \brief Whether the hash depends on the context of the object, i.e. the object is or
+     *  contains a graph node or a variable. Objects which are modified in place are marked as
+     *  well, so that their hash is not cached.
+     */
+    bool contextual{false};
 
     Task() = default;
     explicit Task(ObjectRef object, uint64_t reduced_hash, bool map_free_vars)
@@ -89,12 +185,16 @@ class SHashHandlerDefault::Impl {
     // need to push to pending tasks in this case
     ICHECK(!allow_push_to_stack_ && !task_stack_.empty());
     task_stack_.back().graph_node_hash = true;
+    task_stack_.back().contextual = true;
   }
 
   bool LookupHashedValue(const ObjectRef& key, uint64_t* hash_value) {
     auto it = hash_memo_.find(key);
     if (it != hash_memo_.end()) {
       hash_value[0] = it->second;
+      if (contextual_objects_.count(key.get()) && !task_stack_.empty()) {
+        task_stack_.back().contextual = true;
+      }
       return true;
     }
     return false;
@@ -115,6 +215,8 @@ class SHashHandlerDefault::Impl {
       uint64_t value = std::hash<const runtime::Object*>()(var);
       pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false));
     }
+    // Whether a variable is free depends on the context, even when hashed by its address.
+    pending_tasks_.back().contextual = true;
   }
 
   void SHashReduce(const ObjectRef& object, bool map_free_vars) {
@@ -128,9 +230,14 @@ class SHashHandlerDefault::Impl {
     auto it = hash_memo_.find(object);
     if (it != hash_memo_.end()) {
       pending_tasks_.emplace_back(Task(ObjectRef(nullptr), it->second, false));
+      pending_tasks_.back().contextual = contextual_objects_.count(object.get()) != 0;
     } else {
       // Push a pending task with initial value.
       pending_tasks_.emplace_back(Task(object, object->GetTypeKeyHash(), map_free_vars));
+      if (cache_ != nullptr && SHashCacheTable::IsModifiedInPlace(object.get())) {
+        pending_tasks_.back().contextual = true;
+        hashes_modified_in_place_ = true;
+      }
     }
   }
 
@@ -139,6 +246,18 @@ class SHashHandlerDefault::Impl {
     ICHECK_EQ(pending_tasks_.size(), 0U);
     ICHECK_EQ(result_stack_.size(), 0U);
 
+    cache_ = SHashCacheTable::Current();
+    hashes_modified_in_place_ = false;
+    // The hash of the root is reproducible if it is computed in an empty context, which is not
+    // the case when the handler is reused.
+    bool cache_root = cache_ != nullptr && object.defined() && hash_memo_.empty() &&
+                      !SHashCacheTable::IsModifiedInPlace(object.get());
+    int root_flags = SHashCacheTable::kRoot | (map_free_vars ? SHashCacheTable::kMapFreeVars : 0);
+    uint64_t cached_value;
+    if (cache_root && cache_->Lookup(typeid(*parent_), object, root_flags, &cached_value)) {
+      return cached_value;
+    }
+
     this->SHashReduce(object, map_free_vars);
     ICHECK_EQ(pending_tasks_.size(), 1U);
     ICHECK(allow_push_to_stack_);
@@ -150,6 +269,10 @@ class SHashHandlerDefault::Impl {
     ICHECK_EQ(result_stack_.size(), 1U);
     uint64_t ret = result_stack_.back();
     result_stack_.pop_back();
+    result_contextual_stack_.pop_back();
+    if (cache_root && !hashes_modified_in_place_) {
+      cache_->Update(typeid(*parent_), object, root_flags, ret);
+    }
     return ret;
   }
 
@@ -165,24 +288,31 @@ class SHashHandlerDefault::Impl {
   void PopTaskStack() {
     const auto& entry = task_stack_.back();
     result_stack_.push_back(entry.reduced_hash);
+    result_contextual_stack_.push_back(entry.contextual);
     task_stack_.pop_back();
   }
   /*!
    * \brief Compute the reduced hash value for the task.
    * \param task The indicated task.
    */
-  uint64_t ReduceHash(const Task& task) {
-    uint64_t stack_begin = task.result_stack_index;
+  uint64_t ReduceHash(Task* task) {
+    uint64_t stack_begin = task->result_stack_index;
     ICHECK_LE(stack_begin, result_stack_.size());
 
     // combine in the reverse order of the stack.
-    uint64_t reduced_hash = task.reduced_hash;
+    uint64_t reduced_hash = task->reduced_hash;
     for (uint32_t i = result_stack_.size(); i != stack_begin; --i) {
       reduced_hash = support::HashCombine(reduced_hash, result_stack_[i - 1]);
+      task->contextual |= result_contextual_stack_[i - 1];
     }
     result_stack_.resize(stack_begin);
+    result_contextual_stack_.resize(stack_begin);
     return reduced_hash;
   }
+  /*! \brief The cache flags of the subtree of a task. */
+  static int SubtreeFlags(const Task& task) {
+    return task.map_free_vars ? SHashCacheTable::kMapFreeVars : 0;
+  }
   // run the tasks.
   void RunTasks() {
     while (task_stack_.size() != 0) {
@@ -190,13 +320,14 @@ class SHashHandlerDefault::Impl {
       auto& entry = task_stack_.back();
       if (entry.children_expanded) {
         // reduce hash
-        entry.reduced_hash = ReduceHash(entry);
+        entry.reduced_hash = ReduceHash(&entry);
         // When all the children has expanded and visited.
         // entry.reduced_hash contains the reduced hash result.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
           // use the pre-computed hash for the object.
           entry.reduced_hash = it->second;
+          entry.contextual = contextual_objects_.count(entry.object.get()) != 0;
         } else {
           // Append the graph node counter to the hash
           // so that we can distinguish DAG from trees.
@@ -205,6 +336,12 @@ class SHashHandlerDefault::Impl {
                                                       std::hash<uint64_t>()(graph_node_counter_++));
           }
           hash_memo_[entry.object] = entry.reduced_hash;
+          if (entry.contextual) {
+            contextual_objects_.insert(entry.object.get());
+          } else if (cache_ != nullptr) {
+            cache_->Update(typeid(*parent_), entry.object, SubtreeFlags(entry),
+                           entry.reduced_hash);
+          }
         }
         // send value to parent.
         this->PopTaskStack();
@@ -214,8 +351,16 @@ class SHashHandlerDefault::Impl {
       } else {
         // check if there are already hash for object.
         auto it = hash_memo_.find(entry.object);
+        uint64_t cached_value;
         if (it != hash_memo_.end()) {
           entry.reduced_hash = it->second;
+          entry.contextual = contextual_objects_.count(entry.object.get()) != 0;
+          this->PopTaskStack();
+        } else if (cache_ != nullptr && cache_->Lookup(typeid(*parent_), entry.object,
+                                                       SubtreeFlags(entry), &cached_value)) {
+          // The subtree was hashed before and its hash does not depend on the context.
+          entry.reduced_hash = cached_value;
+          hash_memo_[entry.object] = cached_value;
           this->PopTaskStack();
         } else {
           // NOTE: important to modify entry before visit.
@@ -253,6 +398,14 @@ class SHashHandlerDefault::Impl {
   std::vector<Task> task_stack_;
   // Internal stack to store the result popped from the task stack.
   std::vector<uint64_t> result_stack_;
+  // Whether each result on the result stack is contextual.
+  std::vector<bool> result_contextual_stack_;
+  // The objects in hash_memo_ whose hash depends on their context.
+  std::unordered_set<const Object*> contextual_objects_;
+  // The cache of the current scope, if any.
+  SHashCacheTable* cache_{nullptr};
+  // Whether the current hash includes an object which is modified in place.
+  bool hashes_modified_in_place_{false};
   // reflection vtable
   ReflectionVTable* vtable_ = ReflectionVTable::Global();
   // map from lhs to rhs
@@ -288,6 +441,14 @@ void SHashHandlerDefault::DispatchSHash(const ObjectRef& key, bool map_free_vars
   impl->DispatchSHash(key, map_free_vars);
 }
 
+TVM_REGISTER_GLOBAL("node.EnterStructuralHashCache").set_body_typed([]() {
+  SHashCacheTable::ThreadLocal()->Enter();
+});
+
+TVM_REGISTER_GLOBAL("node.ExitStructuralHashCache").set_body_typed([]() {
+  SHashCacheTable::ThreadLocal()->Exit();
+});
+
 TVM_REGISTER_GLOBAL("node.StructuralHash")
     .set_body_typed([](const ObjectRef& object, bool map_free_vars) -> int64_t {
       uint64_t hashed_value = SHashHandlerDefault().Hash(object, map_free_vars);
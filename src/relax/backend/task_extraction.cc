@@ -18,6 +18,7 @@
  */
 
 #include <tvm/meta_schedule/extracted_task.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relax/expr.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/target/target.h>
@@ -67,6 +68,8 @@ class BlockCounter : public tir::StmtVisitor {
 class TaskExtractor : public ExprVisitor {
  public:
   static Array<ExtractedTask> ExtractTask(IRModule mod, Target target, String mod_eq_name) {
+    // The extracted functions are hashed repeatedly when deduplicating the tasks.
+    With<StructuralHashCache> hash_cache;
     TaskExtractor extractor(mod, target, mod_eq_name);
     // We go through each Relax function in the module.
     for (const auto& kv : mod->functions) {
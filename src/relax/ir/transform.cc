@@ -139,13 +139,16 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   VLOG(1) << "Input module:" << std::endl << mod;
 
   IRModule updated_mod = mod->ShallowCopy();
+  tvm::transform::FunctionPassMemo memo(pass_info, mod, pass_ctx);
 
   std::vector<std::pair<GlobalVar, Function> > updates;
   for (const auto& it : updated_mod->functions) {
     // only picks up relax::Function
     if (auto* n = it.second.as<FunctionNode>()) {
       Function func = GetRef<Function>(n);
-      auto updated_func = SkipFunction(func) ? func : pass_func(func, updated_mod, pass_ctx);
+      auto updated_func = SkipFunction(func) ? func : memo.Apply(func, [&](Function f) {
+        return pass_func(std::move(f), updated_mod, pass_ctx);
+      });
       updates.push_back({it.first, updated_func});
     }
   }
@@ -173,8 +176,9 @@ bool FunctionPassNode::SkipFunction(const Function& func) const {
 
 Pass CreateFunctionPass(
     const runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable) {
-  PassInfo pass_info = PassInfo(opt_level, name, required, traceable);
+    int opt_level, String name, tvm::Array<String> required, bool traceable,
+    Optional<Array<ObjectRef>> memo_key) {
+  PassInfo pass_info = PassInfo(opt_level, name, required, traceable, std::move(memo_key));
   return FunctionPass(pass_func, pass_info);
 }
 
@@ -24,6 +24,7 @@
  *
  * Currently it removes common subexpressions within a Function.
  */
+#include <tvm/node/structural_hash.h>
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
@@ -217,6 +218,8 @@ namespace transform {
 Pass EliminateCommonSubexpr(bool call_only) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function func, IRModule m, PassContext pc) {
+        // The bound values are hashed once per lookup, and nested ones as part of their users.
+        With<StructuralHashCache> hash_cache;
         return Downcast<Function>(EliminateCommonSubexpr(func, call_only));
       };
   return CreateFunctionPass(pass_func, 1, "EliminateCommonSubexpr", {});
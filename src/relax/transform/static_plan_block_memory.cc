@@ -64,12 +64,23 @@
  * It means the maximum value of variable that names "n" in the function
  * signature will have upper bound 1024. And we will use 1024 as its value
  * during memory planning.
+ *
+ * Optionally, when the PassContext config "relax.memory_plan.use_arena" is
+ * set, the planned storages of each function whose sizes are compile-time
+ * constants (possibly through the upper bounds above) are laid out in a
+ * single per-function arena. Every such storage token is assigned an aligned
+ * byte offset at compile time, one `memory.alloc_storage` is emitted for the
+ * whole arena of each (device, storage scope), and the tensors are carved out
+ * of the arena via `memory.alloc_tensor` with the precomputed offsets. This
+ * turns the runtime allocation traffic of a function into a single slab
+ * allocation and makes the peak planned memory deterministic.
  */
 #include <tvm/arith/analyzer.h>
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/nested_msg.h>
 #include <tvm/relax/transform.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/stmt_functor.h>
 
 #include <map>
@@ -79,6 +90,8 @@
 namespace tvm {
 namespace relax {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.memory_plan.use_arena", Bool);
+
 /*!
  * \brief A representation of a block of reusable memory required at runtime.
  * \details Only the tensors whose memory can be "possibly reused" will have
@@ -828,10 +841,12 @@ class StorageAllocationRewriter : public ExprMutator {
   explicit StorageAllocationRewriter(
       IRModule mod, std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token,
       std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>>
-          block2tokens)
+          block2tokens,
+      bool use_arena)
       : ExprMutator(std::move(mod)),
         alloc_tensor2token_(std::move(alloc_tensor2token)),
-        block2tokens_(std::move(block2tokens)) {}
+        block2tokens_(std::move(block2tokens)),
+        use_arena_(use_arena) {}
 
   IRModule Rewrite() {
     const IRModule& mod = builder_->GetContextIRModule();
@@ -847,7 +862,18 @@ class StorageAllocationRewriter : public ExprMutator {
         SetTIRVarUpperBound(GetRef<Function>(func_), &ana_, &dom_map_);
       }
       token2storage_var_.clear();
+      token2arena_offset_.clear();
+      arena_size_.clear();
+      arena2storage_var_.clear();
+      Array<Binding> arena_bindings;
+      if (use_arena_) {
+        PlanArena(GetRef<Function>(func_));
+        arena_bindings = CreateArenas();
+      }
       Function func = Downcast<Function>(this->VisitExpr_(func_));
+      if (!arena_bindings.empty()) {
+        func = PrependBindings(func, arena_bindings);
+      }
       if (plan_dynamic_output_) {
         func = WithoutAttr(func, plan_dyn_attr_);
       }
@@ -858,6 +884,94 @@ class StorageAllocationRewriter : public ExprMutator {
 
  private:
   using ExprMutator::VisitExpr_;
+  /*! \brief The key of an arena, consisting of the runtime device index and the storage scope. */
+  using ArenaKey = std::pair<int64_t, std::string>;
+
+  /*!
+   * \brief Compute the arena layout of the input function.
+   * \details Each planned storage token whose size is a compile-time constant and which lives
+   * in the global storage scope is given a disjoint, aligned range inside the arena of its
+   * device. The tensors reusing a token are already placed at the same offset, so the arena
+   * size is the sum of the aligned sizes of the distinct tokens. This is the total memory of
+   * the planned storages without the arena, not the peak of the live tensors, as the tokens
+   * are not overlapped with each other. The offsets are assigned in the order in which the
+   * allocations appear in the function, which keeps the layout deterministic.
+   * \param func The function to be planned.
+   */
+  void PlanArena(const Function& func) {
+    PostOrderVisit(func->body, [this](const Expr& expr) {
+      auto it = alloc_tensor2token_.find(expr.get());
+      if (it == alloc_tensor2token_.end()) {
+        return;
+      }
+      const StorageToken& token = it->second;
+      if (token2arena_offset_.count(token.get())) {
+        return;
+      }
+      int64_t bytes = token->const_bytes();
+      const auto* device_index =
+          Downcast<PrimValue>(Downcast<Call>(expr)->args[2])->value.as<IntImmNode>();
+      if (bytes < 0 || device_index == nullptr ||
+          (!token->storage_scope.empty() && token->storage_scope != "global")) {
+        // Symbolic-sized and scoped storages keep being allocated on their own.
+        return;
+      }
+      ArenaKey key{device_index->value, "global"};
+      int64_t& arena_size = arena_size_[key];
+      int64_t offset = (arena_size + runtime::kAllocAlignment - 1) / runtime::kAllocAlignment *
+                       runtime::kAllocAlignment;
+      token2arena_offset_[token.get()] = {key, offset};
+      arena_size = offset + bytes;
+    });
+  }
+
+  /*!
+   * \brief Create the storage vars of the arenas of the current function.
+   * \details The arenas are allocated at the entry of the function rather than before their
+   * first tensor, which may be in a branch or a nested SeqExpr that does not dominate the
+   * other tensors of the arena.
+   * \return The bindings allocating the arenas.
+   */
+  Array<Binding> CreateArenas() {
+    static const Op& mem_alloc_storage = Op::Get("relax.memory.alloc_storage");
+    Array<Binding> bindings;
+    for (const auto& [key, size] : arena_size_) {
+      Call alloc_storage(mem_alloc_storage,
+                         {/*size=*/ShapeExpr({IntImm(DataType::Int(64), size)}),
+                          /*virtual_device_index=*/PrimValue::Int64(key.first),
+                          /*storage_scope=*/StringImm(key.second),
+                          /*dtype=*/DataTypeImm(DataType::UInt(8))},
+                         Attrs());
+      Expr value = builder_->Normalize(alloc_storage);
+      Var arena("arena", GetStructInfo(value));
+      bindings.push_back(VarBinding(arena, value));
+      arena2storage_var_[key] = arena;
+    }
+    return bindings;
+  }
+
+  /*!
+   * \brief Prepend bindings to the body of a function, in its first block if it is not a
+   * dataflow block.
+   * \param func The function.
+   * \param bindings The bindings to prepend.
+   * \return The updated function.
+   */
+  static Function PrependBindings(Function func, const Array<Binding>& bindings) {
+    SeqExpr body = func->body.as<SeqExprNode>() ? Downcast<SeqExpr>(func->body)
+                                                 : SeqExpr({}, func->body);
+    Array<BindingBlock> blocks = body->blocks;
+    if (!blocks.empty() && !blocks[0]->IsInstance<DataflowBlockNode>()) {
+      Array<Binding> first_bindings = bindings;
+      first_bindings.insert(first_bindings.end(), blocks[0]->bindings.begin(),
+                            blocks[0]->bindings.end());
+      blocks.Set(0, BindingBlock(first_bindings, blocks[0]->span));
+    } else {
+      blocks.insert(blocks.begin(), BindingBlock(bindings));
+    }
+    func.CopyOnWrite()->body = SeqExpr(blocks, body->body, body->span);
+    return func;
+  }
 
   Expr VisitExpr_(const CallNode* call) final {
     static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
@@ -872,18 +986,28 @@ class StorageAllocationRewriter : public ExprMutator {
       ICHECK_NOTNULL(sinfo->shape.as<ShapeExprNode>());
       PrimValue runtime_device_index = Downcast<PrimValue>(call->args[2]);
 
+      StorageToken token = it->second;
+      DataType dtype = sinfo->dtype;
+      // If the token is laid out in an arena, carve the tensor out of the arena.
+      auto it_arena = token2arena_offset_.find(token.get());
+      if (it_arena != token2arena_offset_.end()) {
+        const auto& [key, offset] = it_arena->second;
+        const Var& arena = arena2storage_var_.at(key);
+        return Call(mem_alloc_tensor,
+                    {arena, PrimValue::Int64(offset), sinfo->shape.value(), DataTypeImm(dtype)},
+                    Attrs());
+      }
+
       // If the token is visited for the first time, create a storage variable using
       // `memory.alloc_storage` for it.
-      StorageToken token = it->second;
       Var storage_var{nullptr};
       auto it_token = token2storage_var_.find(token.get());
       if (it_token == token2storage_var_.end()) {
         ShapeExpr size({token->bytes});
         PrimValue virtual_device_index = runtime_device_index;
-        DataType dtype = token->dtype;
         Call alloc_storage(mem_alloc_storage,
                            {std::move(size), virtual_device_index, StringImm(token->storage_scope),
-                            DataTypeImm(dtype)},
+                            DataTypeImm(token->dtype)},
                            Attrs());
         storage_var = builder_->Emit(alloc_storage, "storage");
         token2storage_var_[token.get()] = storage_var;
@@ -893,7 +1017,6 @@ class StorageAllocationRewriter : public ExprMutator {
 
       // And always create a `memory.alloc_tensor` for the old `builtin.alloc_tensor`.
       PrimValue offset = PrimValue::Int64(0);
-      DataType dtype = sinfo->dtype;
       return Call(mem_alloc_tensor, {storage_var, offset, sinfo->shape.value(), DataTypeImm(dtype)},
                   Attrs());
     } else if (plan_dynamic_output_ && call->op == alloc_tensor_op) {
@@ -947,9 +1070,17 @@ class StorageAllocationRewriter : public ExprMutator {
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens_;
   /*! \brief The mapping from each token to its corresponding storage var in each function. */
   std::unordered_map<const StorageTokenNode*, Var> token2storage_var_;
+  /*! \brief A boolean indicating whether to lay out the planned storages in per-function arenas. */
+  bool use_arena_;
+  /*! \brief The mapping from each token to its arena and byte offset in the current function. */
+  std::unordered_map<const StorageTokenNode*, std::pair<ArenaKey, int64_t>> token2arena_offset_;
+  /*! \brief The total size in bytes of each arena in the current function. */
+  std::map<ArenaKey, int64_t> arena_size_;
+  /*! \brief The mapping from each arena to its storage var in the current function. */
+  std::map<ArenaKey, Var> arena2storage_var_;
 };
 
-IRModule StaticPlanBlockMemory(IRModule mod) {
+IRModule StaticPlanBlockMemory(IRModule mod, bool use_arena) {
   arith::Analyzer ana;
 
   // Step 1. Initialize.
@@ -961,7 +1092,7 @@ IRModule StaticPlanBlockMemory(IRModule mod) {
   // Step 3. Rewrite the function.
   StorageAllocationRewriter rewriter(std::move(mod),  //
                                      std::move(allocator.alloc_tensor2token),
-                                     std::move(allocator.block2tokens));
+                                     std::move(allocator.block2tokens), use_arena);
   return rewriter.Rewrite();
 }
 
@@ -969,7 +1100,10 @@ namespace transform {
 
 Pass StaticPlanBlockMemory() {
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
-      [=](IRModule m, PassContext pc) { return relax::StaticPlanBlockMemory(std::move(m)); };
+      [=](IRModule m, PassContext pc) {
+        bool use_arena = pc->GetConfig<Bool>("relax.memory_plan.use_arena", Bool(false)).value();
+        return relax::StaticPlanBlockMemory(std::move(m), use_arena);
+      };
   return CreateModulePass(pass_func, /*opt_level=*/0, "StaticPlanBlockMemory", {});
 }
 
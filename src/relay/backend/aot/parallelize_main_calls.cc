@@ -0,0 +1,259 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/backend/aot/parallelize_main_calls.cc
+ * \brief Dispatch the independent operator calls of the AOT main function in parallel.
+ */
+#include "./parallelize_main_calls.h"
+
+#include <tvm/ir/module.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+namespace backend {
+namespace aot {
+
+using VarSet = std::unordered_set<const tir::VarNode*>;
+
+/*!
+ * \brief Find the parameters of a PrimFunc that it may write. Buffers that are only loaded
+ *  from are read, any other use of their data, e.g. passing it to a call, may write them.
+ */
+class WrittenParamsFinder : public tir::StmtExprVisitor {
+ public:
+  static std::vector<bool> Find(const tir::PrimFunc& func) {
+    WrittenParamsFinder finder;
+    finder(func->body);
+    std::vector<bool> written;
+    for (const tir::Var& param : func->params) {
+      const tir::VarNode* data = param.get();
+      auto it = func->buffer_map.find(param);
+      if (it != func->buffer_map.end()) {
+        data = (*it).second->data.get();
+      }
+      written.push_back(finder.written_.count(data) != 0);
+    }
+    return written;
+  }
+
+ private:
+  void VisitExpr_(const tir::VarNode* op) final { written_.insert(op); }
+
+  void VisitExpr_(const tir::BufferLoadNode* op) final {
+    // Only the indices are visited, a load does not write the buffer.
+    for (const PrimExpr& index : op->indices) {
+      VisitExpr(index);
+    }
+  }
+
+  void VisitExpr_(const tir::CallNode* op) final {
+    if (op->op.same_as(tir::builtin::address_of())) {
+      if (const auto* load = op->args[0].as<tir::BufferLoadNode>()) {
+        written_.insert(load->buffer->data.get());
+      }
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const tir::BufferStoreNode* op) final {
+    written_.insert(op->buffer->data.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const tir::BlockNode* op) final {
+    for (const tir::BufferRegion& region : op->writes) {
+      written_.insert(region->buffer->data.get());
+    }
+    for (const tir::MatchBufferRegion& match : op->match_buffers) {
+      written_.insert(match->source->buffer->data.get());
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  VarSet written_;
+};
+
+/*! \brief Schedule the independent calls of the main function into parallel waves. */
+class MainCallParallelizer : public tir::StmtMutator {
+ public:
+  explicit MainCallParallelizer(const IRModule& mod) {
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+        String name = func->GetAttr<String>(tvm::attr::kGlobalSymbol).value_or(kv.first->name_hint);
+        written_params_[name] = WrittenParamsFinder::Find(GetRef<tir::PrimFunc>(func));
+      }
+    }
+  }
+
+ private:
+  /*! \brief The buffers read and written by an operator call. */
+  struct CallAccess {
+    tir::Stmt stmt;
+    VarSet reads;
+    VarSet writes;
+  };
+
+  tir::Stmt VisitStmt_(const tir::LetStmtNode* op) final {
+    aliases_[op->var.get()] = VarsOf(op->value);
+    return StmtMutator::VisitStmt_(op);
+  }
+
+  tir::Stmt VisitStmt_(const tir::SeqStmtNode* op) final {
+    Array<tir::Stmt> seq;
+    std::vector<CallAccess> calls;
+    for (const tir::Stmt& stmt : op->seq) {
+      if (auto access = GetCallAccess(stmt)) {
+        calls.push_back(std::move(access.value()));
+        continue;
+      }
+      Schedule(std::move(calls), &seq);
+      calls.clear();
+      seq.push_back(VisitStmt(stmt));
+    }
+    Schedule(std::move(calls), &seq);
+    return tir::SeqStmt::Flatten(seq);
+  }
+
+  /*! \brief Get the accesses of an operator call, or nullopt for other statements. */
+  std::optional<CallAccess> GetCallAccess(const tir::Stmt& stmt) {
+    const auto* eval = stmt.as<tir::EvaluateNode>();
+    if (eval == nullptr) return std::nullopt;
+    const auto* call = eval->value.as<tir::CallNode>();
+    if (call == nullptr || !call->op.same_as(tir::builtin::tvm_call_cpacked())) {
+      return std::nullopt;
+    }
+    const auto* name = call->args[0].as<tir::StringImmNode>();
+    if (name == nullptr) return std::nullopt;
+    auto it = written_params_.find(name->value);
+    CallAccess access;
+    access.stmt = stmt;
+    for (size_t i = 1; i < call->args.size(); ++i) {
+      VarSet vars = VarsOf(call->args[i]);
+      // Unknown callees may write any argument. Trailing arguments beyond the parameters of
+      // the callee, i.e. the device context, are only passed through.
+      bool written = it == written_params_.end() ||
+                     (i - 1 < it->second.size() && it->second[i - 1]);
+      (written ? access.writes : access.reads).insert(vars.begin(), vars.end());
+    }
+    return access;
+  }
+
+  /*! \brief Get the variables an expression refers to, through the let bindings. */
+  VarSet VarsOf(const PrimExpr& expr) const {
+    VarSet vars;
+    tir::PostOrderVisit(expr, [&](const ObjectRef& node) {
+      if (const auto* var = node.as<tir::VarNode>()) {
+        auto it = aliases_.find(var);
+        if (it != aliases_.end()) {
+          vars.insert(it->second.begin(), it->second.end());
+        } else {
+          vars.insert(var);
+        }
+      } else if (const auto* load = node.as<tir::BufferLoadNode>()) {
+        vars.insert(load->buffer->data.get());
+      }
+    });
+    return vars;
+  }
+
+  static bool Intersects(const VarSet& a, const VarSet& b) {
+    return std::any_of(a.begin(), a.end(), [&b](const tir::VarNode* var) { return b.count(var); });
+  }
+
+  static bool DependsOn(const CallAccess& call, const CallAccess& earlier) {
+    return Intersects(call.writes, earlier.writes) || Intersects(call.writes, earlier.reads) ||
+           Intersects(call.reads, earlier.writes);
+  }
+
+  /*! \brief Emit the calls in waves of independent calls, each wave as a parallel loop. */
+  void Schedule(std::vector<CallAccess> calls, Array<tir::Stmt>* seq) {
+    std::vector<size_t> wave(calls.size(), 0);
+    size_t num_waves = 0;
+    for (size_t i = 0; i < calls.size(); ++i) {
+      for (size_t j = 0; j < i; ++j) {
+        if (wave[j] >= wave[i] && DependsOn(calls[i], calls[j])) {
+          wave[i] = wave[j] + 1;
+        }
+      }
+      num_waves = std::max(num_waves, wave[i] + 1);
+    }
+    if (num_waves == calls.size()) {
+      for (const CallAccess& call : calls) {
+        seq->push_back(call.stmt);
+      }
+      return;
+    }
+    for (size_t w = 0; w < num_waves; ++w) {
+      std::vector<tir::Stmt> stmts;
+      for (size_t i = 0; i < calls.size(); ++i) {
+        if (wave[i] == w) stmts.push_back(calls[i].stmt);
+      }
+      if (stmts.size() == 1) {
+        seq->push_back(stmts[0]);
+        continue;
+      }
+      tir::Var task("task_id", DataType::Int(32));
+      Array<tir::Stmt> body;
+      for (size_t i = 0; i < stmts.size(); ++i) {
+        body.push_back(tir::IfThenElse(task == static_cast<int>(i), stmts[i]));
+      }
+      seq->push_back(tir::For(task, 0, static_cast<int>(stmts.size()), tir::ForKind::kParallel,
+                              tir::SeqStmt(body)));
+    }
+  }
+
+  /*! \brief For each callee, whether it may write each of its parameters. */
+  std::unordered_map<std::string, std::vector<bool>> written_params_;
+  /*! \brief The variables that let-bound variables refer to. */
+  std::unordered_map<const tir::VarNode*, VarSet> aliases_;
+};
+
+tvm::transform::Pass ParallelizeMainCalls() {
+  runtime::TypedPackedFunc<IRModule(IRModule, tvm::transform::PassContext)> pass_func =
+      [=](IRModule mod, tvm::transform::PassContext ctx) {
+        GlobalVar main_var = mod->GetGlobalVar(runtime::symbol::tvm_module_main);
+        tir::PrimFunc main_func = Downcast<tir::PrimFunc>(mod->Lookup(main_var));
+        MainCallParallelizer parallelizer(mod);
+        main_func.CopyOnWrite()->body = parallelizer(main_func->body);
+        mod.CopyOnWrite()->Update(main_var, main_func);
+        return mod;
+      };
+  return tvm::transform::CreateModulePass(pass_func, 0, "ParallelizeMainCalls", {});
+}
+
+TVM_REGISTER_GLOBAL("relay.backend.aot.ParallelizeMainCalls").set_body_typed(ParallelizeMainCalls);
+
+}  // namespace aot
+}  // namespace backend
+}  // namespace relay
+}  // namespace tvm
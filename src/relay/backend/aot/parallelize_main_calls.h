@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef TVM_RELAY_BACKEND_AOT_PARALLELIZE_MAIN_CALLS_H_
+#define TVM_RELAY_BACKEND_AOT_PARALLELIZE_MAIN_CALLS_H_
+
+#include <tvm/ir/transform.h>
+
+namespace tvm {
+namespace relay {
+namespace backend {
+namespace aot {
+
+/*! \brief Dispatch the independent operator calls of the AOT main function in parallel.
+ *
+ * Consecutive tvm_call_cpacked calls of the main function are scheduled into waves, where
+ * the calls of a wave depend only on calls of earlier waves. A call depends on an earlier
+ * one if it reads or writes a buffer the earlier call writes, or writes a buffer the earlier
+ * call reads. The arguments a callee writes are found from its PrimFunc in the module, and
+ * all arguments of unknown callees are assumed written. Waves with several calls become a
+ * parallel loop over them, which runs on the TVM thread pool.
+ *
+ * The pass expects the memory of main to be planned already, so that buffers sharing
+ * memory share a variable, and the operators to be serial. An operator that still launches
+ * a parallel job from a task runs that job inline on its own thread.
+ */
+tvm::transform::Pass ParallelizeMainCalls();
+
+}  // namespace aot
+}  // namespace backend
+}  // namespace relay
+}  // namespace tvm
+
+#endif  // TVM_RELAY_BACKEND_AOT_PARALLELIZE_MAIN_CALLS_H_
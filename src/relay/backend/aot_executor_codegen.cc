@@ -50,6 +50,7 @@
 #include "../op/call/call.h"
 #include "../op/memory/device_copy.h"
 #include "../transforms/device_aware_visitors.h"
+#include "./aot/parallelize_main_calls.h"
 #include "./name_transforms.h"
 #include "./te_compiler.h"
 #include "./utils.h"
@@ -1278,6 +1279,14 @@ class AOTExecutorCodegen : public MixedModeVisitor {
     }
     ret.function_metadata = std::move(function_metadata_);
 
+    // Dispatch the independent operator calls of main in parallel. The operators themselves
+    // were made serial above, so the thread pool runs the calls rather than their loops.
+    if (executor_config->GetAttr<Bool>("parallel-dispatch").value_or(Bool(false))) {
+      CHECK(runtime_config->name == kTvmRuntimeCpp && !enable_usmp)
+          << "parallel-dispatch requires the c++ runtime and does not support USMP";
+      lowered_mod = aot::ParallelizeMainCalls()(lowered_mod);
+    }
+
     // Legalize AOT if needed. This means that all the packed calls
     // need to be wrapped in TVMValues (unless unpacked_api is set)
     if (call_type_ == CallType::kCPacked || call_type_ == CallType::kPacked) {
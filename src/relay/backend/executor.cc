@@ -93,7 +93,8 @@ TVM_REGISTER_EXECUTOR("aot")
     .add_attr_option<runtime::Bool>("unpacked-api")
     .add_attr_option<String>("interface-api")
     .add_attr_option<runtime::Int>("workspace-byte-alignment")
-    .add_attr_option<runtime::Int>("constant-byte-alignment");
+    .add_attr_option<runtime::Int>("constant-byte-alignment")
+    .add_attr_option<runtime::Bool>("parallel-dispatch");
 
 TVM_REGISTER_EXECUTOR("graph").add_attr_option<runtime::Bool>("link-params", runtime::Bool(false));
 
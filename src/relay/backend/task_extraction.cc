@@ -18,6 +18,7 @@
  */
 #include <tvm/ir/name_supply.h>
 #include <tvm/meta_schedule/extracted_task.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/function.h>
@@ -59,6 +60,8 @@ Array<meta_schedule::ExtractedTask> ExtractTask(IRModule mod, Target target,
   using meta_schedule::ExtractedTask;
   using meta_schedule::ModuleEqual;
   using meta_schedule::ModuleHash;
+  // The lowered functions are hashed repeatedly when deduplicating the tasks.
+  With<StructuralHashCache> hash_cache;
   backend::BindParamsInModule(mod, params);
   // is_vm=true for backward compatibility
   Array<Pass> pass_seqs = relay::backend::GetPassPrefix(/*is_homogenous=*/true, /*is_vm=*/true);
@@ -93,6 +93,7 @@
 #include <tvm/ir/attrs.h>
 #include <tvm/ir/function.h>
 #include <tvm/ir/name_supply.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/call.h>
@@ -120,6 +121,7 @@
 #include "../op/memory/device_copy.h"
 #include "../transforms/device_aware_visitors.h"
 #include "./te_compiler_cache.h"
+#include "./te_compiler_persistent_cache.h"
 #include "./utils.h"
 
 namespace tvm {
@@ -386,6 +388,11 @@ class TECompilerImpl : public TECompilerNode {
       return value;
     }
 
+    if (Optional<CachedFunc> cached_func = LookupPersistentCache(key, global_var_supply)) {
+      value->cached_func = cached_func.value();
+      return value;
+    }
+
     // Enforce use the target.
     With<Target> target_scope(key->target);
 
@@ -465,6 +472,7 @@ class TECompilerImpl : public TECompilerNode {
             << "with definitions:" << std::endl
             << PrettyPrint(value->cached_func->funcs);
 
+    UpdatePersistentCache(key, value->cached_func, global_var_supply);
     return value;
   }
 
@@ -1303,6 +1311,9 @@ Map<Target, IRModule> GetPerTargetModules(IRModule mod) {
 Pass LowerTE(String module_name, CompilationConfig complilation_config, ProcessFn process_fn) {
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule module,
                                                                             PassContext ctx) {
+    // Primitive functions are hashed as part of their cache keys, which share subterms such as
+    // constants and types.
+    With<StructuralHashCache> hash_cache;
     return LowerTE(module, module_name, process_fn, complilation_config);
   };
 
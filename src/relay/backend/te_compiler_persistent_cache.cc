@@ -0,0 +1,284 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/te_compiler_persistent_cache.cc
+ * \brief An on-disk cache of lowered primitive functions, shared across builds and processes.
+ *
+ *  Each entry is a file holding the lowered IRModule together with everything it was lowered
+ *  from, in the binary IR serialization format. Entries are written to a temporary file and
+ *  renamed into place, so concurrent builds never observe a partial entry. A hit refreshes
+ *  the modification time of the entry, which the eviction uses as its last use time.
+ */
+#include "./te_compiler_persistent_cache.h"
+
+#include <tvm/ir/transform.h>
+#include <tvm/node/serialization.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/function.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include "../../support/utils.h"
+
+namespace tvm {
+namespace relay {
+namespace tec {
+
+TVM_REGISTER_PASS_CONFIG_OPTION(kPersistentCacheDir, String);
+TVM_REGISTER_PASS_CONFIG_OPTION(kPersistentCacheMaxMB, Integer);
+
+namespace {
+
+/*! \brief The file extension of the cache entries. */
+constexpr const char* kEntryExtension = ".tecache";
+
+/*! \brief The default maximum size of the cache. */
+constexpr int64_t kDefaultMaxMB = 1024;
+
+/*! \brief The config of the current PassContext, without the options of the cache itself. */
+Map<String, ObjectRef> GetLoweringConfig() {
+  Map<String, ObjectRef> config;
+  for (const auto& kv : transform::PassContext::Current()->config) {
+    if (kv.first != kPersistentCacheDir && kv.first != kPersistentCacheMaxMB) {
+      config.Set(kv.first, kv.second);
+    }
+  }
+  return config;
+}
+
+/*!
+ * \brief Get the cache directory configured by the current PassContext, or an empty string if
+ *  the cache is disabled.
+ */
+std::string GetCacheDir() {
+  transform::PassContext ctx = transform::PassContext::Current();
+  std::string dir = ctx->GetConfig<String>(kPersistentCacheDir, String("")).value();
+  if (dir.empty()) return dir;
+#ifdef _WIN32
+  LOG(WARNING) << kPersistentCacheDir << " is not supported on Windows, and is ignored";
+  return "";
+#else
+  // The lowering then depends on tuning records outside of the IR, which are not in the key.
+  if (ctx->GetConfig<Bool>("relay.backend.use_auto_scheduler", Bool(false)).value() ||
+      ctx->GetConfig<Bool>("relay.backend.use_meta_schedule", Bool(false)).value()) {
+    return "";
+  }
+  static const runtime::PackedFunc* fautotvm_enabled =
+      runtime::Registry::Get("relay.backend.is_autotvm_dispatch_enabled");
+  if (fautotvm_enabled != nullptr && static_cast<bool>((*fautotvm_enabled)())) {
+    return "";
+  }
+  // The config is part of the key, so it must be hashable and serializable.
+  if (!tvm::transform::IsHashableConfigValue(GetLoweringConfig())) {
+    return "";
+  }
+  return dir;
+#endif
+}
+
+/*! \brief The parts of the current PassContext which may affect the lowering. */
+Array<ObjectRef> GetContext() {
+  transform::PassContext ctx = transform::PassContext::Current();
+  return {Integer(ctx->opt_level), ctx->required_pass, ctx->disabled_pass, GetLoweringConfig()};
+}
+
+/*! \brief Everything the lowering of a primitive function depends on. */
+struct EntryKey {
+  String version{TVM_VERSION};
+  String target;
+  VirtualDevice virtual_device;
+  Function source_func;
+  Array<ObjectRef> context;
+
+  explicit EntryKey(const CCacheKey& key)
+      : target(key->target->str()),
+        virtual_device(key->virtual_device),
+        source_func(key->source_func),
+        context(GetContext()) {}
+
+  std::string FileName() const {
+    uint64_t hash_value = StructuralHash()(source_func);
+    hash_value = support::HashCombine(hash_value, StructuralHash()(virtual_device));
+    hash_value = support::HashCombine(hash_value, StructuralHash()(context));
+    hash_value = support::HashCombine(hash_value, std::hash<std::string>()(target));
+    hash_value = support::HashCombine(hash_value, std::hash<std::string>()(version));
+    std::ostringstream os;
+    os << std::hex << hash_value << kEntryExtension;
+    return os.str();
+  }
+
+  /*! \brief Whether a loaded entry was stored for this key, rather than a hash collision. */
+  bool Matches(const Map<String, ObjectRef>& entry) const {
+    return Downcast<String>(entry["version"]) == version &&
+           Downcast<String>(entry["target"]) == target &&
+           StructuralEqual()(entry["virtual_device"], virtual_device) &&
+           StructuralEqual()(entry["context"], context) &&
+           StructuralEqual()(entry["source_func"], source_func);
+  }
+};
+
+#ifndef _WIN32
+bool ReadFile(const std::string& path, std::string* data) {
+  std::ifstream fs(path, std::ios::in | std::ios::binary);
+  if (fs.fail()) return false;
+  std::ostringstream os;
+  os << fs.rdbuf();
+  *data = os.str();
+  return !fs.bad();
+}
+
+/*! \brief Evict the least recently used entries until the cache is within its size limit. */
+void EvictEntries(const std::string& dir, int64_t max_bytes) {
+  std::vector<std::tuple<time_t, int64_t, std::string>> entries;
+  int64_t total_bytes = 0;
+  if (DIR* d = opendir(dir.c_str())) {
+    while (struct dirent* ent = readdir(d)) {
+      std::string name = ent->d_name;
+      if (!support::EndsWith(name, kEntryExtension)) continue;
+      std::string path = dir + "/" + name;
+      struct stat st;
+      // Entries may be removed concurrently by other builds.
+      if (stat(path.c_str(), &st) != 0) continue;
+      entries.emplace_back(st.st_mtime, st.st_size, path);
+      total_bytes += st.st_size;
+    }
+    closedir(d);
+  }
+  std::sort(entries.begin(), entries.end());
+  for (const auto& [mtime, bytes, path] : entries) {
+    if (total_bytes <= max_bytes) break;
+    std::remove(path.c_str());
+    total_bytes -= bytes;
+  }
+}
+#endif
+
+/*! \brief The name of a lowered function without the prefix and suffix of its supply. */
+std::string GetBaseName(const std::string& name, const GlobalVarSupply& global_var_supply) {
+  std::string base_name = name;
+  const std::string& prefix = global_var_supply->name_supply_->prefix_;
+  if (!prefix.empty() && support::StartsWith(base_name, (prefix + "_").c_str())) {
+    base_name = base_name.substr(prefix.size() + 1);
+  }
+  // Strip the suffix that makes the name unique, a fresh one is added on a hit.
+  size_t pos = base_name.find_last_not_of("0123456789");
+  if (pos != std::string::npos && pos + 1 < base_name.size() && base_name[pos] == '_') {
+    base_name = base_name.substr(0, pos);
+  }
+  return base_name;
+}
+
+}  // namespace
+
+Optional<CachedFunc> LookupPersistentCache(const CCacheKey& key,
+                                           const GlobalVarSupply& global_var_supply) {
+#ifndef _WIN32
+  std::string dir = GetCacheDir();
+  if (dir.empty()) return NullOpt;
+  EntryKey entry_key(key);
+  std::string path = dir + "/" + entry_key.FileName();
+  std::string data;
+  if (!ReadFile(path, &data)) return NullOpt;
+  Map<String, ObjectRef> entry;
+  try {
+    entry = Downcast<Map<String, ObjectRef>>(LoadBinary(data));
+  } catch (const Error& e) {
+    LOG(WARNING) << "Removing the invalid persistent cache entry " << path << ": " << e.what();
+    std::remove(path.c_str());
+    return NullOpt;
+  }
+  if (!entry_key.Matches(entry)) return NullOpt;
+  // Mark the entry as recently used.
+  utime(path.c_str(), nullptr);
+
+  IRModule funcs = Downcast<IRModule>(entry["funcs"]);
+  ICHECK_EQ(funcs->functions.size(), 1U);
+  GlobalVar prim_fn_var = global_var_supply->FreshGlobal(Downcast<String>(entry["name"]));
+  prim_fn_var->checked_type_ = key->source_func->checked_type();
+  tir::PrimFunc func = Downcast<tir::PrimFunc>((*funcs->functions.begin()).second);
+  funcs.CopyOnWrite()->Remove((*funcs->functions.begin()).first);
+  funcs->Add(prim_fn_var, WithAttr(func, tvm::attr::kGlobalSymbol, prim_fn_var->name_hint));
+  VLOG(1) << "loaded " << prim_fn_var->name_hint << " from the persistent cache " << path;
+  return CachedFunc(key->target, prim_fn_var, {}, {}, te::Schedule{nullptr},
+                    tir::PrimFunc{nullptr}, {}, funcs);
+#else
+  return NullOpt;
+#endif
+}
+
+void UpdatePersistentCache(const CCacheKey& key, const CachedFunc& cached_func,
+                           const GlobalVarSupply& global_var_supply) {
+#ifndef _WIN32
+  std::string dir = GetCacheDir();
+  // Only single functions can be renamed on a hit.
+  if (dir.empty() || cached_func->funcs->functions.size() != 1) return;
+  EntryKey entry_key(key);
+  Map<String, ObjectRef> entry{
+      {"version", entry_key.version},
+      {"target", entry_key.target},
+      {"virtual_device", entry_key.virtual_device},
+      {"context", entry_key.context},
+      {"source_func", entry_key.source_func},
+      {"name", String(GetBaseName(cached_func->prim_fn_var->name_hint, global_var_supply))},
+      {"funcs", cached_func->funcs},
+  };
+  std::string data = SaveBinary(entry);
+
+  mkdir(dir.c_str(), 0755);
+  std::string path = dir + "/" + entry_key.FileName();
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid() << "." << std::this_thread::get_id();
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (fs.fail()) {
+      LOG(WARNING) << "Cannot write the persistent cache entry " << tmp_path.str();
+      return;
+    }
+    fs.write(data.data(), data.size());
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+    return;
+  }
+  transform::PassContext ctx = transform::PassContext::Current();
+  int64_t max_mb =
+      ctx->GetConfig<Integer>(kPersistentCacheMaxMB, Integer(kDefaultMaxMB)).value()->value;
+  EvictEntries(dir, max_mb << 20);
+#endif
+}
+
+}  // namespace tec
+}  // namespace relay
+}  // namespace tvm
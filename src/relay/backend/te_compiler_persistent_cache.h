@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/te_compiler_persistent_cache.h
+ * \brief An on-disk cache of lowered primitive functions, shared across builds and processes.
+ */
+#ifndef TVM_RELAY_BACKEND_TE_COMPILER_PERSISTENT_CACHE_H_
+#define TVM_RELAY_BACKEND_TE_COMPILER_PERSISTENT_CACHE_H_
+
+#include <tvm/ir/global_var_supply.h>
+
+#include "./te_compiler_cache.h"
+
+namespace tvm {
+namespace relay {
+namespace tec {
+
+/*! \brief The pass config option for the directory of the persistent cache, which enables it. */
+constexpr const char* kPersistentCacheDir = "relay.backend.persistent_cache_dir";
+/*! \brief The pass config option for the maximum size of the persistent cache in megabytes. */
+constexpr const char* kPersistentCacheMaxMB = "relay.backend.persistent_cache_max_mb";
+
+/*!
+ * \brief Look up the lowered functions of a primitive function in the persistent cache
+ *  configured by the current PassContext.
+ *
+ *  Entries are keyed by the structural hash of the primitive function, the target, the
+ *  virtual device, the pass context and the TVM version, and are checked against all of
+ *  them on load. The cache is disabled when the lowering depends on tuning records or on
+ *  config values which cannot be hashed. On a hit, the lowered function is renamed to a fresh
+ *  name from \p global_var_supply.
+ *
+ * \param key The cache key of the primitive function.
+ * \param global_var_supply The supply of the global var of the lowered function.
+ * \return The lowered function, which only holds the lowered IRModule, or nullopt on a miss or
+ *  if the persistent cache is disabled.
+ */
+Optional<CachedFunc> LookupPersistentCache(const CCacheKey& key,
+                                           const GlobalVarSupply& global_var_supply);
+
+/*!
+ * \brief Store the lowered functions of a primitive function in the persistent cache configured
+ *  by the current PassContext, evicting the least recently used entries beyond its size limit.
+ * \param key The cache key of the primitive function.
+ * \param cached_func The lowered function.
+ * \param global_var_supply The supply the global var of the lowered function was taken from.
+ */
+void UpdatePersistentCache(const CCacheKey& key, const CachedFunc& cached_func,
+                           const GlobalVarSupply& global_var_supply);
+
+}  // namespace tec
+}  // namespace relay
+}  // namespace tvm
+
+#endif  // TVM_RELAY_BACKEND_TE_COMPILER_PERSISTENT_CACHE_H_
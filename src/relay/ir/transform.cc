@@ -125,12 +125,15 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   VLOG(1) << "Input module:" << std::endl << PrettyPrint(mod);
 
   IRModule updated_mod = mod->ShallowCopy();
+  tvm::transform::FunctionPassMemo memo(pass_info, mod, pass_ctx);
 
   std::vector<std::pair<GlobalVar, Function>> updates;
   for (const auto& kv : mod->functions) {
     // only process optimizable Relay Functions
     if (const auto* function_node = AsOptimizableFunctionNode(kv.second)) {
-      Function updated_func = pass_func(GetRef<Function>(function_node), updated_mod, pass_ctx);
+      Function updated_func = memo.Apply(GetRef<Function>(function_node), [&](Function func) {
+        return pass_func(std::move(func), updated_mod, pass_ctx);
+      });
       updates.push_back({kv.first, std::move(updated_func)});
     }
   }
@@ -154,8 +157,9 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
 
 Pass CreateFunctionPass(
     const runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable) {
-  PassInfo pass_info = PassInfo(opt_level, name, required, traceable);
+    int opt_level, String name, tvm::Array<String> required, bool traceable,
+    Optional<Array<ObjectRef>> memo_key) {
+  PassInfo pass_info = PassInfo(opt_level, name, required, traceable, std::move(memo_key));
   return FunctionPass(pass_func, pass_info);
 }
 
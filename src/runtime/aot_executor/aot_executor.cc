@@ -91,6 +91,14 @@ AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>&
       args_.emplace_back(NDArray::Empty({pool_len}, DataType::UInt(8), devices_[0]));
     }
   }
+
+  // The arguments are fixed from here on, so the call arguments are only built once.
+  for (const NDArray& arg : args_) {
+    TVMValue value;
+    value.v_handle = const_cast<DLTensor*>(arg.operator->());
+    call_values_.push_back(value);
+    call_type_codes_.push_back(kTVMDLTensorHandle);
+  }
 }
 
 PackedFunc AotExecutor::GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) {
@@ -164,23 +172,17 @@ PackedFunc AotExecutor::GetFunction(const String& name, const ObjectPtr<Object>&
 }
 
 void AotExecutor::Run() {
-  auto pf = module_.GetFunction(
-      get_name_mangled(metadata_->mod_name(), ::tvm::runtime::symbol::tvm_module_main),
-      true /* query_imports */);
-  ICHECK(pf != nullptr) << "Module entrypoint is not defined";
-
-  const int num_args = args_.size();
-  auto call_values = ::std::make_unique<TVMValue[]>(num_args);
-  auto call_type_codes = ::std::make_unique<int[]>(num_args);
-  for (int i = 0; i < num_args; ++i) {
-    auto managed = args_[i].ToDLPack();
-    call_values.get()[i].v_handle = &managed->dl_tensor;
-    call_type_codes.get()[i] = kTVMDLTensorHandle;
+  if (run_func_ == nullptr) {
+    run_func_ = module_.GetFunction(
+        get_name_mangled(metadata_->mod_name(), ::tvm::runtime::symbol::tvm_module_main),
+        true /* query_imports */);
+    ICHECK(run_func_ != nullptr) << "Module entrypoint is not defined";
   }
 
-  TVMArgs args{call_values.get(), call_type_codes.get(), num_args};
+  TVMArgs args{call_values_.data(), call_type_codes_.data(),
+               static_cast<int>(call_values_.size())};
   TVMRetValue rv;
-  pf.CallPacked(args, &rv);
+  run_func_.CallPacked(args, &rv);
 }
 
 int AotExecutor::GetInputIndex(const std::string& name) {
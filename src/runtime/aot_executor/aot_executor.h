@@ -149,6 +149,15 @@ class TVM_DLL AotExecutor : public ModuleNode {
 
   /*! \brief Holds one NDArray per function argument in the same order. */
   std::vector<NDArray> args_;
+
+  /*! \brief The arguments of the AOT top-level function, pointing into args_. */
+  std::vector<TVMValue> call_values_;
+
+  /*! \brief The type codes of call_values_. */
+  std::vector<int> call_type_codes_;
+
+  /*! \brief The AOT top-level function, looked up on the first run. */
+  PackedFunc run_func_;
 };
 
 }  // namespace runtime
@@ -0,0 +1,309 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file perf_event.cc
+ * \brief A metric collector for the hardware performance counters of the CPU, through the
+ *  Linux perf_event_open system call.
+ */
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <tvm/runtime/contrib/perf_event.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief A counter that can be collected, named after the `perf` tool. */
+struct PerfEventKind {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+static constexpr uint64_t PerfCacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+static const PerfEventKind kPerfEventKinds[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"ref-cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES},
+    {"stalled-cycles-frontend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND},
+    {"stalled-cycles-backend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+    {"L1-dcache-load-misses", PERF_TYPE_HW_CACHE,
+     PerfCacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                     PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"LLC-load-misses", PERF_TYPE_HW_CACHE,
+     PerfCacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                     PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"dTLB-load-misses", PERF_TYPE_HW_CACHE,
+     PerfCacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                     PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+static const std::vector<std::string> kDefaultPerfEventNames = {"cycles", "instructions",
+                                                                "cache-misses", "branch-misses"};
+
+/*! \brief A reading of a counter, with the times to scale it by when it is multiplexed. */
+struct PerfEventReading {
+  uint64_t value;
+  uint64_t time_enabled;
+  uint64_t time_running;
+};
+
+/*! \brief Object that holds the values of counters at the start of a function call. */
+struct PerfEventReadingsNode : public Object {
+  /*! \brief The readings of the counters at the start of the call. */
+  std::vector<PerfEventReading> start_readings;
+
+  explicit PerfEventReadingsNode(std::vector<PerfEventReading> start_readings)
+      : start_readings(std::move(start_readings)) {}
+
+  static constexpr const char* _type_key = "PerfEventReadingsNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PerfEventReadingsNode, Object);
+};
+
+/*! \brief MetricCollectorNode for the hardware performance counters of the CPU.
+ *
+ * Unlike the PAPI collector, it needs no extra library, but only collects on the CPU. The
+ * counters count the current thread and the threads it creates afterwards, so the thread
+ * pool is restarted once they are opened.
+ */
+struct PerfEventMetricCollectorNode final : public MetricCollectorNode {
+  /*! \brief Construct a metric collector that collects a specific set of counters.
+   *
+   * \param metrics The names of the counters, or empty for the default set.
+   */
+  explicit PerfEventMetricCollectorNode(Array<String> metrics) {
+    if (metrics.empty()) {
+      requested_names = kDefaultPerfEventNames;
+    }
+    for (const String& metric : metrics) {
+      requested_names.push_back(metric);
+    }
+    for (const std::string& name : requested_names) {
+      CHECK(FindKind(name) != nullptr) << "ValueError: Unknown perf event \"" << name
+                                       << "\". The supported events are: " << SupportedNames();
+    }
+  }
+
+  ~PerfEventMetricCollectorNode() final {
+    for (int fd : fds) {
+      close(fd);
+    }
+  }
+
+  /*! \brief Initialization call. Opens the counters if the CPU is profiled.
+   * \param devices The devices this collector will be running on
+   */
+  void Init(Array<DeviceWrapper> devices) final {
+    if (initialized) return;
+    bool has_cpu = false;
+    for (const DeviceWrapper& device : devices) {
+      has_cpu |= device->device.device_type == kDLCPU;
+    }
+    if (!has_cpu) return;
+    initialized = true;
+    for (const std::string& name : requested_names) {
+      const PerfEventKind* kind = FindKind(name);
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = kind->type;
+      attr.config = kind->config;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      attr.inherit = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      // Because we may have multiple calls in flight at the same time, the counters run
+      // from now on, and a call is measured by the difference of the readings around it.
+      int fd = static_cast<int>(
+          syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+      if (fd < 0) {
+        LOG(WARNING) << "Cannot open the perf event \"" << name << "\": " << strerror(errno)
+                     << ". Try setting `sudo sh -c 'echo 1 >/proc/sys/kernel/perf_event_paranoid'`"
+                     << ", or the CPU may not support this counter.";
+        continue;
+      }
+      fds.push_back(fd);
+      names.push_back(name);
+    }
+    if (!fds.empty()) {
+      // Restart the thread pool, so that its threads inherit the counters.
+      threading::ResetThreadPool();
+    }
+  }
+
+  /*! \brief Called right before a function call. Reads the starting values of the counters.
+   *
+   * \param dev The device the function will be run on.
+   * \returns A `PerfEventReadingsNode` passed to the corresponding `Stop` call, or nullptr if
+   * the device is not the CPU.
+   */
+  ObjectRef Start(Device dev) final {
+    if (dev.device_type != kDLCPU || fds.empty()) {
+      return ObjectRef(nullptr);
+    }
+    return ObjectRef(make_object<PerfEventReadingsNode>(ReadAll()));
+  }
+
+  /*! \brief Called right after a function call. Computes the change of each counter from the
+   * corresponding `Start` call, scaled up if the kernel multiplexed the counter.
+   *
+   * \param obj `PerfEventReadingsNode` created by a call to `Start`.
+   * \returns A mapping from metric name to value.
+   */
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    const PerfEventReadingsNode* start = obj.as<PerfEventReadingsNode>();
+    ICHECK(start != nullptr);
+    std::vector<PerfEventReading> end_readings = ReadAll();
+    Map<String, ObjectRef> reported_metrics;
+    int64_t cycles = -1;
+    int64_t instructions = -1;
+    for (size_t i = 0; i < fds.size(); ++i) {
+      const PerfEventReading& begin = start->start_readings[i];
+      const PerfEventReading& end = end_readings[i];
+      uint64_t enabled = end.time_enabled - begin.time_enabled;
+      uint64_t running = end.time_running - begin.time_running;
+      int64_t count = -1;
+      if (running > 0) {
+        double value = static_cast<double>(end.value - begin.value);
+        count = static_cast<int64_t>(value * enabled / running + 0.5);
+      } else if (enabled == 0) {
+        count = 0;
+      }
+      // A count of -1 means that the kernel never scheduled the counter during the call.
+      reported_metrics.Set(names[i], ObjectRef(make_object<CountNode>(count)));
+      if (names[i] == "cycles") cycles = count;
+      if (names[i] == "instructions") instructions = count;
+    }
+    if (cycles > 0 && instructions >= 0) {
+      reported_metrics.Set("IPC", ObjectRef(make_object<RatioNode>(
+                                      static_cast<double>(instructions) / cycles)));
+    }
+    return reported_metrics;
+  }
+
+  /*! \brief The names of the requested counters. */
+  std::vector<std::string> requested_names;
+  /*! \brief The names of the counters that were opened. */
+  std::vector<std::string> names;
+  /*! \brief The file descriptors of the opened counters, in the order of `names`. */
+  std::vector<int> fds;
+  /*! \brief Whether the counters have been opened. */
+  bool initialized = false;
+
+  static constexpr const char* _type_key = "runtime.profiling.PerfEventMetricCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PerfEventMetricCollectorNode, MetricCollectorNode);
+
+ private:
+  static const PerfEventKind* FindKind(const std::string& name) {
+    for (const PerfEventKind& kind : kPerfEventKinds) {
+      if (name == kind.name) return &kind;
+    }
+    return nullptr;
+  }
+
+  static std::string SupportedNames() {
+    std::string result;
+    for (const PerfEventKind& kind : kPerfEventKinds) {
+      result += (result.empty() ? "" : ", ") + std::string(kind.name);
+    }
+    return result;
+  }
+
+  std::vector<PerfEventReading> ReadAll() const {
+    std::vector<PerfEventReading> readings(fds.size());
+    for (size_t i = 0; i < fds.size(); ++i) {
+      ssize_t nbytes = read(fds[i], &readings[i], sizeof(PerfEventReading));
+      CHECK_EQ(nbytes, static_cast<ssize_t>(sizeof(PerfEventReading)))
+          << "Cannot read the perf event \"" << names[i] << "\": " << strerror(errno);
+    }
+    return readings;
+  }
+};
+
+/*! \brief Wrapper for `PerfEventMetricCollectorNode`. */
+class PerfEventMetricCollector : public MetricCollector {
+ public:
+  explicit PerfEventMetricCollector(Array<String> metrics) {
+    data_ = make_object<PerfEventMetricCollectorNode>(metrics);
+  }
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PerfEventMetricCollector, MetricCollector,
+                                        PerfEventMetricCollectorNode);
+};
+
+MetricCollector CreatePerfEventMetricCollector(Array<String> metrics) {
+  return PerfEventMetricCollector(metrics);
+}
+
+TVM_REGISTER_OBJECT_TYPE(PerfEventReadingsNode);
+TVM_REGISTER_OBJECT_TYPE(PerfEventMetricCollectorNode);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.PerfEventMetricCollector")
+    .set_body_typed([](Array<String> metrics) { return PerfEventMetricCollector(metrics); });
+
+// The metric collectors and the metrics cannot be sent over RPC, so the counters of a remote
+// function are collected on the remote side and returned as a JSON object.
+TVM_REGISTER_GLOBAL("runtime.profiling.ProfileFunctionPerfEvents")
+    .set_body_typed([](Module mod, String func_name, Device dev, int warmup_iters) {
+      PackedFunc profile =
+          ProfileFunction(mod, func_name, dev.device_type, dev.device_id, warmup_iters,
+                          {PerfEventMetricCollector(Array<String>())});
+      return PackedFunc([profile](TVMArgs args, TVMRetValue* rv) {
+        TVMRetValue metrics_rv;
+        profile.CallPacked(args, &metrics_rv);
+        Map<String, ObjectRef> metrics = metrics_rv;
+        std::ostringstream os;
+        os.precision(17);
+        os << "{";
+        bool first = true;
+        for (const auto& kv : metrics) {
+          os << (first ? "" : ", ") << "\"" << kv.first << "\": ";
+          if (const auto* ratio = kv.second.as<RatioNode>()) {
+            os << ratio->ratio;
+          } else {
+            const auto* count = kv.second.as<CountNode>();
+            ICHECK(count != nullptr) << "Unexpected metric " << kv.second->GetTypeKey();
+            os << count->value;
+          }
+          first = false;
+        }
+        os << "}";
+        *rv = os.str();
+      });
+    });
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -19,7 +19,7 @@
 
 /*!
  * \file random/mt_random_engine.cc
- * \brief mt19937 random engine
+ * \brief Counter-based random engine
  */
 #include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/device_api.h>
@@ -28,8 +28,8 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cmath>
 #include <ctime>
-#include <random>
 #include <thread>
 
 #include "../3rdparty/compiler-rt/builtin_fp16.h"
@@ -37,8 +37,74 @@
 namespace tvm {
 namespace contrib {
 
+/*!
+ * \brief The Philox4x32-10 counter-based generator.
+ * Each 64-bit counter is mapped to a block of four independent 32-bit
+ * random words under the key, so any part of the random stream can be
+ * generated without producing the parts before it.
+ *
+ * Reference: Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11.
+ */
+class Philox4x32 {
+ public:
+  /*! \brief The number of random words in one block. */
+  static constexpr int kWordsPerBlock = 4;
+  /*! \brief The number of blocks generated together, which are vectorized by the compiler. */
+  static constexpr int kLanes = 8;
+
+  /*!
+   * \brief Generate the blocks for the counters `[counter, counter + kLanes)`.
+   * \param key The key of the generator.
+   * \param counter The first counter.
+   * \param words The output words, where `words[w * kLanes + l]` is the w-th word of lane l.
+   */
+  static void GenerateLanes(const uint32_t key[2], uint64_t counter, uint32_t* words) {
+    uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+    for (int l = 0; l < kLanes; ++l) {
+      c0[l] = static_cast<uint32_t>(counter + l);
+      c1[l] = static_cast<uint32_t>((counter + l) >> 32);
+      c2[l] = 0;
+      c3[l] = 0;
+    }
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        k0 += kWeyl0;
+        k1 += kWeyl1;
+      }
+      for (int l = 0; l < kLanes; ++l) {
+        uint64_t p0 = static_cast<uint64_t>(kMultiplier0) * c0[l];
+        uint64_t p1 = static_cast<uint64_t>(kMultiplier1) * c2[l];
+        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+        c1[l] = static_cast<uint32_t>(p1);
+        c3[l] = static_cast<uint32_t>(p0);
+        c0[l] = n0;
+        c2[l] = n2;
+      }
+    }
+    for (int l = 0; l < kLanes; ++l) {
+      words[0 * kLanes + l] = c0[l];
+      words[1 * kLanes + l] = c1[l];
+      words[2 * kLanes + l] = c2[l];
+      words[3 * kLanes + l] = c3[l];
+    }
+  }
+
+ private:
+  static constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  static constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+};
+
 /*!
  * \brief An interface for generating [tensors of] random numbers.
+ *
+ * The engine draws from a Philox stream keyed by the seed. Element `i` of a
+ * filled tensor only depends on the seed, the position of the stream and `i`,
+ * so that the tensors are filled in parallel with deterministic results
+ * regardless of the number of threads.
  */
 class RandomEngine {
  public:
@@ -56,7 +122,9 @@ class RandomEngine {
    * \brief Seeds the underlying RNG, if possible.
    */
   inline void Seed(unsigned seed) {
-    rnd_engine_.seed(seed);
+    key_[0] = static_cast<uint32_t>(seed);
+    key_[1] = 0;
+    counter_ = 0;
     this->rseed_ = static_cast<unsigned>(seed);
   }
 
@@ -66,9 +134,18 @@ class RandomEngine {
   inline unsigned GetSeed() const { return rseed_; }
 
   /*!
-   * \return a random integer sampled from the RNG.
+   * \brief Invoke `fvisit(i, word)` for each `i` in `[0, size)` in parallel,
+   * where `word` is the i-th 32-bit word of the random stream. The stream
+   * then advances past the consumed words.
    */
-  inline unsigned GetRandInt() { return rnd_engine_(); }
+  template <typename FVisit>
+  void ForEachRandomWord(int64_t size, FVisit fvisit) {
+    ForEachRandomBlock(size, [&](int64_t begin, int64_t end, const uint32_t* words) {
+      for (int64_t i = begin; i < end; ++i) {
+        fvisit(i, words[i - begin]);
+      }
+    });
+  }
 
   /*!
    * \brief Fills a tensor with values drawn from Unif(low, high)
@@ -86,9 +163,12 @@ class RandomEngine {
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::uniform_real_distribution<float> uniform_dist(low, high);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return uniform_dist(rnd_engine_); });
+      float* ptr = static_cast<float*>(data->data);
+      float range = high - low;
+      ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        // Clamp to guard against rounding up to `high`.
+        ptr[i] = std::min(low + ToUnitFloat(word) * range, std::nextafter(high, low));
+      });
     } else {
       LOG(FATAL) << "Do not support random.uniform on this device yet";
     }
@@ -110,9 +190,21 @@ class RandomEngine {
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::normal_distribution<float> normal_dist(loc, scale);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return normal_dist(rnd_engine_); });
+      float* ptr = static_cast<float*>(data->data);
+      // Box-Muller transform, which maps each pair of words to a pair of normal samples.
+      ForEachRandomBlock(size, [&](int64_t begin, int64_t end, const uint32_t* words) {
+        for (int64_t i = begin; i < end; i += 2) {
+          // Shift u1 into (0, 1] to keep the logarithm finite.
+          float u1 = 1.0f - ToUnitFloat(words[i - begin]);
+          float u2 = ToUnitFloat(words[i - begin + 1]);
+          float radius = scale * std::sqrt(-2.0f * std::log(u1));
+          float theta = 6.28318530717958647692f * u2;
+          ptr[i] = loc + radius * std::cos(theta);
+          if (i + 1 < end) {
+            ptr[i + 1] = loc + radius * std::sin(theta);
+          }
+        }
+      });
     } else {
       LOG(FATAL) << "Do not support random.normal on this device yet";
     }
@@ -131,103 +223,111 @@ class RandomEngine {
   }
 
   void RandomFillForMeasure(DLTensor* data) {
-    if (data->device.device_type == kDLCPU) {
-      FillDataForMeasure(data);
+    // The filling is always parallel, so random fill for measure shares the same path.
+    RandomFill(data);
+  }
+
+ private:
+  /*! \brief The minimum number of blocks generated by each parallel task. */
+  static constexpr int64_t kMinBlocksPerTask = 4096;
+
+  /*! \brief Map a random word to a float in [0, 1) with 24 random bits. */
+  static float ToUnitFloat(uint32_t word) {
+    return static_cast<float>(word >> 8) * (1.0f / static_cast<float>(1 << 24));
+  }
+
+  /*!
+   * \brief Generate the random words for the element range `[0, size)` in parallel.
+   * The range is split into pieces aligned to whole blocks, and `fpiece(begin, end, words)`
+   * is invoked for each piece, where `words[i - begin]` is the random word of element `i`.
+   * An even `begin` is guaranteed for each piece. The stream then advances past the
+   * consumed blocks.
+   */
+  template <typename FPiece>
+  void ForEachRandomBlock(int64_t size, FPiece fpiece) {
+    constexpr int64_t kWordsPerPiece = Philox4x32::kWordsPerBlock * Philox4x32::kLanes;
+    int64_t num_pieces = (size + kWordsPerPiece - 1) / kWordsPerPiece;
+    uint64_t base_counter = counter_;
+    const uint32_t* key = key_;
+    auto frange = [&](int64_t piece_begin, int64_t piece_end) {
+      uint32_t lane_words[kWordsPerPiece];
+      uint32_t words[kWordsPerPiece];
+      for (int64_t piece = piece_begin; piece < piece_end; ++piece) {
+        Philox4x32::GenerateLanes(key, base_counter + piece * Philox4x32::kLanes, lane_words);
+        // Transpose to the element order, in which element `w + 4 * l` takes word w of lane l.
+        for (int l = 0; l < Philox4x32::kLanes; ++l) {
+          for (int w = 0; w < Philox4x32::kWordsPerBlock; ++w) {
+            words[l * Philox4x32::kWordsPerBlock + w] = lane_words[w * Philox4x32::kLanes + l];
+          }
+        }
+        int64_t begin = piece * kWordsPerPiece;
+        fpiece(begin, std::min(begin + kWordsPerPiece, size), words);
+      }
+    };
+
+    int64_t num_tasks = std::min<int64_t>(
+        runtime::threading::MaxConcurrency(),
+        (num_pieces * Philox4x32::kLanes + kMinBlocksPerTask - 1) / kMinBlocksPerTask);
+    if (num_tasks <= 1) {
+      frange(0, num_pieces);
     } else {
-      runtime::NDArray local = runtime::NDArray::Empty(
-          std::vector<int64_t>{data->shape, data->shape + data->ndim}, data->dtype, {kDLCPU, 0});
-      DLTensor* tensor = const_cast<DLTensor*>(local.operator->());
-      FillDataForMeasure(tensor);
-      runtime::NDArray::CopyFromTo(tensor, data);
+      runtime::parallel_for_with_threading_backend(
+          [&](int64_t task) {
+            frange(num_pieces * task / num_tasks, num_pieces * (task + 1) / num_tasks);
+          },
+          0, num_tasks);
     }
+    counter_ += static_cast<uint64_t>(num_pieces) * Philox4x32::kLanes;
   }
 
- private:
-  void FillDataImpl(void* data, int64_t st, int64_t ed, DLDataType dtype) {
+  void FillData(DLTensor* tensor) {
+    int64_t size = 1;
+    for (int i = 0; i < tensor->ndim; ++i) {
+      size *= tensor->shape[i];
+    }
+    DLDataType dtype = tensor->dtype;
+    void* data = tensor->data;
     // Make the value be 1.0 - 10.0, not (0.0 - 1.0) so that we could satisfy
     // quantized dtype (uint8 / int8) data non-empty requirement
-    std::uniform_real_distribution<> dist(1.0, 10.0);
+    auto dist = [](uint32_t word) { return 1.0f + 9.0f * ToUnitFloat(word); };
     // Use float representation could make us work well on float / int type too.
     if (dtype.bits == 1) {
-      std::generate_n(static_cast<bool*>(data) + st, ed - st, [&]() { return dist(rnd_engine_); });
+      ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        static_cast<bool*>(data)[i] = dist(word);
+      });
     } else if (dtype.bits == 4) {
       // For uint4/int4 we pack two values into a single byte.
       // Thus, to ensure both values are non-zero, we use a distribution of 17 - 30.
-      std::uniform_real_distribution<> packed_dist(17.0, 30.0);
-      std::generate_n(reinterpret_cast<uint8_t*>(data) + st, ed - st,
-                      [&]() { return packed_dist(rnd_engine_); });
+      ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        static_cast<uint8_t*>(data)[i] = 17.0f + 13.0f * ToUnitFloat(word);
+      });
     } else if (dtype.bits == 8) {
-      std::generate_n(static_cast<uint8_t*>(data) + st, ed - st,
-                      [&]() { return dist(rnd_engine_); });
+      ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        static_cast<uint8_t*>(data)[i] = dist(word);
+      });
     } else if (dtype.bits == 16) {
-      std::generate_n(static_cast<uint16_t*>(data) + st, ed - st, [&]() {
-        return __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(
-            static_cast<float>(dist(rnd_engine_)));
+      ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        static_cast<uint16_t*>(data)[i] =
+            __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(dist(word));
       });
     } else if (dtype.bits == 32) {
-      std::generate_n(static_cast<float*>(data) + st, ed - st, [&]() { return dist(rnd_engine_); });
+      ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        static_cast<float*>(data)[i] = dist(word);
+      });
     } else if (dtype.bits == 64) {
-      std::generate_n(static_cast<double*>(data) + st, ed - st,
-                      [&]() { return dist(rnd_engine_); });
-    } else {
-      LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
-    }
-  }
-
-  void FillData(DLTensor* tensor) {
-    int64_t size = 1;
-    for (int i = 0; i < tensor->ndim; ++i) {
-      size *= tensor->shape[i];
-    }
-    DLDataType dtype = tensor->dtype;
-    if (dtype.bits == 1 || dtype.bits == 4 || dtype.bits == 8 || dtype.bits == 16 ||
-        dtype.bits == 32 || dtype.bits == 64) {
-      FillDataImpl(tensor->data, 0, size, dtype);
-    } else {
-      LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
-    }
-  }
-
-  void FillDataForMeasure(DLTensor* tensor) {
-    struct ParallelTask {
-      static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
-        ParallelTask* task = static_cast<ParallelTask*>(cdata);
-        task->Run(task_id, penv->num_task);
-        return 0;
-      }
-
-      void Run(int i, int num_tasks) {
-        int64_t chunk_size = size / num_tasks;
-        int64_t st = i * chunk_size;
-        int64_t ed = std::min(st + chunk_size, size);
-        self->FillDataImpl(data, st, ed, dtype);
-      }
-
-      RandomEngine* self;
-      void* data;
-      int64_t size;
-      DLDataType dtype;
-    };
-
-    ParallelTask task;
-    task.self = this;
-    task.data = tensor->data;
-    DLDataType dtype = task.dtype = tensor->dtype;
-    int64_t& size = task.size = 1;
-    for (int i = 0; i < tensor->ndim; ++i) {
-      size *= tensor->shape[i];
-    }
-    if (dtype.bits == 1 || dtype.bits == 4 || dtype.bits == 8 || dtype.bits == 16 ||
-        dtype.bits == 32 || dtype.bits == 64) {
-      int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
-      ICHECK_EQ(res, 0) << "RandomFillForMeasure: TVMBackendParallelLaunch failed";
+      ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        static_cast<double*>(data)[i] = dist(word);
+      });
     } else {
       LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
     }
   }
 
  private:
-  std::mt19937 rnd_engine_;
+  /*! \brief The key of the Philox generator. */
+  uint32_t key_[2];
+  /*! \brief The counter of the next block in the random stream. */
+  uint64_t counter_;
   unsigned rseed_;
 };
 
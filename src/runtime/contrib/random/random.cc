@@ -69,6 +69,12 @@ RandomThreadLocalEntry* RandomThreadLocalEntry::ThreadLocal() {
   return RandomThreadLocalStore::Get();
 }
 
+TVM_REGISTER_GLOBAL("tvm.contrib.random.seed").set_body([](TVMArgs args, TVMRetValue* ret) {
+  RandomThreadLocalEntry* entry = RandomThreadLocalEntry::ThreadLocal();
+  int64_t seed = args[0];
+  entry->random_engine.Seed(static_cast<unsigned>(seed));
+});
+
 TVM_REGISTER_GLOBAL("tvm.contrib.random.randint").set_body([](TVMArgs args, TVMRetValue* ret) {
   RandomThreadLocalEntry* entry = RandomThreadLocalEntry::ThreadLocal();
   int64_t low = args[0];
@@ -92,9 +98,10 @@ TVM_REGISTER_GLOBAL("tvm.contrib.random.randint").set_body([](TVMArgs args, TVMR
 
     if (out->device.device_type == kDLCPU) {
       // file the data with random byte
-      std::generate_n(static_cast<DType*>(out->data), size, [&]() {
-        unsigned rint = entry->random_engine.GetRandInt();
-        return low + rint % (high - low);
+      DType* ptr = static_cast<DType*>(out->data);
+      uint64_t range = high - low;
+      entry->random_engine.ForEachRandomWord(size, [&](int64_t i, uint32_t word) {
+        ptr[i] = low + static_cast<int64_t>(word % range);
       });
     } else {
       LOG(FATAL) << "Do not support random.randint on this device yet";
@@ -23,8 +23,11 @@
 
 #include <dlpack/dlpack.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <vector>
 
 #include "../../../../3rdparty/compiler-rt/builtin_fp16.h"
@@ -70,6 +73,157 @@ struct float16 {
   inline bool operator>=(const float16& rhs) const { return to_float() >= rhs.to_float(); }
 };
 
+/*! \brief The minimum number of elements in total to sort the rows in parallel. */
+constexpr int64_t kParallelSortMinElements = 16384;
+/*! \brief The minimum row length to use radix sort instead of comparison sort. */
+constexpr size_t kRadixSortMinLength = 256;
+
+// Invoke fchunk(row_begin, row_end) over chunks of [0, num_rows), in parallel
+// with the TVM thread pool when the total number of elements is large enough.
+// The rows of a chunk are processed by the same task, so that the scratch
+// buffers can be reused across the rows.
+// The web runtime has no thread pool, so the rows are always processed in order there.
+template <typename FChunk>
+void ParallelForRows(int64_t num_rows, int64_t row_length, FChunk fchunk) {
+#ifndef __EMSCRIPTEN__
+  int64_t num_chunks = 1;
+  if (num_rows > 1 && num_rows * row_length >= kParallelSortMinElements) {
+    num_chunks = std::min<int64_t>(num_rows, threading::MaxConcurrency());
+  }
+  if (num_chunks > 1) {
+    parallel_for_with_threading_backend(
+        [&](int64_t chunk) {
+          fchunk(num_rows * chunk / num_chunks, num_rows * (chunk + 1) / num_chunks);
+        },
+        0, num_chunks);
+    return;
+  }
+#endif
+  fchunk(0, num_rows);
+}
+
+// Map the bits of an IEEE floating point number to an unsigned integer with the same order.
+// NaNs, which do not compare with any number, are ordered by their bits: positive NaNs
+// after +inf, and negative NaNs before -inf.
+template <typename UIntType>
+UIntType EncodeFloatBits(UIntType bits) {
+  constexpr UIntType kSignBit = UIntType(1) << (sizeof(UIntType) * 8 - 1);
+  // Negative zero compares equal to positive zero.
+  if (bits == kSignBit) {
+    bits = 0;
+  }
+  return (bits & kSignBit) ? static_cast<UIntType>(~bits) : static_cast<UIntType>(bits | kSignBit);
+}
+
+// The order-preserving encoding of the sort keys for radix sort.
+// Radix sort is enabled only for the types specialized below.
+template <typename DType>
+struct RadixKey {
+  static constexpr bool enabled = false;
+};
+
+template <>
+struct RadixKey<int32_t> {
+  static constexpr bool enabled = true;
+  using UIntType = uint32_t;
+  static UIntType Encode(int32_t value) { return static_cast<UIntType>(value) ^ (1U << 31); }
+};
+
+template <>
+struct RadixKey<int64_t> {
+  static constexpr bool enabled = true;
+  using UIntType = uint64_t;
+  static UIntType Encode(int64_t value) { return static_cast<UIntType>(value) ^ (1ULL << 63); }
+};
+
+template <>
+struct RadixKey<float> {
+  static constexpr bool enabled = true;
+  using UIntType = uint32_t;
+  static UIntType Encode(float value) {
+    UIntType bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return EncodeFloatBits(bits);
+  }
+};
+
+template <>
+struct RadixKey<double> {
+  static constexpr bool enabled = true;
+  using UIntType = uint64_t;
+  static UIntType Encode(double value) {
+    UIntType bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return EncodeFloatBits(bits);
+  }
+};
+
+template <>
+struct RadixKey<float16> {
+  static constexpr bool enabled = true;
+  using UIntType = uint16_t;
+  static UIntType Encode(float16 value) { return EncodeFloatBits(value.bits); }
+};
+
+// Stable LSD radix sort of the (index, value) pairs by value, 8 bits per pass.
+// Since the sort is stable, it produces the same result as std::stable_sort for keys
+// without NaNs.
+template <typename DType>
+void RadixSortPairs(std::vector<std::pair<int64_t, DType>>* sorter,
+                    std::vector<std::pair<int64_t, DType>>* buffer, bool is_ascend) {
+  using UIntType = typename RadixKey<DType>::UIntType;
+  constexpr int kNumPasses = sizeof(UIntType);
+  auto fkey = [is_ascend](const std::pair<int64_t, DType>& item) {
+    UIntType key = RadixKey<DType>::Encode(item.second);
+    return is_ascend ? key : static_cast<UIntType>(~key);
+  };
+
+  size_t n = sorter->size();
+  std::array<std::array<size_t, 256>, kNumPasses> histograms{};
+  for (const auto& item : *sorter) {
+    UIntType key = fkey(item);
+    for (int pass = 0; pass < kNumPasses; ++pass) {
+      ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+    }
+  }
+  buffer->resize(n);
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    std::array<size_t, 256>& offsets = histograms[pass];
+    // Skip the pass when all the keys share the same digit.
+    if (offsets[(fkey(sorter->front()) >> (pass * 8)) & 0xFF] == n) {
+      continue;
+    }
+    size_t offset = 0;
+    for (size_t& count : offsets) {
+      size_t cur_count = count;
+      count = offset;
+      offset += cur_count;
+    }
+    for (const auto& item : *sorter) {
+      (*buffer)[offsets[(fkey(item) >> (pass * 8)) & 0xFF]++] = item;
+    }
+    sorter->swap(*buffer);
+  }
+}
+
+// Stable sort of the (index, value) pairs by value. Long rows of the types
+// supported by RadixKey are sorted with radix sort.
+template <typename DType>
+void StableSortPairs(std::vector<std::pair<int64_t, DType>>* sorter,
+                     std::vector<std::pair<int64_t, DType>>* buffer, bool is_ascend) {
+  if constexpr (RadixKey<DType>::enabled) {
+    if (sorter->size() >= kRadixSortMinLength) {
+      RadixSortPairs(sorter, buffer, is_ascend);
+      return;
+    }
+  }
+  if (is_ascend) {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareAscend<DType>);
+  } else {
+    std::stable_sort(sorter->begin(), sorter->end(), CompareDescend<DType>);
+  }
+}
+
 // Argsort implemented C library sort for nms.
 // Return indices of sorted tensor.
 // By default, the last axis will be used to sort.
@@ -87,7 +241,6 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
   auto dtype = input->dtype;
   auto data_ptr = static_cast<float*>(input->data);
   auto sort_num_ptr = static_cast<int32_t*>(sort_num->data);
-  std::vector<std::pair<int32_t, float>> sorter;
   int64_t axis_mul_before = 1;
   int64_t axis_mul_after = 1;
 
@@ -114,8 +267,13 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
     }
   }
 
-  for (int64_t i = 0; i < axis_mul_before; ++i) {
-    for (int64_t j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(axis_mul_before * axis_mul_after, input->shape[axis], [&](int64_t row_begin,
+                                                                            int64_t row_end) {
+    std::vector<std::pair<int64_t, float>> sorter;
+    std::vector<std::pair<int64_t, float>> buffer;
+    for (int64_t row = row_begin; row < row_end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
       sorter.clear();
       int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
       int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
@@ -123,33 +281,25 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
         int64_t full_idx = base_idx + k * axis_mul_after;
         sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
       }
-      if (is_ascend) {
 #if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
+      if (dtype.bits == 16) {
+        if (is_ascend) {
           std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<__fp16>);
         } else {
-#endif
-          std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<float>);
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
+          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
         }
-#endif
       } else {
-#if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        if (dtype.bits == 16) {
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<__fp16>);
-        } else {
 #endif
-          std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<float>);
+        StableSortPairs(&sorter, &buffer, is_ascend);
 #if (__ARM_FEATURE_FP16_SCALAR_ARITHMETIC == 1)
-        }
-#endif
       }
+#endif
       for (int32_t k = 0; k < input->shape[axis]; ++k) {
         *(static_cast<int32_t*>(output->data) + base_idx + k * axis_mul_after) =
             k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
       }
     }
-  }
+  });
 });
 
 template <typename DataType, typename OutType>
@@ -158,10 +308,9 @@ void sort_impl(
     std::function<void(OutType*, size_t, const std::pair<int64_t, DataType>&)> epilogue) {
   auto data_ptr = static_cast<DataType*>(input->data);
   auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
 
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
       axis_mul_before *= input->shape[i];
@@ -170,24 +319,25 @@ void sort_impl(
     }
   }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(axis_mul_before * axis_mul_after, input->shape[axis], [&](int64_t row_begin,
+                                                                            int64_t row_end) {
+    std::vector<std::pair<int64_t, DataType>> sorter;
+    std::vector<std::pair<int64_t, DataType>> buffer;
+    for (int64_t row = row_begin; row < row_end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
       sorter.clear();
       int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
       for (int64_t k = 0; k < input->shape[axis]; ++k) {
         int64_t full_idx = base_idx + k * axis_mul_after;
         sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
       }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
+      StableSortPairs(&sorter, &buffer, is_ascend);
       for (int64_t k = 0; k < input->shape[axis]; ++k) {
         epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
       }
     }
-  }
+  });
 }
 
 template <typename DataType, typename OutType>
@@ -355,14 +505,8 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
   IndicesType* indices_ptr =
       (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
 
-  // Maintain a min/max containing the top-k elements
-  std::vector<std::pair<int64_t, DataType>> running_heap;
-
-  // Need +1 when inserting new element before maintaining heap invariant
-  running_heap.reserve(k + 1);
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
       axis_mul_before *= input->shape[i];
@@ -370,66 +514,55 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
       axis_mul_after *= input->shape[i];
     }
   }
+  int64_t axis_len = input->shape[axis];
   if (k < 1) {
-    k = input->shape[axis];
+    k = axis_len;
   }
-
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      running_heap.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
+  int64_t num_selected = std::min<int64_t>(k, axis_len);
+
+  ParallelForRows(axis_mul_before * axis_mul_after, axis_len, [&](int64_t row_begin,
+                                                                  int64_t row_end) {
+    std::vector<std::pair<int64_t, DataType>> sorter;
+    std::vector<std::pair<int64_t, DataType>> buffer;
+    sorter.reserve(axis_len);
+    for (int64_t row = row_begin; row < row_end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
+      sorter.clear();
+      int64_t src_base_idx = i * axis_len * axis_mul_after + j;
       int64_t dst_base_idx = i * k * axis_mul_after + j;
-
-      // Start by creating min/max heap with fixed-k elements
-      int cur_axis_index = 0;
-      for (; cur_axis_index < k && cur_axis_index < input->shape[axis]; cur_axis_index++) {
+      for (int64_t cur_axis_index = 0; cur_axis_index < axis_len; ++cur_axis_index) {
         int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
-        running_heap.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
-      }
-      if (!is_ascend) {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-      } else {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
+        sorter.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
       }
 
-      // Iterate through all elements, adding to heap along the way
-      for (; cur_axis_index < input->shape[axis]; cur_axis_index++) {
-        int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
-        std::pair<int64_t, DataType> cur_val = {cur_axis_index, data_ptr[full_idx]};
-
-        // Eq. to cur_val.second > running_heap.second
-        if (!is_ascend && CompareDescend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          running_heap.pop_back();
-        } else if (is_ascend && CompareAscend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          running_heap.pop_back();
+      if (num_selected < axis_len) {
+        // Select the top-k elements in linear time, then only sort the selected ones.
+        // Ties are broken by index, which makes the order total and thus the result
+        // identical to a stable full sort.
+        auto nth = sorter.begin() + num_selected;
+        if (is_ascend) {
+          std::nth_element(sorter.begin(), nth, sorter.end(), CompareAscend<DataType, true>);
+          std::sort(sorter.begin(), nth, CompareAscend<DataType, true>);
+        } else {
+          std::nth_element(sorter.begin(), nth, sorter.end(), CompareDescend<DataType, true>);
+          std::sort(sorter.begin(), nth, CompareDescend<DataType, true>);
         }
-      }
-
-      // finally sort heap and deliver results
-      if (is_ascend) {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
       } else {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
+        StableSortPairs(&sorter, &buffer, is_ascend);
       }
 
-      for (uint32_t kk = 0; kk < running_heap.size(); ++kk) {
+      for (int64_t kk = 0; kk < num_selected; ++kk) {
         if (indices_ptr != nullptr) {
           indices_ptr[dst_base_idx + kk * axis_mul_after] =
-              static_cast<IndicesType>(running_heap[kk].first);
+              static_cast<IndicesType>(sorter[kk].first);
         }
         if (values_ptr != nullptr) {
-          values_ptr[dst_base_idx + kk * axis_mul_after] =
-              static_cast<DataType>(running_heap[kk].second);
+          values_ptr[dst_base_idx + kk * axis_mul_after] = static_cast<DataType>(sorter[kk].second);
         }
       }
     }
-  }
+  });
 }
 
 // Argsort implemented C library sort.
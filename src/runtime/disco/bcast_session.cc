@@ -21,6 +21,7 @@
 #include <tvm/runtime/disco/session.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/tracing.h>
 
 #include <sstream>
 
@@ -76,6 +77,7 @@ void BcastSessionObj::InitCCL(String ccl, IntTuple device_ids) {
 }
 
 void BcastSessionObj::SyncWorker(int worker_id) {
+  profiling::TraceScope trace("disco", "SyncWorker");
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kSyncWorker, worker_id);
   TVMArgs args = this->RecvReplyPacked(worker_id);
   ICHECK_EQ(args.size(), 2);
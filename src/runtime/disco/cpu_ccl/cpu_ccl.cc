@@ -0,0 +1,772 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cpu_ccl.cc
+ * \brief A collective communication library for the Disco workers on the CPUs of one host.
+ *
+ *  The workers of a communicator map a shared memory segment, in which each worker owns a
+ *  staging slot. The collectives stage the data in the slots chunk by chunk, and the workers
+ *  are synchronized by a barrier in the segment. Small allreduces use recursive doubling,
+ *  which takes log(P) pairwise steps. The others reduce-scatter the chunk across the slots
+ *  and then gather the reduced pieces, so that each worker reduces 1/P of the data, the same
+ *  traffic as the ring algorithm, without its P - 1 sequential steps.
+ */
+#ifndef _WIN32
+
+#include <builtin_fp16.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tvm/runtime/disco/builtin.h>
+#include <tvm/runtime/disco/disco_worker.h>
+#include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace runtime {
+namespace cpu_ccl {
+
+/*! \brief The size of the staging slot of each worker. */
+constexpr int64_t kSlotBytes = 1 << 20;
+/*! \brief The largest allreduce that uses recursive doubling. */
+constexpr int64_t kRecursiveDoublingMaxBytes = 64 << 10;
+/*! \brief The number of polls before a waiting worker starts to yield its core. */
+constexpr int kSpinCount = 1 << 12;
+/*! \brief The number of elements reduced at a time, which is kept in registers or L1. */
+constexpr int kReduceBlock = 256;
+
+/*! \brief Poll until the condition holds. */
+template <typename FCond>
+inline void SpinUntil(FCond cond) {
+  for (int i = 0; !cond(); ++i) {
+    if (i >= kSpinCount) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/*! \brief The control block at the beginning of the segment of a communicator. */
+struct CommunicatorHeader {
+  /*! \brief The number of workers that arrived at the current barrier. */
+  alignas(64) std::atomic<uint32_t> barrier_count;
+  /*! \brief The number of barriers passed. */
+  alignas(64) std::atomic<uint32_t> barrier_generation;
+};
+
+/*!
+ * \brief A group of workers that run the collectives together.
+ *
+ *  The segment has the control block, the counters of the point-to-point transfers, and
+ *  a staging slot for each worker.
+ */
+class Communicator {
+ public:
+  /*!
+   * \brief Map the segment of the communicator, which is created by the first worker.
+   * \param name The name of the shared memory segment.
+   * \param num_ranks The number of workers in the communicator.
+   * \param rank The rank of the current worker in the communicator.
+   */
+  Communicator(std::string name, int num_ranks, int rank)
+      : name_(std::move(name)), num_ranks_(num_ranks), rank_(rank) {
+    counters_offset_ = RoundUp(sizeof(CommunicatorHeader));
+    slots_offset_ = RoundUp(counters_offset_ + 2 * num_ranks * num_ranks * sizeof(uint64_t));
+    map_bytes_ = slots_offset_ + num_ranks * kSlotBytes;
+    int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0600);
+    CHECK_GE(fd, 0) << "Cannot open the shared memory segment " << name_ << ": "
+                    << strerror(errno);
+    // A new segment is zero-filled, which is the initial state of the communicator.
+    CHECK_EQ(ftruncate(fd, map_bytes_), 0)
+        << "Cannot allocate the shared memory segment " << name_ << ": " << strerror(errno);
+    void* ptr = mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(ptr != MAP_FAILED) << "Cannot map the shared memory segment " << name_ << ": "
+                             << strerror(errno);
+    base_ = static_cast<char*>(ptr);
+    header_ = reinterpret_cast<CommunicatorHeader*>(base_);
+    // All the workers have mapped the segment after the barrier, so its name can be dropped.
+    Barrier();
+    if (rank_ == 0) {
+      shm_unlink(name_.c_str());
+    }
+  }
+
+  ~Communicator() { munmap(base_, map_bytes_); }
+
+  int num_ranks() const { return num_ranks_; }
+  int rank() const { return rank_; }
+
+  /*! \return The staging slot of a worker. */
+  char* Slot(int rank) const { return base_ + slots_offset_ + rank * kSlotBytes; }
+
+  /*! \brief Wait until all the workers of the communicator arrive. */
+  void Barrier() {
+    uint32_t generation = header_->barrier_generation.load(std::memory_order_acquire);
+    if (header_->barrier_count.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+        static_cast<uint32_t>(num_ranks_)) {
+      header_->barrier_count.store(0, std::memory_order_relaxed);
+      header_->barrier_generation.fetch_add(1, std::memory_order_release);
+    } else {
+      SpinUntil([&]() {
+        return header_->barrier_generation.load(std::memory_order_acquire) != generation;
+      });
+    }
+  }
+
+  /*! \return The number of chunks the sender has posted to the receiver. */
+  std::atomic<uint64_t>* Posted(int sender, int receiver) const {
+    return Counter(sender * num_ranks_ + receiver);
+  }
+
+  /*! \return The number of chunks the receiver has taken from the sender. */
+  std::atomic<uint64_t>* Taken(int sender, int receiver) const {
+    return Counter((num_ranks_ + sender) * num_ranks_ + receiver);
+  }
+
+ private:
+  static uint64_t RoundUp(uint64_t nbytes) { return (nbytes + 4095) / 4096 * 4096; }
+
+  std::atomic<uint64_t>* Counter(int index) const {
+    return reinterpret_cast<std::atomic<uint64_t>*>(base_ + counters_offset_) + index;
+  }
+
+  std::string name_;
+  int num_ranks_;
+  int rank_;
+  uint64_t counters_offset_;
+  uint64_t slots_offset_;
+  uint64_t map_bytes_;
+  char* base_;
+  CommunicatorHeader* header_;
+};
+
+/*! \brief The CPU collective library state of a worker. */
+struct CPUCCLThreadLocalContext {
+  DiscoWorker* worker = nullptr;
+  std::unique_ptr<Communicator> global_comm;
+  std::unique_ptr<Communicator> group_comm;
+
+  static CPUCCLThreadLocalContext* Get() {
+    thread_local static CPUCCLThreadLocalContext ctx;
+    return &ctx;
+  }
+
+  Communicator* GetComm(bool in_group) {
+    CHECK(global_comm != nullptr) << "ValueError: The CPU collective library is not initialized";
+    return in_group && group_comm != nullptr ? group_comm.get() : global_comm.get();
+  }
+};
+
+/********** Reduction kernels **********/
+
+/*! \brief Load and store an element in the type used to accumulate it. */
+template <typename TStorage, typename TAccum>
+struct ElemConverter {
+  static TAccum Load(TStorage v) { return static_cast<TAccum>(v); }
+  static TStorage Store(TAccum v) { return static_cast<TStorage>(v); }
+};
+
+struct Float16 {
+  uint16_t bits;
+};
+
+struct BFloat16 {
+  uint16_t bits;
+};
+
+template <>
+struct ElemConverter<Float16, float> {
+  static float Load(Float16 v) {
+    return __extendXfYf2__<uint16_t, uint16_t, 10, float, uint32_t, 23>(v.bits);
+  }
+  static Float16 Store(float v) {
+    return Float16{__truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(v)};
+  }
+};
+
+template <>
+struct ElemConverter<BFloat16, float> {
+  static float Load(BFloat16 v) {
+    uint32_t bits = static_cast<uint32_t>(v.bits) << 16;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+  static BFloat16 Store(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+      // Keep NaN a quiet NaN.
+      return BFloat16{static_cast<uint16_t>((bits >> 16) | 0x40)};
+    }
+    // Round to the nearest even.
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return BFloat16{static_cast<uint16_t>(bits >> 16)};
+  }
+};
+
+struct SumOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return a + b;
+  }
+};
+
+struct ProdOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return a * b;
+  }
+};
+
+struct MinOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return b < a ? b : a;
+  }
+};
+
+struct MaxOp {
+  template <typename T>
+  static T Apply(T a, T b) {
+    return a < b ? b : a;
+  }
+};
+
+/*!
+ * \brief Reduce the sources element-wise into the destination, which may alias a source.
+ *  The sources are combined in their order, so that all the workers get the same result.
+ *  The elements are accumulated block by block in TAccum, whose simple loops are vectorized
+ *  by the compiler, and half precision values are rounded once per call, when stored.
+ */
+template <typename TStorage, typename TAccum, typename Op>
+void ReduceKernel(const void* const* srcs, int num_srcs, void* dst, int64_t num_elems) {
+  using Converter = ElemConverter<TStorage, TAccum>;
+  TAccum acc[kReduceBlock];
+  for (int64_t begin = 0; begin < num_elems; begin += kReduceBlock) {
+    int len = static_cast<int>(std::min<int64_t>(kReduceBlock, num_elems - begin));
+    const TStorage* src = static_cast<const TStorage*>(srcs[0]) + begin;
+    for (int i = 0; i < len; ++i) {
+      acc[i] = Converter::Load(src[i]);
+    }
+    for (int k = 1; k < num_srcs; ++k) {
+      src = static_cast<const TStorage*>(srcs[k]) + begin;
+      for (int i = 0; i < len; ++i) {
+        acc[i] = Op::Apply(acc[i], Converter::Load(src[i]));
+      }
+    }
+    TStorage* out = static_cast<TStorage*>(dst) + begin;
+    for (int i = 0; i < len; ++i) {
+      out[i] = Converter::Store(acc[i]);
+    }
+  }
+}
+
+/*! \brief Divide the elements by the number of workers, for ReduceKind::kAvg. */
+template <typename TStorage, typename TAccum>
+void DivideKernel(void* data, int64_t num_elems, int divisor) {
+  using Converter = ElemConverter<TStorage, TAccum>;
+  TStorage* ptr = static_cast<TStorage*>(data);
+  for (int64_t i = 0; i < num_elems; ++i) {
+    ptr[i] = Converter::Store(Converter::Load(ptr[i]) / static_cast<TAccum>(divisor));
+  }
+}
+
+/*! \brief Convert the elements from their storage type to the type they are accumulated in. */
+template <typename TStorage, typename TAccum>
+void LoadKernel(const void* src, int64_t num_elems, void* dst) {
+  const TStorage* in = static_cast<const TStorage*>(src);
+  TAccum* out = static_cast<TAccum*>(dst);
+  for (int64_t i = 0; i < num_elems; ++i) {
+    out[i] = ElemConverter<TStorage, TAccum>::Load(in[i]);
+  }
+}
+
+/*! \brief Convert the elements from the type they are accumulated in to their storage type. */
+template <typename TStorage, typename TAccum>
+void StoreKernel(const void* src, int64_t num_elems, void* dst) {
+  const TAccum* in = static_cast<const TAccum*>(src);
+  TStorage* out = static_cast<TStorage*>(dst);
+  for (int64_t i = 0; i < num_elems; ++i) {
+    out[i] = ElemConverter<TStorage, TAccum>::Store(in[i]);
+  }
+}
+
+/*! \brief The reduction functions of a data type. */
+struct Reducer {
+  using FReduce = void (*)(const void* const*, int, void*, int64_t);
+  using FDivide = void (*)(void*, int64_t, int);
+  using FConvert = void (*)(const void*, int64_t, void*);
+  /*! \brief Reduce elements in their storage type. */
+  FReduce reduce;
+  FDivide divide;
+  /*! \brief The size of the type the elements are accumulated in. */
+  int accum_bytes;
+  /*! \brief Reduce elements in the type they are accumulated in. */
+  FReduce reduce_accum;
+  /*! \brief Convert to and from the accumulation type, nullptr if it is the storage type. */
+  FConvert load;
+  FConvert store;
+
+  template <typename TStorage, typename TAccum>
+  static Reducer Make(ReduceKind kind) {
+    Reducer reducer;
+    reducer.divide = DivideKernel<TStorage, TAccum>;
+    reducer.accum_bytes = sizeof(TAccum);
+    reducer.load = nullptr;
+    reducer.store = nullptr;
+    if constexpr (!std::is_same_v<TStorage, TAccum>) {
+      reducer.load = LoadKernel<TStorage, TAccum>;
+      reducer.store = StoreKernel<TStorage, TAccum>;
+    }
+    switch (kind) {
+      case ReduceKind::kSum:
+      case ReduceKind::kAvg:
+        reducer.reduce = ReduceKernel<TStorage, TAccum, SumOp>;
+        reducer.reduce_accum = ReduceKernel<TAccum, TAccum, SumOp>;
+        break;
+      case ReduceKind::kProd:
+        reducer.reduce = ReduceKernel<TStorage, TAccum, ProdOp>;
+        reducer.reduce_accum = ReduceKernel<TAccum, TAccum, ProdOp>;
+        break;
+      case ReduceKind::kMin:
+        reducer.reduce = ReduceKernel<TStorage, TAccum, MinOp>;
+        reducer.reduce_accum = ReduceKernel<TAccum, TAccum, MinOp>;
+        break;
+      case ReduceKind::kMax:
+        reducer.reduce = ReduceKernel<TStorage, TAccum, MaxOp>;
+        reducer.reduce_accum = ReduceKernel<TAccum, TAccum, MaxOp>;
+        break;
+    }
+    return reducer;
+  }
+
+  static Reducer Get(DataType dtype, ReduceKind kind) {
+    if (dtype == DataType::Float(32)) return Make<float, float>(kind);
+    if (dtype == DataType::Float(16)) return Make<Float16, float>(kind);
+    if (dtype == DataType::BFloat(16)) return Make<BFloat16, float>(kind);
+    if (dtype == DataType::Float(64)) return Make<double, double>(kind);
+    if (dtype == DataType::Int(32)) return Make<int32_t, int32_t>(kind);
+    if (dtype == DataType::Int(64)) return Make<int64_t, int64_t>(kind);
+    if (dtype == DataType::Int(8)) return Make<int8_t, int8_t>(kind);
+    if (dtype == DataType::UInt(8)) return Make<uint8_t, uint8_t>(kind);
+    LOG(FATAL) << "ValueError: The CPU collective library cannot reduce " << dtype;
+    throw;
+  }
+};
+
+/********** Collectives **********/
+
+inline int64_t NumBytes(const NDArray& array) { return GetDataSize(*array.operator->()); }
+
+inline void CheckCPUArray(const NDArray& array, const char* name) {
+  CHECK(array.defined()) << "ValueError: buffer `" << name << "` must not be None";
+  CHECK_EQ(array->device.device_type, kDLCPU)
+      << "ValueError: The CPU collective library requires buffer `" << name
+      << "` to be on CPU, but got " << array->device;
+  CHECK(array.IsContiguous()) << "ValueError: buffer `" << name << "` must be contiguous";
+}
+
+void InitCCL(Session sess, IntTuple device_ids) {
+  DRef func = sess->GetGlobalFunc("runtime.disco.cpu.init_ccl_per_worker");
+  DLOG(INFO) << "Initializing the CPU collective library";
+  static std::atomic<int> counter{0};
+  std::string name =
+      "/tvm-disco-ccl-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+  sess->CallPacked(func, device_ids, name);
+}
+
+void InitCCLPerWorker(IntTuple device_ids, std::string name) {
+  CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  ICHECK(worker != nullptr);
+  CHECK(ctx->global_comm == nullptr) << "Cannot initialize CCL, "
+                                     << "the previous thread-global comm still exists, "
+                                     << "and has not been destructed";
+  int group_size = worker->num_workers / worker->num_groups;
+  int group_id = worker->worker_id / group_size;
+  worker->default_device = Device{kDLCPU, 0};
+  worker->ccl = "cpu";
+  ctx->worker = worker;
+  ctx->global_comm =
+      std::make_unique<Communicator>(name + "-all", worker->num_workers, worker->worker_id);
+  if (worker->num_groups > 1) {
+    ctx->group_comm = std::make_unique<Communicator>(name + "-group" + std::to_string(group_id),
+                                                     group_size, worker->worker_id % group_size);
+  }
+}
+
+/*!
+ * \brief Allreduce by recursive doubling, for a power-of-two number of workers.
+ *  The partial results are exchanged in the accumulation type, so that half precision values
+ *  are rounded once at the end rather than at each step.
+ */
+void AllReduceRecursiveDoubling(Communicator* comm, const Reducer& reducer, int64_t num_elems,
+                                void* recv) {
+  int64_t accum_nbytes = num_elems * reducer.accum_bytes;
+  ICHECK_LE(accum_nbytes, kSlotBytes);
+  std::vector<char> accum_buffer;
+  void* accum = recv;
+  if (reducer.load != nullptr) {
+    accum_buffer.resize(accum_nbytes);
+    accum = accum_buffer.data();
+    reducer.load(recv, num_elems, accum);
+  }
+  char* my_slot = comm->Slot(comm->rank());
+  for (int mask = 1; mask < comm->num_ranks(); mask <<= 1) {
+    std::memcpy(my_slot, accum, accum_nbytes);
+    comm->Barrier();
+    // The partners add the same two values, so that they stay bitwise identical.
+    const void* srcs[2] = {accum, comm->Slot(comm->rank() ^ mask)};
+    reducer.reduce_accum(srcs, 2, accum, num_elems);
+    comm->Barrier();
+  }
+  if (reducer.store != nullptr) {
+    reducer.store(accum, num_elems, recv);
+  }
+}
+
+/*! \brief Allreduce by reduce-scatter and then all-gather of each chunk through the slots. */
+void AllReduceScatterGather(Communicator* comm, const Reducer& reducer, int64_t num_elems,
+                            int elem_bytes, const char* send, char* recv) {
+  int num_ranks = comm->num_ranks();
+  int rank = comm->rank();
+  int64_t chunk_elems = kSlotBytes / elem_bytes;
+  std::vector<const void*> srcs(num_ranks);
+  for (int64_t begin = 0; begin < num_elems; begin += chunk_elems) {
+    int64_t len = std::min(chunk_elems, num_elems - begin);
+    int64_t piece = (len + num_ranks - 1) / num_ranks;
+    std::memcpy(comm->Slot(rank), send + begin * elem_bytes, len * elem_bytes);
+    comm->Barrier();
+    // Reduce the piece owned by this worker across all the slots, into its own slot.
+    int64_t piece_begin = std::min(len, rank * piece);
+    int64_t piece_len = std::min(len, piece_begin + piece) - piece_begin;
+    for (int i = 0; i < num_ranks; ++i) {
+      srcs[i] = comm->Slot(i) + piece_begin * elem_bytes;
+    }
+    reducer.reduce(srcs.data(), num_ranks, comm->Slot(rank) + piece_begin * elem_bytes,
+                   piece_len);
+    comm->Barrier();
+    // Gather the reduced pieces from the slots of their owners.
+    for (int i = 0; i < num_ranks; ++i) {
+      int64_t b = std::min(len, i * piece);
+      int64_t e = std::min(len, b + piece);
+      std::memcpy(recv + (begin + b) * elem_bytes, comm->Slot(i) + b * elem_bytes,
+                  (e - b) * elem_bytes);
+    }
+    comm->Barrier();
+  }
+}
+
+void AllReduce(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+  CheckCPUArray(send, "send");
+  CheckCPUArray(recv, "recv");
+  Communicator* comm = CPUCCLThreadLocalContext::Get()->GetComm(in_group);
+  DataType dtype(send->dtype);
+  int64_t num_elems = send.Shape()->Product();
+  int64_t nbytes = NumBytes(send);
+  CHECK_EQ(nbytes, NumBytes(recv)) << "ValueError: buffers `send` and `recv` differ in size";
+  Reducer reducer = Reducer::Get(dtype, reduce_kind);
+  int num_ranks = comm->num_ranks();
+  if (num_ranks == 1) {
+    if (send->data != recv->data) std::memcpy(recv->data, send->data, nbytes);
+  } else if (nbytes <= kRecursiveDoublingMaxBytes && (num_ranks & (num_ranks - 1)) == 0) {
+    if (send->data != recv->data) std::memcpy(recv->data, send->data, nbytes);
+    AllReduceRecursiveDoubling(comm, reducer, num_elems, recv->data);
+  } else {
+    AllReduceScatterGather(comm, reducer, num_elems, dtype.bytes(),
+                           static_cast<const char*>(send->data), static_cast<char*>(recv->data));
+  }
+  if (reduce_kind == ReduceKind::kAvg) {
+    reducer.divide(recv->data, num_elems, num_ranks);
+  }
+}
+
+void AllGather(NDArray send, bool in_group, NDArray recv) {
+  CheckCPUArray(send, "send");
+  CheckCPUArray(recv, "recv");
+  Communicator* comm = CPUCCLThreadLocalContext::Get()->GetComm(in_group);
+  int num_ranks = comm->num_ranks();
+  int64_t nbytes = NumBytes(send);
+  CHECK_EQ(nbytes * num_ranks, NumBytes(recv))
+      << "ValueError: buffer `recv` must be " << num_ranks << " times as large as `send`";
+  const char* src = static_cast<const char*>(send->data);
+  char* dst = static_cast<char*>(recv->data);
+  for (int64_t begin = 0; begin < nbytes; begin += kSlotBytes) {
+    int64_t len = std::min(kSlotBytes, nbytes - begin);
+    std::memcpy(comm->Slot(comm->rank()), src + begin, len);
+    comm->Barrier();
+    for (int i = 0; i < num_ranks; ++i) {
+      std::memcpy(dst + i * nbytes + begin, comm->Slot(i), len);
+    }
+    comm->Barrier();
+  }
+}
+
+void BroadcastFromWorker0(Optional<NDArray> send, bool in_group, NDArray recv) {
+  CheckCPUArray(recv, "recv");
+  Communicator* comm = CPUCCLThreadLocalContext::Get()->GetComm(in_group);
+  bool is_sender = comm->rank() == 0;
+  int64_t nbytes = NumBytes(recv);
+  const char* src = nullptr;
+  if (is_sender) {
+    CHECK(send.defined());
+    CHECK(send.value().Shape()->Product() == recv.Shape()->Product());
+    CheckCPUArray(send.value(), "send");
+    src = static_cast<const char*>(send.value()->data);
+  }
+  char* dst = static_cast<char*>(recv->data);
+  for (int64_t begin = 0; begin < nbytes; begin += kSlotBytes) {
+    int64_t len = std::min(kSlotBytes, nbytes - begin);
+    if (is_sender) {
+      std::memcpy(comm->Slot(0), src + begin, len);
+    }
+    comm->Barrier();
+    std::memcpy(dst + begin, comm->Slot(0), len);
+    comm->Barrier();
+  }
+}
+
+void ScatterFromWorker0(Optional<NDArray> send, bool in_group, NDArray recv) {
+  CheckCPUArray(recv, "recv");
+  Communicator* comm = CPUCCLThreadLocalContext::Get()->GetComm(in_group);
+  int num_ranks = comm->num_ranks();
+  bool is_sender = comm->rank() == 0;
+  int64_t shard_bytes = NumBytes(recv);
+  const char* src = nullptr;
+  if (is_sender) {
+    CHECK(send.defined()) << "ValueError: buffer `send` must be provided when worker_id == 0.";
+    NDArray buffer = send.value();
+    CheckCPUArray(buffer, "send");
+    int64_t numel = buffer.Shape()->Product();
+    CHECK_EQ(numel % num_ranks, 0) << "ValueError: Scattering evenly requires that the number "
+                                      "of elements in the buffer to be "
+                                      "divisible by the number of workers, but got numel = "
+                                   << numel << " and " << num_ranks << " workers.";
+    CHECK_EQ(numel / num_ranks, recv.Shape()->Product())
+        << "ValueError: The number of elements in buffer `recv` must be the same as each shard "
+           "of buffer `send`. `send.size` is "
+        << numel << ", but `recv.size` is " << recv.Shape()->Product() << ".";
+    src = static_cast<const char*>(buffer->data);
+  } else if (send.defined()) {
+    LOG(WARNING) << "ValueError: buffer `send` must be None when (worker_id != 0 && !in_group) "
+                    "or (worker_id % group_size != 0 && in_group). However, got send = "
+                 << send.get() << ". This will be ignored.";
+  }
+  char* dst = static_cast<char*>(recv->data);
+  for (int64_t begin = 0; begin < shard_bytes; begin += kSlotBytes) {
+    int64_t len = std::min(kSlotBytes, shard_bytes - begin);
+    if (is_sender) {
+      for (int i = 0; i < num_ranks; ++i) {
+        std::memcpy(comm->Slot(i), src + i * shard_bytes + begin, len);
+      }
+    }
+    comm->Barrier();
+    std::memcpy(dst + begin, comm->Slot(comm->rank()), len);
+    comm->Barrier();
+  }
+}
+
+void GatherToWorker0(NDArray send, bool in_group, Optional<NDArray> recv) {
+  CheckCPUArray(send, "send");
+  Communicator* comm = CPUCCLThreadLocalContext::Get()->GetComm(in_group);
+  int num_ranks = comm->num_ranks();
+  bool is_sender = comm->rank() == 0;
+  int64_t shard_bytes = NumBytes(send);
+  char* dst = nullptr;
+  if (is_sender) {
+    CHECK(recv.defined()) << "ValueError: buffer `recv` must be provided when worker_id == 0.";
+    NDArray buffer = recv.value();
+    CheckCPUArray(buffer, "recv");
+    int64_t numel = buffer.Shape()->Product();
+    CHECK_EQ(numel % num_ranks, 0) << "ValueError: Gathering evenly requires that the number "
+                                      "of elements in the buffer to be "
+                                      "divisible by the number of workers, but got numel = "
+                                   << numel << " and " << num_ranks << " workers.";
+    CHECK_EQ(numel / num_ranks, send.Shape()->Product())
+        << "ValueError: The number of elements in buffer `send` must be the same as each shard "
+           "of buffer `recv`. `recv.size` is "
+        << numel << ", but `send.size` is " << send.Shape()->Product() << ".";
+    dst = static_cast<char*>(buffer->data);
+  } else if (recv.defined()) {
+    LOG(WARNING) << "ValueError: buffer `recv` must be None when (worker_id != 0 && !in_group) "
+                    "or (worker_id % group_size != 0 && in_group). However, got recv = "
+                 << recv.get() << ". This will be ignored.";
+  }
+  const char* src = static_cast<const char*>(send->data);
+  for (int64_t begin = 0; begin < shard_bytes; begin += kSlotBytes) {
+    int64_t len = std::min(kSlotBytes, shard_bytes - begin);
+    std::memcpy(comm->Slot(comm->rank()), src + begin, len);
+    comm->Barrier();
+    if (is_sender) {
+      for (int i = 0; i < num_ranks; ++i) {
+        std::memcpy(dst + i * shard_bytes + begin, comm->Slot(i), len);
+      }
+    }
+    comm->Barrier();
+  }
+}
+
+/*!
+ * \brief Send a buffer to another worker through the slot of the sender. Each chunk is
+ *  posted to the receiver, and the slot is reused once the receiver has taken it.
+ */
+void SendToWorker(NDArray buffer, int receiver_id) {
+  CheckCPUArray(buffer, "buffer");
+  CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+  Communicator* comm = ctx->GetComm(false);
+  int worker_id = comm->rank();
+  CHECK(receiver_id >= 0 && receiver_id < comm->num_ranks())
+      << "Invalid receiver id " << receiver_id << ". The world size is " << comm->num_ranks();
+  CHECK_NE(worker_id, receiver_id) << "Cannot send to worker itself.";
+  std::atomic<uint64_t>* posted = comm->Posted(worker_id, receiver_id);
+  std::atomic<uint64_t>* taken = comm->Taken(worker_id, receiver_id);
+  int64_t nbytes = NumBytes(buffer);
+  const char* src = static_cast<const char*>(buffer->data);
+  int64_t begin = 0;
+  do {
+    int64_t len = std::min(kSlotBytes, nbytes - begin);
+    std::memcpy(comm->Slot(worker_id), src + begin, len);
+    uint64_t seq = posted->fetch_add(1, std::memory_order_release) + 1;
+    SpinUntil([&]() { return taken->load(std::memory_order_acquire) == seq; });
+    begin += len;
+  } while (begin < nbytes);
+}
+
+void RecvFromWorker(NDArray buffer, int sender_id) {
+  CheckCPUArray(buffer, "buffer");
+  CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+  Communicator* comm = ctx->GetComm(false);
+  int worker_id = comm->rank();
+  CHECK(sender_id >= 0 && sender_id < comm->num_ranks())
+      << "Invalid sender id " << sender_id << ". The world size is " << comm->num_ranks();
+  CHECK_NE(worker_id, sender_id) << "Cannot receive from the worker itself.";
+  std::atomic<uint64_t>* posted = comm->Posted(sender_id, worker_id);
+  std::atomic<uint64_t>* taken = comm->Taken(sender_id, worker_id);
+  int64_t nbytes = NumBytes(buffer);
+  char* dst = static_cast<char*>(buffer->data);
+  int64_t begin = 0;
+  do {
+    int64_t len = std::min(kSlotBytes, nbytes - begin);
+    uint64_t seq = taken->load(std::memory_order_relaxed) + 1;
+    SpinUntil([&]() { return posted->load(std::memory_order_acquire) >= seq; });
+    std::memcpy(dst + begin, comm->Slot(sender_id), len);
+    taken->store(seq, std::memory_order_release);
+    begin += len;
+  } while (begin < nbytes);
+}
+
+void RecvFromWorker0(NDArray buffer) {
+  CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+  CHECK_NE(ctx->GetComm(false)->rank(), 0)
+      << "ValueError: Worker 0 is not allowed to call RecvFromWorker0.";
+  cpu_ccl::RecvFromWorker(buffer, 0);
+}
+
+void SendToNextGroup(NDArray buffer) {
+  CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+  int worker_id = ctx->GetComm(false)->rank();
+  int group_size = ctx->worker->num_workers / ctx->worker->num_groups;
+  int receiver_id = worker_id + group_size;
+  CHECK_LT(receiver_id, ctx->worker->num_workers)
+      << "The current group is already the last group and there is no such a next group.";
+  cpu_ccl::SendToWorker(buffer, receiver_id);
+}
+
+void RecvFromPrevGroup(NDArray buffer) {
+  CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+  int worker_id = ctx->GetComm(false)->rank();
+  int group_size = ctx->worker->num_workers / ctx->worker->num_groups;
+  int sender_id = worker_id - group_size;
+  CHECK_GE(sender_id, 0)
+      << "The current group is already the first group and there is no such a previous group.";
+  cpu_ccl::RecvFromWorker(buffer, sender_id);
+}
+
+void SyncWorker() {
+  // The collectives are synchronous on CPU.
+}
+
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.init_ccl").set_body_typed(InitCCL);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.init_ccl_per_worker").set_body_typed(InitCCLPerWorker);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.allreduce")
+    .set_body_typed([](NDArray send, int kind, bool in_group, NDArray recv) {
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      cpu_ccl::AllReduce(send, static_cast<ReduceKind>(kind), in_group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.allgather")
+    .set_body_typed([](NDArray send, bool in_group, NDArray recv) {
+      cpu_ccl::AllGather(send, in_group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.broadcast_from_worker0")
+    .set_body_typed(BroadcastFromWorker0);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.scatter_from_worker0").set_body_typed(ScatterFromWorker0);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.gather_to_worker0").set_body_typed(GatherToWorker0);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.recv_from_worker0").set_body_typed(RecvFromWorker0);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.send_to_next_group").set_body_typed(SendToNextGroup);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.recv_from_prev_group").set_body_typed(RecvFromPrevGroup);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.send_to_worker").set_body_typed(SendToWorker);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.recv_from_worker").set_body_typed(RecvFromWorker);
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.sync_worker").set_body_typed(SyncWorker);
+
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.test_send_to_next_group_recv_from_prev_group")
+    .set_body_typed([](NDArray buffer) {
+      CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+      CHECK_EQ(ctx->worker->num_workers, 4) << "The test requires the world size to be 4.";
+      CHECK_EQ(ctx->worker->num_groups, 2) << "The test requires the group size to be 2.";
+      int group_size = ctx->worker->num_workers / ctx->worker->num_groups;
+      int group_id = ctx->worker->worker_id / group_size;
+      if (group_id == 0) {
+        cpu_ccl::SendToNextGroup(buffer);
+      } else {
+        cpu_ccl::RecvFromPrevGroup(buffer);
+      }
+    });
+
+TVM_REGISTER_GLOBAL("runtime.disco.cpu.test_worker2_sends_to_worker0")
+    .set_body_typed([](NDArray buffer) {
+      CPUCCLThreadLocalContext* ctx = CPUCCLThreadLocalContext::Get();
+      CHECK_EQ(ctx->worker->num_workers, 4) << "The test requires the world size to be 4.";
+      CHECK_EQ(ctx->worker->num_groups, 2) << "The test requires the group size to be 2.";
+      if (ctx->worker->worker_id == 2) {
+        cpu_ccl::SendToWorker(buffer, 0);
+      } else if (ctx->worker->worker_id == 0) {
+        cpu_ccl::RecvFromWorker(buffer, 2);
+      }
+    });
+
+}  // namespace cpu_ccl
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // _WIN32
@@ -21,6 +21,7 @@
 #include <tvm/runtime/disco/session.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/tracing.h>
 
 #include "../../support/process_id.h"
 #include "./protocol.h"
@@ -49,10 +50,13 @@ void DiscoWorker::SetRegister(int reg_id, TVMArgValue value) {
 struct DiscoWorker::Impl {
   static void MainLoop(DiscoWorker* self) {
     ThreadLocalDiscoWorker::Get()->worker = self;
+    profiling::SetTraceThreadName("disco worker " + std::to_string(self->worker_id));
     while (true) {
       TVMArgs args = self->channel->Recv();
       DiscoAction action = static_cast<DiscoAction>(args[0].operator int());
       int64_t reg_id = args[1];
+      profiling::TraceScope trace(
+          "disco", profiling::TracingEnabled() ? DiscoAction2String(action) : std::string());
       switch (action) {
         case DiscoAction::kShutDown: {
           Shutdown(self);
@@ -20,6 +20,7 @@
 #define TVM_RUNTIME_DISCO_MESSAGE_QUEUE_H_
 
 #include <dmlc/io.h>
+#include <tvm/runtime/tracing.h>
 
 #include <string>
 
@@ -31,11 +32,20 @@ namespace runtime {
 class DiscoStreamMessageQueue : private dmlc::Stream,
                                 private DiscoProtocol<DiscoStreamMessageQueue> {
  public:
-  explicit DiscoStreamMessageQueue(Stream* stream) : stream_(stream) {}
+  /*!
+   * \brief Create a message queue on a byte stream.
+   * \param stream The stream to send and receive the messages.
+   * \param ndarray_pool The pool to pass the NDArrays through, or nullptr to serialize them.
+   */
+  explicit DiscoStreamMessageQueue(Stream* stream, DiscoNDArrayPool* ndarray_pool = nullptr)
+      : stream_(stream) {
+    this->ndarray_pool_ = ndarray_pool;
+  }
 
   ~DiscoStreamMessageQueue() = default;
 
   void Send(const TVMArgs& args) {
+    profiling::TraceScope trace("disco", "SendMessage");
     RPCReference::ReturnPackedSeq(args.values, args.type_codes, args.num_args, this);
     CommitSendAndNotifyEnqueue();
   }
@@ -17,17 +17,32 @@
  * under the License.
  */
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#if defined(__linux__) || defined(__ANDROID__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "../../support/pipe.h"
+#include "../../support/shared_memory_ring.h"
 #include "../minrpc/rpc_reference.h"
 #include "./bcast_session.h"
 #include "./disco_worker_thread.h"
@@ -37,30 +52,347 @@
 namespace tvm {
 namespace runtime {
 
+#if defined(__linux__) || defined(__ANDROID__)
+/*!
+ * \brief The shared memory segment between the controller and a worker process.
+ *
+ *  The segment holds four rings: a message ring and an NDArray pool for each direction.
+ *  The messages are streamed through the message rings, and the NDArrays in them are
+ *  copied into the pools and passed as handles. The pipes between the two processes
+ *  are kept only to detect that the peer is gone.
+ */
+class DiscoSharedMemory : public std::enable_shared_from_this<DiscoSharedMemory> {
+ public:
+  /*! \brief The capacity of the message ring of each direction. */
+  static constexpr uint64_t kMessageRingBytes = 4 << 20;
+  /*! \brief The capacity of the NDArray pool of each direction. */
+  static constexpr uint64_t kNDArrayPoolBytes = 64 << 20;
+  /*! \brief The bytes reserved for the control blocks at the beginning of the segment. */
+  static constexpr uint64_t kHeaderBytes = 4096;
+
+  /*! \brief A byte stream on a message ring. */
+  class Stream final : public dmlc::Stream {
+   public:
+    Stream(DiscoSharedMemory* shm, support::SharedMemoryRing ring) : shm_(shm), ring_(ring) {}
+
+    size_t Read(void* ptr, size_t size) final {
+      size_t nread = 0;
+      while (nread < size) {
+        size_t n = ring_.Read(static_cast<char*>(ptr) + nread, size - nread,
+                              [this]() { return shm_->PeerAlive(); });
+        if (n == 0) break;
+        nread += n;
+      }
+      return nread;
+    }
+
+    size_t Write(const void* ptr, size_t size) final {
+      size_t nwrite = 0;
+      while (nwrite < size) {
+        size_t n = ring_.Write(static_cast<const char*>(ptr) + nwrite, size - nwrite,
+                               [this]() { return shm_->PeerAlive(); });
+        CHECK_NE(n, 0) << "Disco worker process is gone";
+        nwrite += n;
+      }
+      return nwrite;
+    }
+
+   private:
+    DiscoSharedMemory* shm_;
+    support::SharedMemoryRing ring_;
+  };
+
+  /*!
+   * \brief An NDArray pool on a ring. The sender reserves the space of the arrays in order,
+   *  and the receiver views them in place. As the views can be freed in any order, the
+   *  receiver gives the space back up to the oldest array that is still viewed.
+   */
+  class NDArrayPool final : public DiscoNDArrayPool {
+   public:
+    NDArrayPool(DiscoSharedMemory* shm, support::SharedMemoryRing ring) : shm_(shm), ring_(ring) {}
+
+    uint64_t capacity() const final { return ring_.capacity(); }
+
+    bool TryAllocate(uint64_t nbytes, uint64_t* handle, void** data) final {
+      if (!ring_.TryReserve(AlignedBytes(nbytes), handle)) return false;
+      *data = ring_.At(*handle);
+      return true;
+    }
+
+    NDArray View(uint64_t handle, ShapeTuple shape, DLDataType dtype) final {
+      struct ViewContext {
+        std::shared_ptr<DiscoSharedMemory> shm;
+        NDArrayPool* pool;
+        uint64_t handle;
+        ShapeTuple shape;
+        DLManagedTensor tensor;
+      };
+      auto* ctx = new ViewContext{shm_->shared_from_this(), this, handle, std::move(shape), {}};
+      DLTensor& tensor = ctx->tensor.dl_tensor;
+      tensor.data = ring_.At(handle);
+      tensor.device = Device{kDLCPU, 0};
+      tensor.ndim = static_cast<int32_t>(ctx->shape.size());
+      tensor.dtype = dtype;
+      tensor.shape = const_cast<int64_t*>(ctx->shape.data());
+      tensor.strides = nullptr;
+      tensor.byte_offset = 0;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        views_.push_back(
+            View_{handle, handle + AlignedBytes(GetDataSize(tensor)), /*freed=*/false});
+      }
+      ctx->tensor.manager_ctx = ctx;
+      ctx->tensor.deleter = [](DLManagedTensor* self) {
+        auto* ctx = static_cast<ViewContext*>(self->manager_ctx);
+        ctx->pool->Free(ctx->handle);
+        delete ctx;
+      };
+      return NDArray::FromDLPack(&ctx->tensor);
+    }
+
+   private:
+    /*! \brief The space of an array on the receiving side. */
+    struct View_ {
+      uint64_t handle;
+      uint64_t end;
+      bool freed;
+    };
+
+    /*! \brief The space is rounded up, so that every array is aligned as NDArrays require. */
+    static uint64_t AlignedBytes(uint64_t nbytes) {
+      return (nbytes + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+    }
+
+    /*! \brief Free the view of an array, on any thread. */
+    void Free(uint64_t handle) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::find_if(views_.begin(), views_.end(),
+                             [handle](const View_& view) { return view.handle == handle; });
+      ICHECK(it != views_.end());
+      it->freed = true;
+      uint64_t head = 0;
+      while (!views_.empty() && views_.front().freed) {
+        head = views_.front().end;
+        views_.pop_front();
+      }
+      if (head != 0) ring_.Release(head);
+    }
+
+    DiscoSharedMemory* shm_;
+    support::SharedMemoryRing ring_;
+    /*! \brief Protects views_, as the views may be freed by any thread. */
+    std::mutex mutex_;
+    /*! \brief The arrays received and not given back yet, in the order they are allocated. */
+    std::deque<View_> views_;
+  };
+
+  /*!
+   * \brief Create a shared memory segment, which is zero-filled, i.e. all the rings are empty.
+   * \return The file descriptor of the segment, or -1 if it cannot be created.
+   */
+  static int CreateSegment() {
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "tvm-disco-shm", MFD_CLOEXEC));
+    if (fd < 0) return -1;
+    if (ftruncate(fd, SegmentBytes()) != 0) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  /*!
+   * \brief Map a shared memory segment.
+   * \param shm_fd The file descriptor of the segment.
+   * \param pipe_fds The pipes to the peer, which are polled to detect that the peer is gone.
+   * \return The mapped segment, or nullptr if the segment cannot be mapped.
+   */
+  static std::shared_ptr<DiscoSharedMemory> Map(int shm_fd, std::vector<int> pipe_fds) {
+    struct stat st;
+    if (fstat(shm_fd, &st) != 0 || static_cast<uint64_t>(st.st_size) != SegmentBytes()) {
+      return nullptr;
+    }
+    void* ptr = mmap(nullptr, SegmentBytes(), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (ptr == MAP_FAILED) return nullptr;
+    return std::shared_ptr<DiscoSharedMemory>(
+        new DiscoSharedMemory(static_cast<char*>(ptr), std::move(pipe_fds)));
+  }
+
+  ~DiscoSharedMemory() { munmap(base_, SegmentBytes()); }
+
+  /*! \return The size of the segment. */
+  static uint64_t SegmentBytes() {
+    static_assert(4 * sizeof(support::SharedMemoryRingHeader) <= kHeaderBytes);
+    return kHeaderBytes + 2 * kMessageRingBytes + 2 * kNDArrayPoolBytes;
+  }
+
+  /*! \return Whether the peer is still there, i.e. the pipes to it are not closed. */
+  bool PeerAlive() const {
+    std::vector<pollfd> fds;
+    for (int fd : pipe_fds_) {
+      fds.push_back(pollfd{fd, 0, 0});
+    }
+    if (poll(fds.data(), fds.size(), 0) <= 0) return true;
+    for (const pollfd& fd : fds) {
+      if (fd.revents & (POLLHUP | POLLERR | POLLNVAL)) return false;
+    }
+    return true;
+  }
+
+  std::unique_ptr<Stream> controller_to_worker_stream_;
+  std::unique_ptr<Stream> worker_to_controller_stream_;
+  std::unique_ptr<NDArrayPool> controller_to_worker_pool_;
+  std::unique_ptr<NDArrayPool> worker_to_controller_pool_;
+
+ private:
+  DiscoSharedMemory(char* base, std::vector<int> pipe_fds) : pipe_fds_(pipe_fds), base_(base) {
+    auto* headers = reinterpret_cast<support::SharedMemoryRingHeader*>(base_);
+    char* data = base_ + kHeaderBytes;
+    auto make_ring = [&](int index, uint64_t capacity) {
+      support::SharedMemoryRing ring(headers + index, data, capacity);
+      data += capacity;
+      return ring;
+    };
+    controller_to_worker_stream_ = std::make_unique<Stream>(this, make_ring(0, kMessageRingBytes));
+    worker_to_controller_stream_ = std::make_unique<Stream>(this, make_ring(1, kMessageRingBytes));
+    controller_to_worker_pool_ =
+        std::make_unique<NDArrayPool>(this, make_ring(2, kNDArrayPoolBytes));
+    worker_to_controller_pool_ =
+        std::make_unique<NDArrayPool>(this, make_ring(3, kNDArrayPoolBytes));
+  }
+
+  std::vector<int> pipe_fds_;
+  char* base_;
+};
+#endif
+
+/*!
+ * \brief The channel between the controller and a worker process.
+ *
+ *  The messages go over the pipes, unless the two sides agree on a shared memory segment
+ *  when the worker starts. The controller offers the segment over the pipe, as a path the
+ *  worker can open, and the worker tells whether it could map it. So the segment is used
+ *  whatever launches the worker, and the pipes are used where it cannot be shared.
+ */
 class DiscoProcessChannel final : public DiscoChannel {
  public:
   DiscoProcessChannel(int64_t controler_to_worker_fd, int64_t worker_to_controler_fd)
       : controller_to_worker_pipe_(controler_to_worker_fd),
         worker_to_controller_pipe_(worker_to_controler_fd),
-        controler_to_worker_(&controller_to_worker_pipe_),
-        worker_to_controler_(&worker_to_controller_pipe_) {}
+        controler_to_worker_(
+            std::make_unique<DiscoStreamMessageQueue>(&controller_to_worker_pipe_)),
+        worker_to_controler_(
+            std::make_unique<DiscoStreamMessageQueue>(&worker_to_controller_pipe_)),
+        pipe_fds_{static_cast<int>(controler_to_worker_fd),
+                  static_cast<int>(worker_to_controler_fd)} {}
 
   DiscoProcessChannel(DiscoProcessChannel&& other) = delete;
   DiscoProcessChannel(const DiscoProcessChannel& other) = delete;
 
-  void Send(const TVMArgs& args) { controler_to_worker_.Send(args); }
-  TVMArgs Recv() { return controler_to_worker_.Recv(); }
-  void Reply(const TVMArgs& args) { worker_to_controler_.Send(args); }
-  TVMArgs RecvReply() { return worker_to_controler_.Recv(); }
+  ~DiscoProcessChannel() {
+#if defined(__linux__) || defined(__ANDROID__)
+    if (offered_shm_fd_ >= 0) close(offered_shm_fd_);
+#endif
+  }
+
+  /*! \brief Offer a shared memory segment to the worker, on the controller side. */
+  void OfferSharedMemory() {
+    std::string path;
+#if defined(__linux__) || defined(__ANDROID__)
+    offered_shm_fd_ = DiscoSharedMemory::CreateSegment();
+    if (offered_shm_fd_ >= 0) {
+      shm_ = DiscoSharedMemory::Map(offered_shm_fd_, pipe_fds_);
+    }
+    if (shm_ != nullptr) {
+      path = "/proc/" + std::to_string(getpid()) + "/fd/" + std::to_string(offered_shm_fd_);
+    }
+#endif
+    uint64_t path_size = path.size();
+    controller_to_worker_pipe_.Write(&path_size, sizeof(path_size));
+    controller_to_worker_pipe_.Write(path.data(), path.size());
+  }
+
+  /*!
+   * \brief Wait for the worker to accept or decline the offered segment, on the controller
+   *  side, and switch to the segment if it is accepted.
+   */
+  void FinishSharedMemoryOffer() {
+    uint8_t accepted = 0;
+    CHECK_EQ(worker_to_controller_pipe_.Read(&accepted, sizeof(accepted)), sizeof(accepted))
+        << "Disco worker process exited before connecting to the controller";
+#if defined(__linux__) || defined(__ANDROID__)
+    // The mapping keeps the segment alive.
+    if (offered_shm_fd_ >= 0) close(offered_shm_fd_);
+    offered_shm_fd_ = -1;
+    if (accepted) {
+      UseSharedMemory();
+    } else {
+      shm_.reset();
+    }
+#else
+    CHECK(!accepted) << "InternalError: The worker accepted a segment that was not offered";
+#endif
+  }
+
+  /*! \brief Accept the segment offered by the controller if it can be mapped, on the worker. */
+  void AcceptSharedMemory() {
+    uint64_t path_size = 0;
+    CHECK_EQ(controller_to_worker_pipe_.Read(&path_size, sizeof(path_size)), sizeof(path_size))
+        << "Disco controller is gone before the worker connected";
+    std::string path(path_size, '\0');
+    CHECK_EQ(controller_to_worker_pipe_.Read(path.data(), path_size), path_size)
+        << "Disco controller is gone before the worker connected";
+    uint8_t accepted = 0;
+#if defined(__linux__) || defined(__ANDROID__)
+    int shm_fd = path.empty() ? -1 : open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (shm_fd >= 0) {
+      shm_ = DiscoSharedMemory::Map(shm_fd, pipe_fds_);
+      close(shm_fd);
+      accepted = shm_ != nullptr;
+    }
+#endif
+    worker_to_controller_pipe_.Write(&accepted, sizeof(accepted));
+#if defined(__linux__) || defined(__ANDROID__)
+    if (accepted) UseSharedMemory();
+#endif
+  }
+
+  void Send(const TVMArgs& args) { controler_to_worker_->Send(args); }
+  TVMArgs Recv() { return controler_to_worker_->Recv(); }
+  void Reply(const TVMArgs& args) { worker_to_controler_->Send(args); }
+  TVMArgs RecvReply() { return worker_to_controler_->Recv(); }
 
   support::Pipe controller_to_worker_pipe_;
   support::Pipe worker_to_controller_pipe_;
-  DiscoStreamMessageQueue controler_to_worker_;
-  DiscoStreamMessageQueue worker_to_controler_;
+#if defined(__linux__) || defined(__ANDROID__)
+  std::shared_ptr<DiscoSharedMemory> shm_;
+#endif
+  std::unique_ptr<DiscoStreamMessageQueue> controler_to_worker_;
+  std::unique_ptr<DiscoStreamMessageQueue> worker_to_controler_;
+
+ private:
+#if defined(__linux__) || defined(__ANDROID__)
+  /*! \brief Exchange the messages through the mapped segment instead of the pipes. */
+  void UseSharedMemory() {
+    controler_to_worker_ = std::make_unique<DiscoStreamMessageQueue>(
+        shm_->controller_to_worker_stream_.get(), shm_->controller_to_worker_pool_.get());
+    worker_to_controler_ = std::make_unique<DiscoStreamMessageQueue>(
+        shm_->worker_to_controller_stream_.get(), shm_->worker_to_controller_pool_.get());
+  }
+
+  /*! \brief The segment offered to the worker, until it answers. */
+  int offered_shm_fd_ = -1;
+#endif
+  std::vector<int> pipe_fds_;
 };
 
 class ProcessSessionObj final : public BcastSessionObj {
  public:
+  /*!
+   * \brief Launch the worker processes.
+   * \param num_workers The number of workers.
+   * \param num_groups The number of worker groups.
+   * \param process_pool The process pool which launches the workers.
+   */
   explicit ProcessSessionObj(int num_workers, int num_groups, PackedFunc process_pool)
       : process_pool_(process_pool),
         worker_0_(
@@ -78,6 +410,11 @@ class ProcessSessionObj final : public BcastSessionObj {
     }
     for (int i = 0; i < num_workers - 1; ++i) {
       workers_.emplace_back(std::make_unique<DiscoProcessChannel>(write_fds[i], read_fds[i]));
+      workers_.back()->OfferSharedMemory();
+    }
+    // The workers start concurrently, so all the offers are made before waiting for them.
+    for (std::unique_ptr<DiscoProcessChannel>& channel : workers_) {
+      channel->FinishSharedMemoryOffer();
     }
   }
 
@@ -198,6 +535,7 @@ void WorkerProcess(int worker_id, int num_workers, int num_group, int64_t read_f
   CHECK_EQ(num_workers % num_group, 0)
       << "The number of workers should be divisible by the number of worker group.";
   DiscoProcessChannel channel(read_fd, write_fd);
+  channel.AcceptSharedMemory();
   DiscoWorker worker(worker_id, num_workers, num_group, nullptr, &channel);
   worker.MainLoop();
 }
@@ -26,6 +26,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
@@ -38,6 +39,35 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief A region shared by the two ends of a message channel, through which the
+ * NDArrays are passed as handles instead of being serialized into the messages.
+ * The sender copies each array into the pool, and the receiver gets a view of it, whose
+ * space goes back to the sender once the view is freed.
+ */
+class DiscoNDArrayPool {
+ public:
+  virtual ~DiscoNDArrayPool() = default;
+  /*! \return The capacity of the pool in bytes. Larger arrays are serialized instead. */
+  virtual uint64_t capacity() const = 0;
+  /*!
+   * \brief Allocate space on the sending side, without waiting for the receiver to free any.
+   * \param nbytes The number of bytes to allocate.
+   * \param handle The handle of the allocated space.
+   * \param data The address of the allocated space.
+   * \return Whether the space is allocated, false if the pool does not have enough free space.
+   */
+  virtual bool TryAllocate(uint64_t nbytes, uint64_t* handle, void** data) = 0;
+  /*!
+   * \brief Get a view of an allocated space on the receiving side.
+   * \param handle The handle of the allocated space.
+   * \param shape The shape of the array.
+   * \param dtype The data type of the array.
+   * \return The CPU array on the space, which is freed for the sender with the array.
+   */
+  virtual NDArray View(uint64_t handle, ShapeTuple shape, DLDataType dtype) = 0;
+};
+
 /*!
  * \brief The communication protocol used by Disco message channel.
  * \tparam SubClassType The subclass type that inherits this protocol.
@@ -63,6 +93,9 @@ struct DiscoProtocol {
   /*! \brief Read the object from stream. Used by RPCReference. */
   inline void ReadObject(int* tcode, TVMValue* value);
 
+  /*! \brief Whether the data of a debug object can be passed through the NDArray pool. */
+  inline bool UseNDArrayPool(const TVMRetValue& data) const;
+
   /*! \brief Callback method used when starting a new message. Used by RPCReference. */
   void MessageStart(uint64_t packet_nbytes) {}
 
@@ -81,8 +114,25 @@ struct DiscoProtocol {
     return arena_.template allocate_<T>(count);
   }
 
+  /*! \brief An array of the message being written, which is allocated in the pool. */
+  struct PooledArray {
+    /*! \brief The debug object of the array. */
+    const Object* obj;
+    /*! \brief The handle of the space allocated for the array. */
+    uint64_t handle;
+    /*! \brief The address of the space allocated for the array. */
+    void* data;
+  };
+
   support::Arena arena_;
   std::vector<ObjectRef> object_arena_;
+  /*! \brief The pool to pass NDArrays through, or nullptr to serialize them. */
+  DiscoNDArrayPool* ndarray_pool_ = nullptr;
+  /*!
+   * \brief The arrays allocated in the pool when the message size is computed, which are
+   *  written in the same order. The others are serialized into the message.
+   */
+  std::deque<PooledArray> pooled_arrays_;
   friend struct RPCReference;
 };
 
@@ -131,6 +181,20 @@ inline uint64_t DiscoProtocol<SubClassType>::GetObjectBytes(Object* obj) {
     uint64_t ndim = static_cast<ShapeTupleObj*>(obj)->size;
     return sizeof(uint32_t) + sizeof(uint64_t) + ndim * sizeof(ShapeTupleObj::index_type);
   } else if (obj->IsInstance<DiscoDebugObject>()) {
+    const TVMRetValue& data = static_cast<DiscoDebugObject*>(obj)->data;
+    // The pool does not wait for the receiver to free space, as the receiver may hold the
+    // arrays of earlier messages, or the space may be taken by this message. The arrays that
+    // do not fit are serialized instead.
+    uint64_t handle = 0;
+    void* pool_data = nullptr;
+    if (UseNDArrayPool(data) &&
+        ndarray_pool_->TryAllocate(GetDataSize(*data.operator NDArray().operator->()), &handle,
+                                   &pool_data)) {
+      pooled_arrays_.push_back(PooledArray{obj, handle, pool_data});
+      int ndim = data.operator NDArray()->ndim;
+      return sizeof(uint32_t) + sizeof(uint64_t) + sizeof(DLDataType) + sizeof(int32_t) +
+             ndim * sizeof(int64_t);
+    }
     return sizeof(uint32_t) + static_cast<DiscoDebugObject*>(obj)->GetObjectBytes();
   } else {
     LOG(FATAL) << "ValueError: Object type is not supported in Disco calling convention: "
@@ -154,6 +218,17 @@ inline void DiscoProtocol<SubClassType>::WriteObject(Object* obj) {
     self->template Write<uint32_t>(TypeIndex::kRuntimeShapeTuple);
     self->template Write<uint64_t>(shape->size);
     self->template WriteArray<ShapeTupleObj::index_type>(shape->data, shape->size);
+  } else if (obj->IsInstance<DiscoDebugObject>() && !pooled_arrays_.empty() &&
+             pooled_arrays_.front().obj == obj) {
+    PooledArray pooled = pooled_arrays_.front();
+    pooled_arrays_.pop_front();
+    NDArray array = static_cast<DiscoDebugObject*>(obj)->data;
+    array.CopyToBytes(pooled.data, GetDataSize(*array.operator->()));
+    self->template Write<uint32_t>(TypeIndex::kRuntimeNDArray);
+    self->template Write<uint64_t>(pooled.handle);
+    self->template Write<DLDataType>(array->dtype);
+    self->template Write<int32_t>(array->ndim);
+    self->template WriteArray<int64_t>(array->shape, array->ndim);
   } else if (obj->IsInstance<DiscoDebugObject>()) {
     self->template Write<uint32_t>(TypeIndex::kRoot);
     std::string str = static_cast<DiscoDebugObject*>(obj)->SaveToStr();
@@ -188,6 +263,17 @@ inline void DiscoProtocol<SubClassType>::ReadObject(int* tcode, TVMValue* value)
     std::vector<ShapeTupleObj::index_type> data(ndim);
     self->template ReadArray<ShapeTupleObj::index_type>(data.data(), ndim);
     result = ShapeTuple(std::move(data));
+  } else if (type_index == TypeIndex::kRuntimeNDArray) {
+    ICHECK(ndarray_pool_ != nullptr) << "InternalError: No NDArray pool to receive the array from";
+    uint64_t handle = 0;
+    DLDataType dtype;
+    int32_t ndim = 0;
+    self->template Read<uint64_t>(&handle);
+    self->template Read<DLDataType>(&dtype);
+    self->template Read<int32_t>(&ndim);
+    std::vector<ShapeTupleObj::index_type> shape(ndim);
+    self->template ReadArray<int64_t>(shape.data(), ndim);
+    result = ndarray_pool_->View(handle, ShapeTuple(std::move(shape)), dtype);
   } else if (type_index == TypeIndex::kRoot) {
     uint64_t size = 0;
     self->template Read<uint64_t>(&size);
@@ -202,6 +288,16 @@ inline void DiscoProtocol<SubClassType>::ReadObject(int* tcode, TVMValue* value)
   object_arena_.push_back(result);
 }
 
+template <class SubClassType>
+inline bool DiscoProtocol<SubClassType>::UseNDArrayPool(const TVMRetValue& data) const {
+  if (ndarray_pool_ == nullptr || data.type_code() != kTVMNDArrayHandle) {
+    return false;
+  }
+  NDArray array = data;
+  return array->device.device_type == kDLCPU && array.IsContiguous() &&
+         GetDataSize(*array.operator->()) <= ndarray_pool_->capacity();
+}
+
 inline std::string DiscoDebugObject::SaveToStr() const {
   if (this->data.type_code() == kTVMObjectHandle) {
     ObjectRef obj = this->data;
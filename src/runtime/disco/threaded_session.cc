@@ -20,6 +20,7 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/object.h>
+#include <tvm/runtime/tracing.h>
 
 #include <condition_variable>
 #include <cstdint>
@@ -41,6 +42,7 @@ class DiscoThreadedMessageQueue : private dmlc::Stream,
                                   private DiscoProtocol<DiscoThreadedMessageQueue> {
  public:
   void Send(const TVMArgs& args) {
+    profiling::TraceScope trace("disco", "SendMessage");
     RPCReference::ReturnPackedSeq(args.values, args.type_codes, args.num_args, this);
     CommitSendAndNotifyEnqueue();
   }
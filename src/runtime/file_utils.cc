@@ -24,12 +24,24 @@
 
 #include <dmlc/json.h>
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -185,15 +197,55 @@ Map<String, NDArray> LoadParams(const std::string& param_blob) {
   dmlc::MemoryStringStream strm(const_cast<std::string*>(&param_blob));
   return LoadParams(&strm);
 }
+/*!
+ * \brief The offset of the data in a tensor saved by SaveDLTensor: the magic, reserved field,
+ *  device, ndim and dtype, then the shape and the data size.
+ */
+inline size_t SavedDLTensorDataOffset(int ndim) {
+  return sizeof(uint64_t) * 2 + sizeof(DLDevice) + sizeof(int) + sizeof(DLDataType) +
+         sizeof(int64_t) * ndim + sizeof(int64_t);
+}
+
+/*! \brief The size of the indexed parameters format before the first parameter. */
+inline size_t IndexedParamsHeaderSize(const std::vector<std::string>& names) {
+  size_t size = sizeof(uint64_t) * 2 + sizeof(uint64_t);
+  for (const std::string& name : names) {
+    size += sizeof(uint64_t) + name.size();
+  }
+  return size + sizeof(uint64_t) + sizeof(uint64_t) * names.size();
+}
+
 Map<String, NDArray> LoadParams(dmlc::Stream* strm) {
   Map<String, NDArray> params;
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
-  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic || header == kTVMNDArrayIndexedListMagic)
+      << "Invalid parameters file format";
   ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
 
   std::vector<std::string> names;
   ICHECK(strm->Read(&names)) << "Invalid parameters file format";
+  if (header == kTVMNDArrayIndexedListMagic) {
+    ICHECK_EQ(reserved, kTVMNDArrayIndexedListVersion)
+        << "Unsupported version of the indexed parameters format";
+    std::vector<uint64_t> offsets;
+    ICHECK(strm->Read(&offsets) && offsets.size() == names.size())
+        << "Invalid parameters file format";
+    // Skip the padding between the parameters, which is only needed when mapping the file.
+    size_t pos = IndexedParamsHeaderSize(names);
+    std::vector<char> padding(kAllocAlignment);
+    for (size_t i = 0; i < names.size(); ++i) {
+      ICHECK(offsets[i] >= pos && offsets[i] - pos <= padding.size())
+          << "Invalid parameters file format";
+      ICHECK_EQ(strm->Read(padding.data(), offsets[i] - pos), offsets[i] - pos)
+          << "Invalid parameters file format";
+      NDArray temp;
+      ICHECK(temp.Load(strm)) << "Invalid parameters file format";
+      pos = offsets[i] + SavedDLTensorDataOffset(temp->ndim) + GetDataSize(*temp.operator->());
+      params.Set(names[i], temp);
+    }
+    return params;
+  }
   uint64_t sz;
   strm->Read(&sz);
   size_t size = static_cast<size_t>(sz);
@@ -228,6 +280,133 @@ void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
   }
 }
 
+void SaveIndexedParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
+  std::vector<std::string> names;
+  std::vector<const DLTensor*> arrays;
+  for (auto& p : params) {
+    names.push_back(p.first);
+    arrays.push_back(p.second.operator->());
+  }
+  // Place each parameter so that its data starts at an aligned file offset.
+  std::vector<uint64_t> offsets;
+  size_t pos = IndexedParamsHeaderSize(names);
+  for (const DLTensor* array : arrays) {
+    size_t data_offset = pos + SavedDLTensorDataOffset(array->ndim);
+    size_t padding = (kAllocAlignment - data_offset % kAllocAlignment) % kAllocAlignment;
+    offsets.push_back(pos + padding);
+    pos = data_offset + padding + GetDataSize(*array);
+  }
+
+  uint64_t header = kTVMNDArrayIndexedListMagic, version = kTVMNDArrayIndexedListVersion;
+  strm->Write(header);
+  strm->Write(version);
+  strm->Write(names);
+  strm->Write(offsets);
+  pos = IndexedParamsHeaderSize(names);
+  const std::vector<char> padding(kAllocAlignment, 0);
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    strm->Write(padding.data(), offsets[i] - pos);
+    tvm::runtime::SaveDLTensor(strm, arrays[i]);
+    pos = offsets[i] + SavedDLTensorDataOffset(arrays[i]->ndim) + GetDataSize(*arrays[i]);
+  }
+}
+
+#ifndef _WIN32
+/*! \brief A read-only mapping of a whole file. */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    ICHECK_NE(fd, -1) << "Cannot open " << path << ": " << std::strerror(errno);
+    struct stat st;
+    ICHECK_EQ(fstat(fd, &st), 0) << "Cannot stat " << path << ": " << std::strerror(errno);
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ != 0) {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    ICHECK(data_ != MAP_FAILED) << "Cannot mmap " << path << ": " << std::strerror(errno);
+  }
+  ~MappedFile() {
+    if (data_ != nullptr) munmap(data_, size_);
+  }
+  char* data() const { return static_cast<char*>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  void* data_{nullptr};
+  size_t size_{0};
+};
+
+/*! \brief An NDArray container which keeps the mapped file of its data alive. */
+class MappedNDArrayContainer : public NDArray::Container {
+ public:
+  MappedNDArrayContainer(std::shared_ptr<MappedFile> file, void* data, ShapeTuple shape,
+                         DLDataType dtype)
+      : NDArray::Container(data, std::move(shape), dtype, Device{kDLCPU, 0}),
+        file_(std::move(file)) {
+    SetDeleter(Deleter);
+  }
+
+ private:
+  static void Deleter(Object* container) {
+    delete static_cast<MappedNDArrayContainer*>(container);
+  }
+
+  std::shared_ptr<MappedFile> file_;
+};
+#endif
+
+Map<String, NDArray> LoadParamsFromMappedFile(const std::string& path) {
+#if !defined(_WIN32) && DMLC_IO_NO_ENDIAN_SWAP
+  auto file = std::make_shared<MappedFile>(path);
+  dmlc::MemoryFixedSizeStream header_strm(file->data(), file->size());
+  uint64_t header, version;
+  if (header_strm.Read(&header) && header == kTVMNDArrayIndexedListMagic) {
+    ICHECK(header_strm.Read(&version)) << "Invalid parameters file format";
+    ICHECK_EQ(version, kTVMNDArrayIndexedListVersion)
+        << "Unsupported version of the indexed parameters format";
+    std::vector<std::string> names;
+    std::vector<uint64_t> offsets;
+    ICHECK(header_strm.Read(&names) && header_strm.Read(&offsets) &&
+           offsets.size() == names.size())
+        << "Invalid parameters file format";
+    Map<String, NDArray> params;
+    for (size_t i = 0; i < names.size(); ++i) {
+      ICHECK_LE(offsets[i], file->size()) << "Invalid parameters file format";
+      dmlc::MemoryFixedSizeStream tensor_strm(file->data() + offsets[i],
+                                              file->size() - offsets[i]);
+      uint64_t magic, reserved, data_byte_size;
+      DLDevice dev;
+      int ndim;
+      DLDataType dtype;
+      ICHECK(tensor_strm.Read(&magic) && magic == kTVMNDArrayMagic &&
+             tensor_strm.Read(&reserved) && tensor_strm.Read(&dev) && tensor_strm.Read(&ndim) &&
+             tensor_strm.Read(&dtype) && ndim >= 0)
+          << "Invalid parameters file format";
+      std::vector<int64_t> shape(ndim);
+      if (ndim != 0) {
+        ICHECK(tensor_strm.ReadArray(shape.data(), ndim)) << "Invalid parameters file format";
+      }
+      ICHECK(tensor_strm.Read(&data_byte_size)) << "Invalid parameters file format";
+      size_t data_offset = offsets[i] + SavedDLTensorDataOffset(ndim);
+      ICHECK_LE(data_offset + data_byte_size, file->size()) << "Invalid parameters file format";
+      char* data = file->data() + data_offset;
+      ICHECK_EQ(reinterpret_cast<uintptr_t>(data) % kAllocAlignment, 0)
+          << "Invalid parameters file format";
+      auto* container = new MappedNDArrayContainer(file, data, ShapeTuple(shape), dtype);
+      NDArray array(GetObjectPtr<Object>(container));
+      ICHECK_EQ(data_byte_size, GetDataSize(*array.operator->()))
+          << "Invalid parameters file format";
+      params.Set(names[i], array);
+    }
+    return params;
+  }
+#endif
+  SimpleBinaryFileStream strm(path, "rb");
+  return LoadParams(&strm);
+}
+
 std::string SaveParams(const Map<String, NDArray>& params) {
   std::string bytes;
   dmlc::MemoryStringStream strm(&bytes);
@@ -250,6 +429,12 @@ TVM_REGISTER_GLOBAL("runtime.SaveParamsToFile")
       SaveParams(&strm, params);
     });
 
+TVM_REGISTER_GLOBAL("runtime.SaveIndexedParamsToFile")
+    .set_body_typed([](const Map<String, NDArray>& params, const String& path) {
+      tvm::runtime::SimpleBinaryFileStream strm(path, "wb");
+      SaveIndexedParams(&strm, params);
+    });
+
 TVM_REGISTER_GLOBAL("runtime.LoadParams").set_body_typed([](const String& s) {
   return ::tvm::runtime::LoadParams(s);
 });
@@ -259,5 +444,9 @@ TVM_REGISTER_GLOBAL("runtime.LoadParamsFromFile").set_body_typed([](const String
   return LoadParams(&strm);
 });
 
+TVM_REGISTER_GLOBAL("runtime.LoadParamsFromMappedFile").set_body_typed([](const String& path) {
+  return LoadParamsFromMappedFile(path);
+});
+
 }  // namespace runtime
 }  // namespace tvm
@@ -105,6 +105,16 @@ void CopyFile(const std::string& src_file_name, const std::string& dest_file_nam
 void RemoveFile(const std::string& file_name);
 
 constexpr uint64_t kTVMNDArrayListMagic = 0xF7E58D4F05049CB7;
+/*!
+ * \brief Magic number of the indexed parameters format, which can be memory mapped.
+ *
+ *  The format is the magic, a version, the parameter names and the file offset of each
+ *  parameter, followed by the parameters in the format of SaveDLTensor. Each parameter is
+ *  padded so that its data is aligned to kAllocAlignment within the file.
+ */
+constexpr uint64_t kTVMNDArrayIndexedListMagic = 0xF7E58D4F05049CB9;
+/*! \brief The version of the indexed parameters format. */
+constexpr uint64_t kTVMNDArrayIndexedListVersion = 1;
 /*!
  * \brief Load parameters from a string.
  * \param param_blob Serialized string of parameters.
@@ -129,6 +139,23 @@ std::string SaveParams(const Map<String, NDArray>& params);
  * \param params Parameters to save.
  */
 void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
+/*!
+ * \brief Serialize parameters to a stream in the indexed format, which can be loaded with
+ *  LoadParamsFromMappedFile when written to a file.
+ * \param strm Stream to write to, which must be at the beginning of the file.
+ * \param params Parameters to save.
+ */
+void SaveIndexedParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
+/*!
+ * \brief Load parameters from a file by memory mapping it.
+ *
+ *  The parameters of a file in the indexed format are CPU arrays backed by a private mapping
+ *  of the file, so that they share the page cache until they are written. Other files, or
+ *  platforms without mmap, fall back to LoadParams.
+ * \param path The path of the parameters file.
+ * \return Map of parameter name to parameter value.
+ */
+Map<String, NDArray> LoadParamsFromMappedFile(const std::string& path);
 
 /*!
  * \brief A dmlc stream which wraps standard file operations.
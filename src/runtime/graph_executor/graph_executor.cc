@@ -34,6 +34,7 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/tracing.h>
 
 #include <algorithm>
 #include <functional>
@@ -45,6 +46,7 @@
 #include <vector>
 
 #include "../file_utils.h"
+#include "../library_module.h"
 #include "../texture.h"
 
 namespace tvm {
@@ -64,7 +66,10 @@ constexpr auto Is2DStorage = IsTextureStorage;
 void GraphExecutor::Run() {
   // setup the array and requirements.
   for (size_t i = 0; i < op_execs_.size(); ++i) {
-    if (op_execs_[i]) op_execs_[i]();
+    if (op_execs_[i]) {
+      profiling::TraceScope trace("graph_executor", nodes_[i].param.func_name);
+      op_execs_[i]();
+    }
   }
 }
 
@@ -91,6 +96,15 @@ void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module mod
         [this](TVMArgs args, TVMRetValue* rv) { this->DefaultLookupLinkedParam(args, rv); });
   }
   this->SetupStorage();
+  // Resolve the kernels in one pass, which later executors of the module find cached.
+  std::vector<String> func_names;
+  for (const Node& node : nodes_) {
+    if (node.op_type == "tvm_op" && node.param.func_name != "__nop" &&
+        node.param.func_name != "__copy") {
+      func_names.push_back(node.param.func_name);
+    }
+  }
+  PrelinkLibraryModules(module_, func_names);
   this->SetupOpExecs();
   for (size_t i = 0; i < input_nodes_.size(); i++) {
     const uint32_t nid = input_nodes_[i];
@@ -325,27 +339,69 @@ void GraphExecutor::LoadParams(dmlc::Stream* strm) {
   }
 }
 
+void GraphExecutor::MapParams(const std::string& path) {
+  Map<String, NDArray> params = ::tvm::runtime::LoadParamsFromMappedFile(path);
+  bool bound = false;
+  for (auto& p : params) {
+    param_names_.insert(p.first);
+    int in_idx = GetInputIndex(p.first);
+    if (in_idx < 0) continue;
+    uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
+    const DLTensor* entry = data_entry_[eid].operator->();
+    const DLTensor* param = p.second.operator->();
+    // The loaded array can replace the planned storage when it has the same device and layout,
+    // and no other entry is planned into that storage.
+    bool can_bind = entry->device.device_type == param->device.device_type &&
+                    entry->device.device_id == param->device.device_id &&
+                    entry->ndim == param->ndim &&
+                    std::equal(entry->shape, entry->shape + entry->ndim, param->shape) &&
+                    TypeEqual(entry->dtype, param->dtype) && param->strides == nullptr &&
+                    reinterpret_cast<uintptr_t>(param->data) % kAllocAlignment == 0 &&
+                    sid_to_eid_[attrs_.storage_id[eid]].size() == 1;
+    if (can_bind) {
+      BindParam(eid, p.second);
+      bound = true;
+    } else {
+      data_entry_[eid].CopyFrom(p.second);
+    }
+  }
+  if (bound) this->SetupOpExecs();
+}
+
+void GraphExecutor::BindParam(uint32_t eid, const NDArray& param) {
+  ICHECK_LT(eid, data_entry_.size());
+  data_entry_[eid] = param;
+  const DLTensor* tmp = data_entry_[eid].operator->();
+  data_alignment_[eid] = details::GetDataAlignment(*tmp);
+  // Release the planned storage once no entry refers to it anymore.
+  uint32_t sid = attrs_.storage_id[eid];
+  if (sid_to_eid_[sid].size() == 1) {
+    storage_pool_[sid] = param;
+  }
+}
+
 void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm) {
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
-  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic || header == kTVMNDArrayIndexedListMagic)
+      << "Invalid parameters file format";
   ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
   std::vector<std::string> names;
   ICHECK(strm->Read(&names)) << "Invalid parameters file format";
-  uint64_t sz;
-  strm->Read(&sz);
-  size_t size = static_cast<size_t>(sz);
-  ICHECK(size == names.size()) << "Invalid parameters file format";
-  for (size_t i = 0; i < size; ++i) {
+  if (header == kTVMNDArrayListMagic) {
+    uint64_t sz;
+    strm->Read(&sz);
+    size_t size = static_cast<size_t>(sz);
+    ICHECK(size == names.size()) << "Invalid parameters file format";
+  }
+  for (size_t i = 0; i < names.size(); ++i) {
     int in_idx = GetInputIndex(names[i]);
     if (in_idx < 0) continue;
     uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
     ICHECK_LT(eid, data_entry_.size());
     ICHECK_EQ(data_entry_[eid].use_count(), 1);
-    data_entry_[eid] = other.GetInput(GetInputIndex(names[i]));
+    BindParam(eid, other.GetInput(GetInputIndex(names[i])));
     ICHECK_GT(data_entry_[eid].use_count(), 1);
-    const DLTensor* tmp = data_entry_[eid].operator->();
-    data_alignment_[eid] = details::GetDataAlignment(*tmp);
   }
   this->SetupOpExecs();
 }
@@ -740,6 +796,10 @@ PackedFunc GraphExecutor::GetFunction(const String& name, const ObjectPtr<Object
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       this->LoadParams(args[0].operator std::string());
     });
+  } else if (name == "map_params") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->MapParams(args[0].operator std::string());
+    });
   } else if (name == "share_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       const auto& module = args[0].operator Module();
@@ -197,6 +197,13 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param param_blob A binary blob of parameter.
    */
   void LoadParams(const std::string& param_blob);
+  /*!
+   * \brief Load parameters from a file by memory mapping it, see LoadParamsFromMappedFile.
+   *  Instead of being copied, the mapped parameters become the storage of their inputs where
+   *  possible, so that executors mapping the same file share its pages.
+   * \param path The path of the parameters file.
+   */
+  void MapParams(const std::string& path);
 
   /*!
    * \brief Share parameters from pre-existing GraphExecutor instance.
@@ -428,6 +435,13 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   void SetupStorage();
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*!
+   * \brief Use a parameter array as the data entry instead of its planned storage.
+   *  The executors need to be setup again afterwards.
+   * \param eid The data entry index of the parameter.
+   * \param param The parameter array.
+   */
+  void BindParam(uint32_t eid, const NDArray& param);
   /*!
    * \brief Check the legality of external DLTensor*.
    * \param external The external DLTensor*.
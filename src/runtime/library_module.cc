@@ -27,7 +27,10 @@
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -48,6 +51,40 @@ class LibraryModuleNode final : public ModuleNode {
   };
 
   PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    TVMBackendPackedCFunc faddr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      faddr = Resolve(name);
+    }
+    if (faddr == nullptr) return PackedFunc();
+    return packed_func_wrapper_(faddr, sptr_to_self);
+  }
+
+  /*!
+   * \brief Resolve the symbols of functions in one pass.
+   * \param names The names of the functions.
+   */
+  void Prelink(const std::vector<String>& names) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const String& name : names) {
+      Resolve(name);
+    }
+  }
+
+ private:
+  /*!
+   * \brief Look up the address of a function, resolving its symbol only the first time.
+   *  The addresses are cached instead of the wrapped functions, which would keep the module
+   *  alive through sptr_to_self. Misses are not cached, as the symbol may be registered
+   *  later, and neither are the symbols of libraries that can change them.
+   * \note The caller must hold mutex_.
+   */
+  TVMBackendPackedCFunc Resolve(const String& name) {
+    bool use_cache = lib_->HasFixedSymbols();
+    if (use_cache) {
+      auto it = symbol_cache_.find(name);
+      if (it != symbol_cache_.end()) return it->second;
+    }
     TVMBackendPackedCFunc faddr;
     if (name == runtime::symbol::tvm_module_main) {
       const char* entry_name =
@@ -58,15 +95,42 @@ class LibraryModuleNode final : public ModuleNode {
     } else {
       faddr = reinterpret_cast<TVMBackendPackedCFunc>(lib_->GetSymbol(name.c_str()));
     }
-    if (faddr == nullptr) return PackedFunc();
-    return packed_func_wrapper_(faddr, sptr_to_self);
+    if (use_cache && faddr != nullptr) {
+      symbol_cache_.emplace(name, faddr);
+    }
+    return faddr;
   }
 
- private:
   ObjectPtr<Library> lib_;
   PackedFuncWrapper packed_func_wrapper_;
+  /*! \brief The resolved function addresses. */
+  std::unordered_map<std::string, TVMBackendPackedCFunc> symbol_cache_;
+  /*! \brief Protects symbol_cache_, as executors may look up functions concurrently. */
+  std::mutex mutex_;
 };
 
+void PrelinkLibraryModules(const Module& mod, const std::vector<String>& names) {
+  std::unordered_set<const ModuleNode*> visited{mod.operator->()};
+  std::vector<const ModuleNode*> stack{mod.operator->()};
+  while (!stack.empty()) {
+    const ModuleNode* node = stack.back();
+    stack.pop_back();
+    if (const auto* lib = dynamic_cast<const LibraryModuleNode*>(node)) {
+      const_cast<LibraryModuleNode*>(lib)->Prelink(names);
+    }
+    for (const Module& m : node->imports()) {
+      if (visited.insert(m.operator->()).second) {
+        stack.push_back(m.operator->());
+      }
+    }
+  }
+}
+
+TVM_REGISTER_GLOBAL("runtime.ModulePrelink")
+    .set_body_typed([](Module mod, Array<String> names) {
+      PrelinkLibraryModules(mod, std::vector<String>(names.begin(), names.end()));
+    });
+
 PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
   return PackedFunc([faddr, sptr_to_self](TVMArgs args, TVMRetValue* rv) {
     TVMValue ret_value;
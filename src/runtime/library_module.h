@@ -62,6 +62,11 @@ class Library : public Object {
    * \return The symbol.
    */
   virtual void* GetSymbol(const char* name) = 0;
+  /*!
+   * \brief Whether the address of a symbol stays the same once it is found, so that the
+   *  lookups can be cached. Libraries whose symbols are registered at runtime return false.
+   */
+  virtual bool HasFixedSymbols() const { return true; }
   // NOTE: we do not explicitly create an type index and type_key here for libary.
   // This is because we do not need dynamic type downcasting.
 };
@@ -119,6 +124,17 @@ ObjectPtr<Library> CreateDSOLibraryObject(std::string library_path);
  *       by parsing the binary blob section of the library.
  */
 Module CreateModuleFromLibrary(ObjectPtr<Library> lib, PackedFuncWrapper wrapper = WrapPackedFunc);
+
+/*!
+ * \brief Resolve the symbols of functions in the library modules among a module and its
+ *  imports in one pass. Library modules cache the resolved symbols, so that later lookups of
+ *  the functions, e.g. by other executors of the same module, skip the symbol resolution.
+ *  Missing symbols and the symbols of the system library are not cached.
+ *
+ * \param mod The module.
+ * \param names The names of the functions.
+ */
+void PrelinkLibraryModules(const Module& mod, const std::vector<String>& names);
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_LIBRARY_MODULE_H_
@@ -103,9 +103,13 @@ NDArray StorageObj::AllocNDArray(int64_t offset, ShapeTuple shape, DLDataType dt
   // buffer intact.
   container->manager_ctx = reinterpret_cast<void*>(this);
 
-  if (this->buffer.device.device_type == kDLHexagon) {
-    // For Hexagon, non-zero offset support simply requires adjusting the
-    // beginning of data pointer
+  if (this->buffer.device.device_type == kDLHexagon ||
+      (offset % kAllocAlignment == 0 &&
+       DeviceAPI::Get(this->buffer.device)->SupportsDevicePointerArithmeticsOnHost())) {
+    // For Hexagon and the devices that support pointer arithmetics on host,
+    // non-zero offset support simply requires adjusting the beginning of data
+    // pointer. This lets kernels that expect a zero byte offset consume the
+    // tensors carved out of a planned memory arena.
     auto offset_ptr = reinterpret_cast<uint8_t*>(this->buffer.data) + offset;
     container->dl_tensor.data = reinterpret_cast<void*>(offset_ptr);
     container->dl_tensor.byte_offset = 0;
@@ -25,6 +25,7 @@
 
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/tracing.h>
 
 #include <atomic>
 #include <string>
@@ -38,6 +39,7 @@ class NaiveAllocator final : public Allocator {
   explicit NaiveAllocator() : Allocator(kNaive), used_memory_(0) {}
 
   Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    profiling::TraceScope trace("allocator", "NaiveAllocator::Alloc");
     Buffer buf;
     buf.device = dev;
     buf.size = nbytes;
@@ -75,6 +77,7 @@ class NaiveAllocator final : public Allocator {
   }
 
   void Free(const Buffer& buffer) override {
+    profiling::TraceScope trace("allocator", "NaiveAllocator::Free");
     DeviceAPI::Get(buffer.device)->FreeDataSpace(buffer.device, buffer.data);
     used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
     DLOG(INFO) << "free " << buffer.size << " B, used memory " << used_memory_ << " B";
@@ -25,6 +25,7 @@
 
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/tracing.h>
 
 #include <atomic>
 #include <mutex>
@@ -46,6 +47,7 @@ class PooledAllocator : public Allocator {
   ~PooledAllocator() { ReleaseAll(); }
 
   Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    profiling::TraceScope trace("allocator", "PooledAllocator::Alloc");
     std::lock_guard<std::recursive_mutex> lock(mu_);
     size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
     auto&& it = memory_pool_.find(size);
@@ -83,6 +85,7 @@ class PooledAllocator : public Allocator {
   }
 
   void Free(const Buffer& buffer) override {
+    profiling::TraceScope trace("allocator", "PooledAllocator::Free");
     std::lock_guard<std::recursive_mutex> lock(mu_);
     if (memory_pool_.find(buffer.size) == memory_pool_.end()) {
       memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
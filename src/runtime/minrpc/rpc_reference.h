@@ -70,6 +70,9 @@ enum class RPCCode : int {
   kDevFreeStream,
   kDevSetStream,
   kDevGetCurrentStream,
+  // The bulk data copies with compressed payloads, only sent to servers that support them.
+  kCopyToRemoteCompressed,
+  kCopyFromRemoteCompressed,
 };
 
 /*!
@@ -134,6 +137,10 @@ inline const char* RPCCodeToString(RPCCode code) {
       return "kCopyAmongRemote";
     case RPCCode::kDevAllocDataWithScope:
       return "kDevAllocDataWithScope";
+    case RPCCode::kCopyToRemoteCompressed:
+      return "kCopyToRemoteCompressed";
+    case RPCCode::kCopyFromRemoteCompressed:
+      return "kCopyFromRemoteCompressed";
     default:
       return "";
   }
@@ -60,6 +60,18 @@ TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_enable_sliding_window_for_seq
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::EnableSlidingWindowForSeq);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::CommitAcceptedTokenTreeNodes);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_enable_prefix_caching")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::EnablePrefixCaching);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_add_sequence_with_prefix")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::AddSequenceWithPrefix);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_enable_host_offloading")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::EnableHostOffloading);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_offload_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::OffloadSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_prefetch_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::PrefetchSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_residency_stats")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetResidencyStats);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_empty")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::Empty);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_num_available_pages")
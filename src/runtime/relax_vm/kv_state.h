@@ -157,6 +157,69 @@ class AttentionKVCacheObj : public KVStateObj {
   virtual void CommitAcceptedTokenTreeNodes(const IntTuple& seq_ids,
                                             const IntTuple& leaf_indices) = 0;
 
+  /************** Prefix Cache **************/
+
+  /*!
+   * \brief Enable or disable the automatic prefix caching.
+   * When enabled, the KV data of a removed sequence, for the leading
+   * tokens given by `AddSequenceWithPrefix`, is retained in the cache
+   * and reused by the later sequences sharing the same token prefix.
+   * The retained KV data is evicted in the least-recently-used order
+   * when the cache runs out of pages. Disabling the prefix caching
+   * releases all the retained KV data.
+   * \param enable Whether to enable the prefix caching.
+   */
+  virtual void EnablePrefixCaching(bool enable) = 0;
+
+  /*!
+   * \brief Add a new sequence with the given prompt token ids, reusing
+   * the KV data of the longest cached prefix of the tokens.
+   * \param seq_id The id of the new sequence to be added.
+   * \param token_ids The prompt token ids of the new sequence.
+   * \return The length of the prefix whose KV data is reused. It is always
+   * less than the number of the given tokens, and the caller is expected
+   * to run forward for the tokens after the prefix.
+   * \throws Error if the given sequence id is not valid.
+   */
+  virtual int64_t AddSequenceWithPrefix(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /************** Host Offloading **************/
+
+  /*!
+   * \brief Allocate the host memory for offloading the K/V data.
+   * \param num_host_pages The number of pages the host memory holds.
+   * Zero means releasing the host memory.
+   * \throws Error if some K/V data is currently offloaded.
+   */
+  virtual void EnableHostOffloading(int64_t num_host_pages) = 0;
+
+  /*!
+   * \brief Move the K/V data of the given sequence from device to host
+   * memory, and release the device pages. The K/V data shared with other
+   * sequences stays on device. The offloaded K/V data is brought back
+   * to device when the sequence is used next time.
+   * \param seq_id The sequence to offload.
+   * \throws Error if the given sequence id is not valid, or the host memory is full.
+   */
+  virtual void OffloadSequence(int64_t seq_id) = 0;
+
+  /*!
+   * \brief Asynchronously bring the offloaded K/V data of the given
+   * sequence back to device, so that the copy overlaps with the
+   * computation before the sequence's next forward.
+   * \param seq_id The sequence to prefetch.
+   * \throws Error if the given sequence id is not valid.
+   */
+  virtual void PrefetchSequence(int64_t seq_id) = 0;
+
+  /*!
+   * \brief Get the residency statistics of the K/V data, which is a tuple of
+   * `(num_device_pages_in_use, num_offloaded_pages, num_free_host_pages,
+   * num_swapped_out_pages, num_swapped_in_pages)`, where the last two are
+   * accumulated since the construction of the cache.
+   */
+  virtual IntTuple GetResidencyStats() const = 0;
+
   /************** Attention **************/
 
   /*!
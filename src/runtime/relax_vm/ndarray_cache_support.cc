@@ -33,17 +33,37 @@
  * There are likely other ways to load the parameters ndarray-ache.
  * We will keep the impact minimum by puting it as a private
  * runtime builtin provide as in this file.
+ *
+ * Shards are read ahead by a few reader threads while the calling
+ * thread decodes and copies the previous shards, with the amount of
+ * shard data held in memory bounded by a staging budget.
  */
 #define PICOJSON_USE_INT64
 #ifndef __STDC_FORMAT_MACROS
 #define __STDC_FORMAT_MACROS
 #endif
 #include <picojson.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/ndarray_cache_support.h>
+#include <tvm/runtime/threading_backend.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "../../support/utils.h"
@@ -165,40 +185,303 @@ void CopyNDArrayFromBytes(NDArray param, const void* data, size_t nbytes,
   TVMSynchronize(device.device_type, device.device_id, nullptr);
 }
 
-NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(
-    Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
-  NDArray arr = NDArray::Empty(shape, dtype, device);
-  if (dtype == DataType::Float(32) && format == "f32-to-bf16") {
+/*!
+ * \brief Load a parameter by copying it out of the raw bytes of its shard.
+ * \param rec The parameter record.
+ * \param device The device to load the parameter onto.
+ * \param raw_data The beginning of the raw bytes of the shard.
+ * \param staging_buffer The staging buffer, see ParamRecord::Load.
+ * \return The loaded parameter.
+ */
+NDArray CopyParamFromBytes(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec,
+                           Device device, const char* raw_data,
+                           Optional<NDArray>* staging_buffer) {
+  // The number of elements per task when decoding on the thread pool.
+  constexpr int64_t kDecodeChunkSize = 1 << 16;
+  NDArray arr = NDArray::Empty(rec.shape, rec.dtype, device);
+  if (rec.dtype == DataType::Float(32) && rec.format == "f32-to-bf16") {
     // decode bf16 to f32
-    std::vector<uint16_t> buffer(nbytes / 2);
-    std::vector<uint32_t> decoded(nbytes / 2);
-    std::memcpy(buffer.data(), raw_data->data() + byte_offset, nbytes);
-    for (size_t i = 0; i < buffer.size(); ++i) {
-      decoded[i] = static_cast<uint32_t>(buffer[i]) << 16;
+    std::vector<uint16_t> buffer(rec.nbytes / 2);
+    std::vector<uint32_t> decoded(rec.nbytes / 2);
+    std::memcpy(buffer.data(), raw_data + rec.byte_offset, rec.nbytes);
+    int64_t num_elems = buffer.size();
+    int64_t num_chunks = (num_elems + kDecodeChunkSize - 1) / kDecodeChunkSize;
+    auto f_decode_chunk = [&](int64_t chunk) {
+      int64_t end = std::min(num_elems, (chunk + 1) * kDecodeChunkSize);
+      for (int64_t i = chunk * kDecodeChunkSize; i < end; ++i) {
+        decoded[i] = static_cast<uint32_t>(buffer[i]) << 16;
+      }
+    };
+    if (num_chunks != 0) {
+      parallel_for_with_threading_backend(f_decode_chunk, 0, num_chunks);
     }
     CopyNDArrayFromBytes(arr, decoded.data(), decoded.size() * sizeof(uint32_t), staging_buffer);
   } else {
-    CopyNDArrayFromBytes(arr, raw_data->data() + byte_offset, nbytes, staging_buffer);
+    CopyNDArrayFromBytes(arr, raw_data + rec.byte_offset, rec.nbytes, staging_buffer);
   }
   return arr;
 }
 
+NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(
+    Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
+  return CopyParamFromBytes(*this, device, raw_data->data(), staging_buffer);
+}
+
 TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::Load(
     Device device,
     const std::string& path_prefix,  //
     std::string* raw_data_buffer,    //
     Optional<NDArray>* staging_buffer) const {
   LoadBinaryFromFile(path_prefix + "/" + this->data_path, raw_data_buffer);
+  return LoadFromBytes(device, *raw_data_buffer, staging_buffer);
+}
+
+TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::LoadFromBytes(
+    Device device, const std::string& raw_data, Optional<NDArray>* staging_buffer) const {
+  CHECK_EQ(this->format, "raw-shard") << "ValueError: Only `raw-shard` format is supported";
+  CHECK_EQ(this->nbytes, raw_data.length())
+      << "ValueError: Encountered an corrupted parameter shard. It means it is not downloaded "
+         "completely or downloading is interrupted. Please try to download again.";
+  Array<NDArray> result;
+  result.reserve(this->records.size());
+  for (const ParamRecord& nd_rec : this->records) {
+    result.push_back(nd_rec.Load(device, &raw_data, staging_buffer));
+  }
+  return result;
+}
+
+/*!
+ * \brief Read the shard files of an NDArray cache ahead of their consumption.
+ * \details A few reader threads read the shards concurrently, in the order of the metadata.
+ * The total size of the shards that are read but not yet released by the consumer is bounded
+ * by a staging budget, except that a single shard larger than the budget is still read when
+ * nothing else is staged.
+ */
+class ShardPrefetcher {
+ public:
+  ShardPrefetcher(const NDArrayCacheMetadata& metadata, int num_readers, int64_t max_staging_bytes)
+      : metadata_(metadata),
+        max_staging_bytes_(max_staging_bytes),
+        slots_(metadata.records.size()) {
+    num_readers = std::max(1, std::min<int>(num_readers, metadata.records.size()));
+    for (int i = 0; i < num_readers; ++i) {
+      readers_.emplace_back([this]() { this->ReaderLoop(); });
+    }
+  }
+
+  ~ShardPrefetcher() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& reader : readers_) {
+      reader.join();
+    }
+  }
+
+  /*!
+   * \brief Wait for the given shard to be read and take its content.
+   * \param index The index of the shard, shards must be taken in order.
+   * \return The content of the shard.
+   */
+  std::string Take(size_t index) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() { return slots_[index].ready; });
+    if (slots_[index].error) {
+      std::rethrow_exception(slots_[index].error);
+    }
+    return std::move(slots_[index].data);
+  }
+
+  /*!
+   * \brief Release the staging budget held by a shard after it is consumed.
+   * \param index The index of the shard.
+   */
+  void Release(size_t index) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      staging_bytes_ -= metadata_.records[index].nbytes;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  /*! \brief A shard being read. */
+  struct Slot {
+    bool ready{false};
+    std::string data;
+    std::exception_ptr error;
+  };
+
+  void ReaderLoop() {
+    while (true) {
+      size_t index;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopped_ || next_shard_ == slots_.size()) return;
+        index = next_shard_++;
+        int64_t nbytes = metadata_.records[index].nbytes;
+        // Shards are admitted in order, so the budget cannot be taken by later shards.
+        cv_.wait(lock, [&]() {
+          return stopped_ ||
+                 (index == next_admitted_ &&
+                  (staging_bytes_ == 0 || staging_bytes_ + nbytes <= max_staging_bytes_));
+        });
+        if (stopped_) return;
+        staging_bytes_ += nbytes;
+        ++next_admitted_;
+      }
+      cv_.notify_all();
+      std::string data;
+      std::exception_ptr error;
+      try {
+        LoadBinaryFromFile(metadata_.path + "/" + metadata_.records[index].data_path, &data);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_[index].data = std::move(data);
+        slots_[index].error = error;
+        slots_[index].ready = true;
+      }
+      cv_.notify_all();
+    }
+  }
+
+  /*! \brief The metadata of the cache. */
+  const NDArrayCacheMetadata& metadata_;
+  /*! \brief The maximum number of bytes of shards held in memory. */
+  int64_t max_staging_bytes_;
+  /*! \brief The shards, indexed in metadata order. */
+  std::vector<Slot> slots_;
+  /*! \brief The reader threads. */
+  std::vector<std::thread> readers_;
+  /*! \brief The mutex protecting the fields below and the slots. */
+  std::mutex mutex_;
+  /*! \brief The condition variable signaling the changes of the fields below and the slots. */
+  std::condition_variable cv_;
+  /*! \brief The index of the next shard to be claimed by a reader. */
+  size_t next_shard_{0};
+  /*! \brief The index of the next shard to be admitted into the staging budget. */
+  size_t next_admitted_{0};
+  /*! \brief The number of bytes of shards currently held in memory. */
+  int64_t staging_bytes_{0};
+  /*! \brief Whether the readers should stop. */
+  bool stopped_{false};
+};
+
+#if !defined(_WIN32)
+/*! \brief A read-only memory mapping of a whole shard file. */
+class MappedShard {
+ public:
+  explicit MappedShard(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    CHECK_NE(fd, -1) << "ValueError: Cannot open parameter shard " << path;
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0) << "ValueError: Cannot stat parameter shard " << path;
+    nbytes_ = static_cast<size_t>(st.st_size);
+    if (nbytes_ != 0) {
+      void* addr = mmap(nullptr, nbytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+      CHECK(addr != MAP_FAILED) << "ValueError: Cannot mmap parameter shard " << path;
+      data_ = static_cast<char*>(addr);
+    }
+    close(fd);
+  }
+
+  ~MappedShard() {
+    if (data_ != nullptr) {
+      munmap(data_, nbytes_);
+    }
+  }
+
+  MappedShard(const MappedShard&) = delete;
+  MappedShard& operator=(const MappedShard&) = delete;
+
+  /*! \brief The beginning of the mapped bytes. */
+  char* data() const { return data_; }
+  /*! \brief The size of the mapped file. */
+  size_t nbytes() const { return nbytes_; }
+
+ private:
+  char* data_{nullptr};
+  size_t nbytes_{0};
+};
+
+/*! \brief The DLPack context of an NDArray that views a mapped shard. */
+struct MappedParamContext {
+  /*! \brief The mapping, kept alive until the NDArray is freed. */
+  std::shared_ptr<MappedShard> shard;
+  /*! \brief The shape of the NDArray. */
+  std::vector<int64_t> shape;
+  /*! \brief The managed tensor handed to NDArray::FromDLPack. */
+  DLManagedTensor tensor;
+
+  static void Deleter(DLManagedTensor* self) {
+    delete static_cast<MappedParamContext*>(self->manager_ctx);
+  }
+};
+
+/*!
+ * \brief Create an NDArray that views the given parameter inside a mapped shard,
+ *  or return NullOpt if the parameter cannot be viewed directly.
+ */
+Optional<NDArray> ViewMappedParam(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec,
+                                  Device device, const std::shared_ptr<MappedShard>& shard) {
+  if (device.device_type != kDLCPU || rec.format != "raw") {
+    return NullOpt;
+  }
+  char* data = shard->data() + rec.byte_offset;
+  size_t expected_nbytes = rec.dtype.bytes() * rec.dtype.lanes();
+  for (int64_t dim : rec.shape) {
+    expected_nbytes *= dim;
+  }
+  if (rec.dtype.bits() % 8 != 0 || static_cast<size_t>(rec.nbytes) != expected_nbytes ||
+      reinterpret_cast<uintptr_t>(data) % kAllocAlignment != 0) {
+    return NullOpt;
+  }
+  MappedParamContext* ctx = new MappedParamContext();
+  ctx->shard = shard;
+  ctx->shape.assign(rec.shape.begin(), rec.shape.end());
+  DLTensor& dl_tensor = ctx->tensor.dl_tensor;
+  dl_tensor.data = data;
+  dl_tensor.device = device;
+  dl_tensor.ndim = static_cast<int32_t>(ctx->shape.size());
+  dl_tensor.dtype = rec.dtype;
+  dl_tensor.shape = ctx->shape.data();
+  dl_tensor.strides = nullptr;
+  dl_tensor.byte_offset = 0;
+  ctx->tensor.manager_ctx = ctx;
+  ctx->tensor.deleter = MappedParamContext::Deleter;
+  return NDArray::FromDLPack(&ctx->tensor);
+}
+#endif  // !defined(_WIN32)
+
+TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::LoadMapped(
+    Device device,
+    const std::string& path_prefix,  //
+    Optional<NDArray>* staging_buffer) const {
+#if defined(_WIN32)
+  std::string raw_data;
+  return Load(device, path_prefix, &raw_data, staging_buffer);
+#else
   CHECK_EQ(this->format, "raw-shard") << "ValueError: Only `raw-shard` format is supported";
-  CHECK_EQ(this->nbytes, raw_data_buffer->length())
+  auto shard = std::make_shared<MappedShard>(path_prefix + "/" + this->data_path);
+  CHECK_EQ(this->nbytes, shard->nbytes())
       << "ValueError: Encountered an corrupted parameter shard. It means it is not downloaded "
          "completely or downloading is interrupted. Please try to download again.";
   Array<NDArray> result;
   result.reserve(this->records.size());
   for (const ParamRecord& nd_rec : this->records) {
-    result.push_back(nd_rec.Load(device, raw_data_buffer, staging_buffer));
+    if (Optional<NDArray> view = ViewMappedParam(nd_rec, device, shard)) {
+      result.push_back(view.value());
+    } else {
+      result.push_back(CopyParamFromBytes(nd_rec, device, shard->data(), staging_buffer));
+    }
   }
   return result;
+#endif
 }
 
 /*!
@@ -236,21 +519,52 @@ class NDArrayCache {
 
   static void Clear() { Global()->pool_.clear(); }
 
+  /*! \brief The default number of threads reading shards ahead. */
+  static constexpr int kDefaultNumReaders = 4;
+  /*! \brief The default bound of the shard data held in memory while loading. */
+  static constexpr int64_t kDefaultMaxStagingBytes = int64_t(1) << 30;
+
   /*!
    * \brief Load parameters from path and append them.
    * \param cache_path The cache to path.
    * \param device_type The type of device to be loaded.
    * \param device_id The device id.
+   * \param use_mmap Whether to memory-map the shards, see FileRecord::LoadMapped.
+   * \param num_readers The number of threads reading shards ahead, ignored with mmap.
+   * \param max_staging_bytes The bound of the shard data held in memory, ignored with mmap.
+   * \param progress An optional callback invoked after each shard with the number of loaded
+   *        bytes, the total number of bytes and the elapsed seconds.
    */
-  static void Load(const std::string& cache_path, int device_type, int device_id) {
+  static void Load(const std::string& cache_path, int device_type, int device_id,
+                   bool use_mmap = false, int num_readers = kDefaultNumReaders,
+                   int64_t max_staging_bytes = kDefaultMaxStagingBytes,
+                   Optional<PackedFunc> progress = NullOpt) {
     DLDevice device{static_cast<DLDeviceType>(device_type), device_id};
     NDArrayCacheMetadata metadata = NDArrayCacheMetadata::Load(cache_path);
     Optional<NDArray> staging_buffer;
-    std::string raw_data;
     Array<NDArray> params;
+    std::unique_ptr<ShardPrefetcher> prefetcher;
+    if (!use_mmap) {
+      prefetcher = std::make_unique<ShardPrefetcher>(metadata, num_readers, max_staging_bytes);
+    }
+    int64_t total_bytes = 0;
     for (const NDArrayCacheMetadata::FileRecord& shard_rec : metadata.records) {
+      total_bytes += shard_rec.nbytes;
+    }
+    int64_t loaded_bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t shard_index = 0; shard_index < metadata.records.size(); ++shard_index) {
+      const NDArrayCacheMetadata::FileRecord& shard_rec = metadata.records[shard_index];
       try {
-        params = shard_rec.Load(device, cache_path, &raw_data, &staging_buffer);
+        if (use_mmap) {
+          params = shard_rec.LoadMapped(device, cache_path, &staging_buffer);
+        } else {
+          std::string raw_data = prefetcher->Take(shard_index);
+          params = shard_rec.LoadFromBytes(device, raw_data, &staging_buffer);
+          raw_data.clear();
+          raw_data.shrink_to_fit();
+          prefetcher->Release(shard_index);
+        }
       } catch (const dmlc::Error& e) {
         LOG(FATAL) << "ValueError: Error when loading parameters from " << shard_rec.data_path
                    << ": " << e.what();
@@ -259,6 +573,11 @@ class NDArrayCache {
       for (int i = 0; i < num_params; ++i) {
         Update(shard_rec.records[i].name, params[i], true);
       }
+      loaded_bytes += shard_rec.nbytes;
+      if (progress.defined()) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        progress.value()(loaded_bytes, total_bytes, elapsed.count());
+      }
     }
   }
 
@@ -291,7 +610,20 @@ TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.update").set_body([](TVMArgs args,
 });
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.remove").set_body_typed(NDArrayCache::Remove);
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.clear").set_body_typed(NDArrayCache::Clear);
-TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load").set_body_typed(NDArrayCache::Load);
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load")
+    .set_body_typed([](const std::string& cache_path, int device_type, int device_id) {
+      NDArrayCache::Load(cache_path, device_type, device_id);
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load_mmap")
+    .set_body_typed([](const std::string& cache_path, int device_type, int device_id) {
+      NDArrayCache::Load(cache_path, device_type, device_id, /*use_mmap=*/true);
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load_with_progress")
+    .set_body_typed([](const std::string& cache_path, int device_type, int device_id,
+                       int num_readers, int64_t max_staging_bytes, Optional<PackedFunc> progress) {
+      NDArrayCache::Load(cache_path, device_type, device_id, /*use_mmap=*/false, num_readers,
+                         max_staging_bytes, progress);
+    });
 
 // This param module node can be useful to get param dict in RPC mode
 // when the remote already have loaded parameters from file.
@@ -28,8 +28,12 @@
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
 #include <numeric>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -83,6 +87,12 @@ struct Block {
    * words, different blocks do not share pages).
    */
   std::vector<int32_t> page_ids;
+  /*!
+   * \brief The ids of the host pages holding the KV data of the block
+   * when the block is offloaded to host memory. An offloaded block has
+   * no page on device, and is swapped in before its next use.
+   */
+  std::vector<int32_t> host_page_ids;
   /*! \brief The total sequence length in the block. */
   int32_t seq_length = 0;
   /*!
@@ -120,6 +130,7 @@ struct Block {
   /*! \brief Reset the block data. */
   void Reset() {
     page_ids.clear();
+    host_page_ids.clear();
     seq_length = 0;
     start_pos = 0;
     sink_length = 0;
@@ -168,6 +179,11 @@ struct Sequence {
    * this sequence are committed
    */
   bool accepted_indices_committed = true;
+  /*!
+   * \brief The token ids of the leading KV data of the sequence, when known.
+   * They are used as the key to retain the KV data in the prefix cache.
+   */
+  std::vector<int32_t> token_ids;
 
   explicit Sequence(std::vector<Block>* global_block_pool, int32_t last_block_idx) {
     ++global_block_pool->at(last_block_idx).external_ref_cnt;
@@ -198,6 +214,35 @@ struct Sequence {
   }
 };
 
+/*!
+ * \brief The radix tree node of the prefix cache.
+ * Each edge of the tree is labeled with the token ids of one full page,
+ * so a node at depth `d` identifies a page-aligned token prefix of
+ * length `d * page_size`.
+ */
+struct PrefixTreeNode {
+  /*! \brief The children nodes, keyed by the page token ids on the edge. */
+  std::map<std::vector<int32_t>, std::unique_ptr<PrefixTreeNode>> children;
+  /*! \brief The ids of the cache entries whose token prefix passes through this node. */
+  std::unordered_set<int64_t> entry_ids;
+};
+
+/*!
+ * \brief The prefix cache entry, which retains the KV data of a
+ * page-aligned token prefix after its sequence is removed.
+ */
+struct PrefixCacheEntry {
+  /*! \brief The internal sequence holding the references of the retained blocks. */
+  Sequence seq;
+  /*! \brief The token ids of the retained prefix, whose length is a multiple of page size. */
+  std::vector<int32_t> token_ids;
+  /*! \brief The position of the entry in the LRU list. */
+  std::list<int64_t>::iterator lru_it;
+
+  explicit PrefixCacheEntry(Sequence seq, std::vector<int32_t> token_ids)
+      : seq(std::move(seq)), token_ids(std::move(token_ids)) {}
+};
+
 /*!
  * \brief The rotary embedding mode adopted by the paged KV cache
  * when computing attention.
@@ -879,6 +924,33 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The list of free available blocks (in their indices). */
   std::vector<int32_t> free_block_idx_;
 
+  /********************* Prefix Cache *********************/
+
+  /*! \brief A boolean flag indicating if removed sequences are retained in the prefix cache. */
+  bool prefix_caching_enabled_ = false;
+  /*! \brief The root of the radix tree over the token ids of the cache entries. */
+  PrefixTreeNode prefix_tree_root_;
+  /*! \brief The mapping from entry ids to the prefix cache entries. */
+  std::unordered_map<int64_t, PrefixCacheEntry> prefix_cache_entries_;
+  /*! \brief The entry ids in the order of recent use, the most recent one at the front. */
+  std::list<int64_t> prefix_cache_lru_;
+  /*! \brief The id of the next prefix cache entry. */
+  int64_t next_prefix_cache_entry_id_ = 0;
+
+  /********************* Host Offloading *********************/
+
+  /*!
+   * \brief The host-memory pages of each layer for offloaded KV data,
+   * which have the same layout as the device pages.
+   */
+  Array<NDArray> host_pages_;
+  /*! \brief The list of ids of free host pages. */
+  std::vector<int32_t> free_host_page_ids_;
+  /*! \brief The total number of pages moved from device to host. */
+  int64_t num_swapped_out_pages_ = 0;
+  /*! \brief The total number of pages moved from host to device. */
+  int64_t num_swapped_in_pages_ = 0;
+
   /*********** Current Batch Info & Auxiliary Arrays on Device ***********/
   //-------------------------------------------
   // The following fields are auxiliary arrays on device.
@@ -1174,6 +1246,14 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
     global_block_pool_.clear();
     free_block_idx_.clear();
+    prefix_tree_root_.children.clear();
+    prefix_tree_root_.entry_ids.clear();
+    prefix_cache_entries_.clear();
+    prefix_cache_lru_.clear();
+    free_host_page_ids_.clear();
+    for (int64_t page_id = HostPageCapacity() - 1; page_id >= 0; --page_id) {
+      free_host_page_ids_.push_back(page_id);
+    }
     dirty_aux_data_device_ = false;
   }
 
@@ -1190,22 +1270,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   void RemoveSequence(int64_t seq_id) final {
     auto it = seq_map_.find(seq_id);
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
-    int32_t block_idx = it->second.last_block_idx;
-    // The block should have at least one reference, which comes from the sequence.
-    ICHECK_GE(global_block_pool_[block_idx].external_ref_cnt, 1);
-    while (block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1) {
-      // - Free pages in the last block.
-      for (int32_t page_id : global_block_pool_[block_idx].page_ids) {
-        free_page_ids_.push_back(page_id);
-      }
-      free_block_idx_.push_back(block_idx);
-      block_idx = global_block_pool_[block_idx].parent_idx;
-    }
-    // - Decrease the external reference of the parent block.
-    if (block_idx != -1) {
-      ICHECK_GT(global_block_pool_[block_idx].external_ref_cnt, 1);
-      --global_block_pool_[block_idx].external_ref_cnt;
+    if (prefix_caching_enabled_) {
+      RetainPrefixOfSequence(&it->second);
     }
+    ReleaseBlockChain(it->second.last_block_idx);
     seq_map_.erase(it);
     dirty_aux_data_device_ = true;
   }
@@ -1240,20 +1308,40 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
           << sink_size << ". But the forked position = " << fork_pos << ".";
     }
 
-    if (fork_pos == parent_it->second.seq_length && fork_pos % page_size_ == 0 &&
-        global_block_pool_[parent_it->second.last_block_idx].seq_length > 0) {
+    int32_t child_block_idx = ForkBlocks(&parent_it->second, fork_pos);
+    // Create the child sequence with the child block.
+    Sequence child(&global_block_pool_, child_block_idx);
+    const std::vector<int32_t>& parent_token_ids = parent_it->second.token_ids;
+    child.token_ids.assign(
+        parent_token_ids.begin(),
+        parent_token_ids.begin() + std::min<int64_t>(fork_pos, parent_token_ids.size()));
+    seq_map_.insert({child_seq_id, std::move(child)});
+    dirty_aux_data_device_ = true;
+  }
+
+  /*!
+   * \brief Fork the blocks of the given sequence at the given position.
+   * \param parent The sequence to fork from.
+   * \param fork_pos The position to fork at, in range `[0, parent->seq_length]`.
+   * \return The index of the new last block of the child, which refers to
+   * the blocks of the parent for the KV data before the fork position.
+   */
+  int32_t ForkBlocks(Sequence* parent, int64_t fork_pos) {
+    SwapInSequence(*parent);
+    if (fork_pos == parent->seq_length && fork_pos % page_size_ == 0 &&
+        global_block_pool_[parent->last_block_idx].seq_length > 0) {
       // To enable the parent sequence to continue decode after the fork,
       // we add a new empty block at the end of the parent sequence.
       // So the new decoded KV data will go into the new block.
       int32_t new_block_idx = GetFreeBlock();
-      global_block_pool_[new_block_idx].start_pos = parent_it->second.seq_length;
-      global_block_pool_[new_block_idx].parent_idx = parent_it->second.last_block_idx;
+      global_block_pool_[new_block_idx].start_pos = parent->seq_length;
+      global_block_pool_[new_block_idx].parent_idx = parent->last_block_idx;
       global_block_pool_[new_block_idx].external_ref_cnt = 1;
-      parent_it->second.last_block_idx = new_block_idx;
+      parent->last_block_idx = new_block_idx;
     }
 
     int32_t child_block_idx = GetFreeBlock();
-    std::vector<int32_t> trace = parent_it->second.GetBlockTrace(global_block_pool_);
+    std::vector<int32_t> trace = parent->GetBlockTrace(global_block_pool_);
     int64_t in_block_offset = fork_pos;
     for (int32_t forked_block_idx : trace) {
       if (forked_block_idx != trace.back()) {
@@ -1302,10 +1390,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
         // Update sliding window sink size if sliding window is enabled and the forked block is the
         // last block
-        if (parent_it->second.sliding_window_size != -1 &&
-            forked_block_idx == parent_it->second.last_block_idx) {
-          CHECK_LE(moved_offset, parent_it->second.last_block_attn_sink_size);
-          parent_it->second.last_block_attn_sink_size -= moved_offset;
+        if (parent->sliding_window_size != -1 && forked_block_idx == parent->last_block_idx) {
+          CHECK_LE(moved_offset, parent->last_block_attn_sink_size);
+          parent->last_block_attn_sink_size -= moved_offset;
         }
       }
       global_block_pool_[child_block_idx].start_pos = fork_pos - in_page_offset;
@@ -1320,11 +1407,179 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       }
       break;
     }
-    // Create the child sequence with the child block.
-    seq_map_.insert({child_seq_id, Sequence(&global_block_pool_, child_block_idx)});
+    return child_block_idx;
+  }
+
+  /*!
+   * \brief Release the reference of a sequence to the block chain ending
+   * at the given block, freeing the blocks and pages no longer referenced.
+   * \param block_idx The last block of the chain.
+   */
+  void ReleaseBlockChain(int32_t block_idx) {
+    // The block should have at least one reference, which comes from the sequence.
+    ICHECK_GE(global_block_pool_[block_idx].external_ref_cnt, 1);
+    while (block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1) {
+      // - Free pages in the last block.
+      for (int32_t page_id : global_block_pool_[block_idx].page_ids) {
+        free_page_ids_.push_back(page_id);
+      }
+      for (int32_t host_page_id : global_block_pool_[block_idx].host_page_ids) {
+        free_host_page_ids_.push_back(host_page_id);
+      }
+      free_block_idx_.push_back(block_idx);
+      block_idx = global_block_pool_[block_idx].parent_idx;
+    }
+    // - Decrease the external reference of the parent block.
+    if (block_idx != -1) {
+      ICHECK_GT(global_block_pool_[block_idx].external_ref_cnt, 1);
+      --global_block_pool_[block_idx].external_ref_cnt;
+    }
+  }
+
+  /************** Host Offloading **************/
+
+  void EnableHostOffloading(int64_t num_host_pages) final {
+    CHECK_GE(num_host_pages, 0) << "The number of host pages should be non-negative.";
+    for (const Block& block : global_block_pool_) {
+      CHECK(block.host_page_ids.empty())
+          << "Cannot resize the host memory while some KV data is offloaded.";
+    }
+    host_pages_.clear();
+    free_host_page_ids_.clear();
+    if (num_host_pages == 0) {
+      return;
+    }
+    Device host_device = GetPreferredHostDevice(device_);
+    host_pages_.reserve(num_layers_);
+    for (int64_t layer = 0; layer < num_layers_; ++layer) {
+      std::vector<int64_t> shape(pages_[layer]->shape, pages_[layer]->shape + pages_[layer]->ndim);
+      shape[0] = num_host_pages;
+      host_pages_.push_back(NDArray::Empty(shape, pages_[layer]->dtype, host_device));
+    }
+    for (int64_t page_id = num_host_pages - 1; page_id >= 0; --page_id) {
+      free_host_page_ids_.push_back(page_id);
+    }
+  }
+
+  void OffloadSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK(it->second.accepted_indices_committed)
+        << "The sequence's token tree computed in the last round of forward has not been "
+           "committed with accepted nodes.";
+    // Only the blocks used by this sequence alone are offloaded, so that the
+    // prefix shared with other sequences stays on device.
+    std::vector<int32_t> block_ids;
+    int64_t num_pages = 0;
+    for (int32_t block_idx = it->second.last_block_idx;
+         block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1;
+         block_idx = global_block_pool_[block_idx].parent_idx) {
+      num_pages += global_block_pool_[block_idx].page_ids.size();
+      block_ids.push_back(block_idx);
+    }
+    CHECK_LE(num_pages, static_cast<int64_t>(free_host_page_ids_.size()))
+        << "The host memory is full. " << num_pages << " pages are required to offload sequence \""
+        << seq_id << "\", while only " << free_host_page_ids_.size() << " host pages are free.";
+    if (num_pages == 0) {
+      return;
+    }
+
+    // - Wait for the pending writes to the pages on the compute stream.
+    DeviceAPI* device_api = DeviceAPI::Get(device_);
+    if (copy_stream_ != nullptr) {
+      device_api->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    for (int32_t block_idx : block_ids) {
+      Block& block = global_block_pool_[block_idx];
+      ICHECK(block.host_page_ids.empty());
+      for (int32_t page_id : block.page_ids) {
+        int32_t host_page_id = free_host_page_ids_.back();
+        free_host_page_ids_.pop_back();
+        CopyPage(pages_, page_id, host_pages_, host_page_id);
+        block.host_page_ids.push_back(host_page_id);
+      }
+    }
+    // - The device pages can be reused only after the copies finish.
+    device_api->StreamSync(device_, copy_stream_);
+    for (int32_t block_idx : block_ids) {
+      Block& block = global_block_pool_[block_idx];
+      free_page_ids_.insert(free_page_ids_.end(), block.page_ids.begin(), block.page_ids.end());
+      num_swapped_out_pages_ += block.page_ids.size();
+      block.page_ids.clear();
+    }
     dirty_aux_data_device_ = true;
   }
 
+  void PrefetchSequence(int64_t seq_id) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    SwapInSequence(it->second);
+  }
+
+  IntTuple GetResidencyStats() const final {
+    int64_t num_offloaded_pages = 0;
+    for (const Block& block : global_block_pool_) {
+      num_offloaded_pages += block.host_page_ids.size();
+    }
+    int64_t num_resident_pages = num_total_pages_ - static_cast<int64_t>(free_page_ids_.size());
+    return IntTuple({num_resident_pages, num_offloaded_pages,
+                     static_cast<int64_t>(free_host_page_ids_.size()), num_swapped_out_pages_,
+                     num_swapped_in_pages_});
+  }
+
+  /************** Prefix Cache **************/
+
+  void EnablePrefixCaching(bool enable) final {
+    prefix_caching_enabled_ = enable;
+    if (!enable) {
+      while (!prefix_cache_lru_.empty()) {
+        EvictPrefixCacheEntry(prefix_cache_lru_.back());
+      }
+    }
+  }
+
+  int64_t AddSequenceWithPrefix(int64_t seq_id, const IntTuple& token_ids) final {
+    CHECK(seq_map_.find(seq_id) == seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is already in the KV cache.";
+    std::vector<int32_t> tokens(token_ids.begin(), token_ids.end());
+    // At least one token is left for the caller to run forward, so that
+    // the output of the last prompt token is always computed.
+    int64_t max_match_length = 0;
+    if (!tokens.empty()) {
+      max_match_length = (static_cast<int64_t>(tokens.size()) - 1) / page_size_ * page_size_;
+    }
+
+    // - Walk the radix tree for the longest cached page-aligned prefix.
+    const PrefixTreeNode* node = &prefix_tree_root_;
+    int64_t matched_length = 0;
+    if (prefix_caching_enabled_) {
+      while (matched_length < max_match_length) {
+        auto child_it = node->children.find(GetPageTokens(tokens, matched_length));
+        if (child_it == node->children.end()) {
+          break;
+        }
+        node = child_it->second.get();
+        matched_length += page_size_;
+      }
+    }
+
+    int32_t block_idx = -1;
+    if (matched_length == 0) {
+      block_idx = GetFreeBlock();
+    } else {
+      ICHECK(!node->entry_ids.empty());
+      int64_t entry_id = *node->entry_ids.begin();
+      TouchPrefixCacheEntry(entry_id);
+      block_idx = ForkBlocks(&prefix_cache_entries_.at(entry_id).seq, matched_length);
+    }
+    Sequence seq(&global_block_pool_, block_idx);
+    ICHECK_EQ(seq.seq_length, matched_length);
+    seq.token_ids = std::move(tokens);
+    seq_map_.insert({seq_id, std::move(seq)});
+    dirty_aux_data_device_ = true;
+    return matched_length;
+  }
+
   void CopySinglePage(int32_t src_page_id, int32_t tgt_page_id, int64_t copy_length) {
     if (copy_stream_ != compute_stream_) {
       // Set the copy stream for copy.
@@ -1413,6 +1668,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     if (n == 0) {
       return;
     }
+    if (static_cast<int64_t>(it->second.token_ids.size()) > it->second.seq_length - n) {
+      it->second.token_ids.resize(it->second.seq_length - n);
+    }
+    SwapInSequence(it->second);
 
     int32_t block_idx = it->second.last_block_idx;
     // The block should have at least one reference, which comes from the sequence.
@@ -1452,6 +1711,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       CHECK(seq_map_.find(temp_seq_id) == seq_map_.end());
       ForkSequence(seq_id, temp_seq_id, it->second.seq_length - n);
       CHECK(seq_map_.find(temp_seq_id) != seq_map_.end());
+      // The KV data is kept by the temporary sequence, and is not retained in prefix cache.
+      it->second.token_ids.clear();
       RemoveSequence(seq_id);
       CHECK(seq_map_.find(seq_id) == seq_map_.end());
       auto it = seq_map_.find(temp_seq_id);
@@ -1470,7 +1731,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
            free_page_ids_.size() == static_cast<size_t>(num_total_pages_);
   }
 
-  int32_t GetNumAvailablePages() const final { return free_page_ids_.size(); }
+  int32_t GetNumAvailablePages() const final {
+    // The pages retained only by the prefix cache can be reclaimed on demand.
+    return free_page_ids_.size() + GetNumReclaimablePrefixCachePages();
+  }
 
   int32_t GetTotalSequenceLength() const final {
     int32_t total_seq_len = 0;
@@ -1502,6 +1766,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       auto it = seq_map_.find(seq_ids[i]);
       CHECK(it != seq_map_.end()) << "The sequence \"" << seq_ids[i]
                                   << "\" cannot be found in KV cache.";
+      // The swap-in copies are synchronized with the compute stream
+      // together with the auxiliary data before attention.
+      SwapInSequence(it->second);
       sequences.push_back(&it->second);
       last_block_length_before_append.push_back(
           global_block_pool_[it->second.last_block_idx].seq_length);
@@ -1903,7 +2170,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         << "PageAttentionKVCache requires the `f_debug_get_kv` to be explicitly passed in when "
            "initialization. Please construct the KV cache with `f_debug_get_kv`.";
 
-    const Sequence& seq = seq_map_.at(seq_id);
+    Sequence& seq = seq_map_.at(seq_id);
+    if (SwapInSequence(seq) && copy_stream_ != nullptr) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, copy_stream_, compute_stream_);
+    }
     CHECK_GE(start_pos, 0) << "DebugGetKV does not accept negative start_pos " << start_pos;
     CHECK_LE(end_pos, seq.seq_length) << "DebugGetKV does not accept out-of-range end_pos";
     CHECK_LT(start_pos, end_pos) << "DebugGetKV does not accept \"start_pos >= end_pos\"";
@@ -1957,6 +2227,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
  private:
   /*! \brief Get a new free page and return its id. */
   int32_t GetFreePage() {
+    // Evict the prefix cache entries in LRU order until some page is released.
+    while (free_page_ids_.empty() && !prefix_cache_lru_.empty()) {
+      EvictPrefixCacheEntry(prefix_cache_lru_.back());
+    }
     // Find a page from the free page pools.
     CHECK(!free_page_ids_.empty()) << "The KV cache is full. No page can be allocated.";
     int32_t page_id = free_page_ids_.back();
@@ -1964,6 +2238,209 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     return page_id;
   }
 
+  /*! \brief Get the number of pages the host memory can hold. */
+  int64_t HostPageCapacity() const { return host_pages_.empty() ? 0 : host_pages_[0]->shape[0]; }
+
+  /*!
+   * \brief Copy the KV data of one page of all layers on the copy stream.
+   * \param src_pages The source page arrays of each layer.
+   * \param src_page_id The id of the source page.
+   * \param dst_pages The destination page arrays of each layer.
+   * \param dst_page_id The id of the destination page.
+   */
+  void CopyPage(const Array<NDArray>& src_pages, int32_t src_page_id,
+                const Array<NDArray>& dst_pages, int32_t dst_page_id) {
+    for (int64_t layer = 0; layer < num_layers_; ++layer) {
+      DLTensor src = *src_pages[layer].operator->();
+      DLTensor dst = *dst_pages[layer].operator->();
+      // Take the view of the page, which is the sub-array along the first dimension.
+      for (DLTensor* view : {&src, &dst}) {
+        view->ndim -= 1;
+        view->shape += 1;
+      }
+      src.byte_offset += src_page_id * GetDataSize(src);
+      dst.byte_offset += dst_page_id * GetDataSize(dst);
+      NDArray::CopyFromTo(&src, &dst, copy_stream_);
+    }
+  }
+
+  /*!
+   * \brief Issue the copies on the copy stream to bring the offloaded
+   * blocks of the given sequence back to device.
+   * \return A boolean indicating if any block is swapped in.
+   */
+  bool SwapInSequence(const Sequence& seq) {
+    int64_t num_required_pages = 0;
+    for (int32_t block_idx = seq.last_block_idx; block_idx != -1;
+         block_idx = global_block_pool_[block_idx].parent_idx) {
+      num_required_pages += global_block_pool_[block_idx].host_page_ids.size();
+    }
+    if (num_required_pages == 0) {
+      return false;
+    }
+    CHECK_LE(num_required_pages, GetNumAvailablePages())
+        << "The KV cache is full. " << num_required_pages
+        << " pages are required to swap in the offloaded KV data.";
+
+    for (int32_t block_idx = seq.last_block_idx; block_idx != -1;
+         block_idx = global_block_pool_[block_idx].parent_idx) {
+      Block& block = global_block_pool_[block_idx];
+      if (block.host_page_ids.empty()) {
+        continue;
+      }
+      ICHECK(block.page_ids.empty());
+      for (int32_t host_page_id : block.host_page_ids) {
+        int32_t page_id = GetFreePage();
+        CopyPage(host_pages_, host_page_id, pages_, page_id);
+        block.page_ids.push_back(page_id);
+      }
+      // The host pages can be reused right away, since the later copies
+      // into the host pages are issued on the same copy stream.
+      free_host_page_ids_.insert(free_host_page_ids_.end(), block.host_page_ids.begin(),
+                                 block.host_page_ids.end());
+      num_swapped_in_pages_ += block.host_page_ids.size();
+      block.host_page_ids.clear();
+    }
+    dirty_aux_data_device_ = true;
+    return true;
+  }
+
+  /*! \brief Get the token ids of the page starting at the given offset. */
+  std::vector<int32_t> GetPageTokens(const std::vector<int32_t>& tokens, int64_t offset) const {
+    ICHECK_LE(offset + page_size_, static_cast<int64_t>(tokens.size()));
+    return std::vector<int32_t>(tokens.begin() + offset, tokens.begin() + offset + page_size_);
+  }
+
+  /*! \brief Mark the given prefix cache entry as the most recently used one. */
+  void TouchPrefixCacheEntry(int64_t entry_id) {
+    PrefixCacheEntry& entry = prefix_cache_entries_.at(entry_id);
+    prefix_cache_lru_.splice(prefix_cache_lru_.begin(), prefix_cache_lru_, entry.lru_it);
+  }
+
+  /*!
+   * \brief Retain the KV data of the longest page-aligned prefix of the
+   * given sequence whose token ids are known in the prefix cache.
+   * The sequence itself is not changed except its last block.
+   */
+  void RetainPrefixOfSequence(Sequence* seq) {
+    if (seq->sliding_window_size != -1 || !seq->accepted_indices_committed) {
+      return;
+    }
+    for (int32_t block_idx = seq->last_block_idx; block_idx != -1;
+         block_idx = global_block_pool_[block_idx].parent_idx) {
+      if (!global_block_pool_[block_idx].host_page_ids.empty()) {
+        // Do not bring the offloaded KV data back to device only for caching.
+        return;
+      }
+    }
+    int64_t length = std::min<int64_t>(seq->seq_length, seq->token_ids.size());
+    length -= length % page_size_;
+    if (length == 0) {
+      return;
+    }
+
+    // - Find the nodes on the path, and stop if the prefix is already cached.
+    std::vector<PrefixTreeNode*> path{&prefix_tree_root_};
+    for (int64_t offset = 0; offset < length; offset += page_size_) {
+      auto child_it = path.back()->children.find(GetPageTokens(seq->token_ids, offset));
+      if (child_it == path.back()->children.end()) {
+        break;
+      }
+      path.push_back(child_it->second.get());
+    }
+    if (static_cast<int64_t>(path.size() - 1) * page_size_ == length) {
+      ICHECK(!path.back()->entry_ids.empty());
+      TouchPrefixCacheEntry(*path.back()->entry_ids.begin());
+      return;
+    }
+
+    // - Fork the prefix into a new entry, and insert it into the radix tree.
+    int64_t entry_id = next_prefix_cache_entry_id_++;
+    std::vector<int32_t> tokens(seq->token_ids.begin(), seq->token_ids.begin() + length);
+    Sequence entry_seq(&global_block_pool_, ForkBlocks(seq, length));
+    PrefixCacheEntry& entry =
+        prefix_cache_entries_.emplace(entry_id, PrefixCacheEntry(entry_seq, std::move(tokens)))
+            .first->second;
+    prefix_cache_lru_.push_front(entry_id);
+    entry.lru_it = prefix_cache_lru_.begin();
+    for (int64_t offset = static_cast<int64_t>(path.size() - 1) * page_size_; offset < length;
+         offset += page_size_) {
+      std::unique_ptr<PrefixTreeNode>& child =
+          path.back()->children[GetPageTokens(entry.token_ids, offset)];
+      child = std::make_unique<PrefixTreeNode>();
+      path.push_back(child.get());
+    }
+
+    // - The entries ending on the path are prefixes of the new entry, and are
+    // no longer needed, since the new entry retains their KV data as well.
+    std::vector<int64_t> covered_entry_ids;
+    for (size_t depth = 1; depth < path.size(); ++depth) {
+      for (int64_t covered_id : path[depth]->entry_ids) {
+        if (static_cast<int64_t>(prefix_cache_entries_.at(covered_id).token_ids.size()) ==
+            static_cast<int64_t>(depth) * page_size_) {
+          covered_entry_ids.push_back(covered_id);
+        }
+      }
+      path[depth]->entry_ids.insert(entry_id);
+    }
+    for (int64_t covered_id : covered_entry_ids) {
+      EvictPrefixCacheEntry(covered_id);
+    }
+  }
+
+  /*! \brief Remove the given entry from the prefix cache and release its KV data. */
+  void EvictPrefixCacheEntry(int64_t entry_id) {
+    auto entry_it = prefix_cache_entries_.find(entry_id);
+    ICHECK(entry_it != prefix_cache_entries_.end());
+    PrefixCacheEntry& entry = entry_it->second;
+    // - Remove the entry from the radix tree, and prune the nodes without entries.
+    std::vector<std::pair<PrefixTreeNode*, std::vector<int32_t>>> path;
+    PrefixTreeNode* node = &prefix_tree_root_;
+    for (int64_t offset = 0; offset < static_cast<int64_t>(entry.token_ids.size());
+         offset += page_size_) {
+      std::vector<int32_t> page_tokens = GetPageTokens(entry.token_ids, offset);
+      PrefixTreeNode* child = node->children.at(page_tokens).get();
+      path.emplace_back(node, std::move(page_tokens));
+      node = child;
+    }
+    for (auto rit = path.rbegin(); rit != path.rend(); ++rit) {
+      PrefixTreeNode* child = rit->first->children.at(rit->second).get();
+      child->entry_ids.erase(entry_id);
+      if (child->entry_ids.empty()) {
+        rit->first->children.erase(rit->second);
+      }
+    }
+    // - Release the retained blocks.
+    ReleaseBlockChain(entry.seq.last_block_idx);
+    prefix_cache_lru_.erase(entry.lru_it);
+    prefix_cache_entries_.erase(entry_it);
+    dirty_aux_data_device_ = true;
+  }
+
+  /*! \brief Get the number of pages which are referenced only by the prefix cache. */
+  int32_t GetNumReclaimablePrefixCachePages() const {
+    if (prefix_cache_entries_.empty()) {
+      return 0;
+    }
+    std::vector<bool> visited(global_block_pool_.size(), false);
+    for (const auto& it : seq_map_) {
+      for (int32_t block_idx = it.second.last_block_idx; block_idx != -1 && !visited[block_idx];
+           block_idx = global_block_pool_[block_idx].parent_idx) {
+        visited[block_idx] = true;
+      }
+    }
+    int32_t num_pages = 0;
+    for (const auto& it : prefix_cache_entries_) {
+      for (int32_t block_idx = it.second.seq.last_block_idx;
+           block_idx != -1 && !visited[block_idx];
+           block_idx = global_block_pool_[block_idx].parent_idx) {
+        visited[block_idx] = true;
+        num_pages += global_block_pool_[block_idx].page_ids.size();
+      }
+    }
+    return num_pages;
+  }
+
   /*! \brief Get a new free block and return its index. */
   int32_t GetFreeBlock() {
     if (!free_block_idx_.empty()) {
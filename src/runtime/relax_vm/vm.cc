@@ -26,9 +26,24 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/relax_vm/vm.h>
+#include <tvm/runtime/tracing.h>
 
+#include <cstring>
 #include <optional>
 #include <thread>
+#include <unordered_set>
+
+#include "../library_module.h"
+
+// Use computed-goto (threaded) dispatch in the interpreter loop when the
+// compiler supports the labels-as-values extension.
+#ifndef TVM_RELAX_VM_USE_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define TVM_RELAX_VM_USE_COMPUTED_GOTO 1
+#else
+#define TVM_RELAX_VM_USE_COMPUTED_GOTO 0
+#endif
+#endif
 
 namespace tvm {
 namespace runtime {
@@ -193,6 +208,66 @@ struct VMFrame {
   }
 };
 
+/*!
+ * \brief An instruction pre-decoded at load time.
+ *
+ * The executable stores instructions as variable-length words, which
+ * would otherwise be decoded on every dispatch. The VM decodes every
+ * instruction once when it is initialized and additionally resolves
+ * the callee of each call instruction against the function pool.
+ */
+struct DecodedInstr {
+  /*! \brief The decoded instruction, its arguments point into the executable. */
+  Instruction instr;
+  /*!
+   * \brief The callee of a call instruction if it is a PackedFunc,
+   *  nullptr if the callee is a VM closure or the instruction is not a call.
+   */
+  const PackedFuncObj* packed_func{nullptr};
+  /*!
+   * \brief The number of consecutive PackedFunc calls starting from this
+   *  instruction, 0 if this instruction is not a PackedFunc call.
+   *
+   * Such a run (e.g. match_shape, check_tensor_info followed by a kernel
+   * call) never pushes VM frames nor branches, so it is executed as a single
+   * superinstruction without going back to the dispatch loop in between.
+   */
+  Index num_packed_calls{0};
+};
+
+/*!
+ * \brief The shape-checking prologue of a VM function together with a cache of
+ *  its results keyed by the shape signature of the function arguments.
+ *
+ * The prologue is the leading run of instructions emitted by VMShapeLower at the
+ * function boundary: the shape heap allocation, the argument checks and shape
+ * matches, and the shape functions that only read and write the shape heap.
+ * Its effect is fully determined by the types, dtypes and shapes of the arguments,
+ * so once it succeeded for a signature, later invocations with the same signature
+ * skip it and restore the shape heap from the cached values. Only the heap is cached:
+ * the instructions after the prologue still compute the allocation sizes from it.
+ */
+struct ShapePrologue {
+  /*! \brief The maximum number of signatures cached per function. */
+  static constexpr size_t kMaxCacheEntries = 16;
+  /*! \brief The number of instructions in the prologue, 0 means no caching. */
+  Index num_instrs{0};
+  /*! \brief The program counter of the shape heap allocation, -1 if there is none. */
+  Index alloc_heap_pc{-1};
+  /*! \brief The hash of a shape signature. */
+  struct SignatureHash {
+    size_t operator()(const std::vector<int64_t>& sig) const {
+      uint64_t hash = 14695981039346656037ULL;
+      for (int64_t v : sig) {
+        hash = (hash ^ static_cast<uint64_t>(v)) * 1099511628211ULL;
+      }
+      return static_cast<size_t>(hash);
+    }
+  };
+  /*! \brief The cached shape heap values of each validated shape signature. */
+  std::unordered_map<std::vector<int64_t>, std::vector<int64_t>, SignatureHash> cache;
+};
+
 class VirtualMachineImpl : public VirtualMachine {
  public:
   //---------------------------------------------------
@@ -323,6 +398,25 @@ class VirtualMachineImpl : public VirtualMachine {
    * \brief Initialize function pool.
    */
   void InitFuncPool();
+  /*!
+   * \brief Pre-decode the instructions of the executable.
+   * \note Must be called after the function pool is initialized.
+   */
+  void DecodeInstructions();
+  /*!
+   * \brief Detect the shape-checking prologue of every VM function.
+   * \note Must be called after the instructions are decoded.
+   */
+  void InitShapePrologues();
+  /*!
+   * \brief Run the shape-checking prologue of a function, or skip it if the
+   *  shape signature of the arguments has been validated before.
+   * \param gf_idx The function index.
+   * \param curr_frame The frame of the function, with arguments already loaded.
+   * \param args The arguments to the function.
+   * \note On return, the program counter points past the prologue if it is handled here.
+   */
+  void RunShapePrologue(Index gf_idx, VMFrame* curr_frame, const std::vector<RegType>& args);
 
   /*!
    * \brief A RAII wrapper that pushes and pops VM frames.
@@ -400,6 +494,23 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   virtual void RunInstrCall(VMFrame* curr_frame, Instruction inst);
 
+  /*!
+   * \brief Run a pre-decoded call to a PackedFunc, without instrumentation.
+   * \param curr_frame The current frame.
+   * \param decoded The decoded call instruction.
+   * \note This function does not increment the program counter.
+   */
+  void RunDecodedPackedCall(VMFrame* curr_frame, const DecodedInstr& decoded);
+
+  /*!
+   * \brief Whether the dispatch loop can directly run the pre-decoded PackedFunc calls.
+   * \return False when every call needs to go through RunInstrCall, e.g. for instrumentation
+   *  or tracing.
+   */
+  virtual bool UseFastDispatch() const {
+    return instrument_ == nullptr && !profiling::TracingEnabled();
+  }
+
   /*! \brief Run VM dispatch loop. */
   void RunLoop();
 
@@ -432,6 +543,10 @@ class VirtualMachineImpl : public VirtualMachine {
    * \brief Function pool to cache functions in func_table
    */
   std::vector<TVMRetValue> func_pool_;
+  /*! \brief The pre-decoded instructions, indexed by program counter. */
+  std::vector<DecodedInstr> decoded_instrs_;
+  /*! \brief The shape-checking prologue of each function, indexed by function index. */
+  std::vector<ShapePrologue> shape_prologues_;
   //--------------------------------------------------------
   // Executor interface support
   //--------------------------------------------------------
@@ -489,6 +604,8 @@ void VirtualMachineImpl::Init(const std::vector<Device>& devices,
   }
   // Setup function sections.
   this->InitFuncPool();
+  this->DecodeInstructions();
+  this->InitShapePrologues();
 }
 
 VMFuncInfo VirtualMachineImpl::LookupVMFuncInfo(const std::string& func_name) {
@@ -700,12 +817,25 @@ RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegTy
   }
   // set program counter
   pc_ = gfunc.start_instr;
+  if (this->UseFastDispatch()) {
+    RunShapePrologue(gf_idx, curr_frame, args);
+  }
   RunLoop();
   return return_value_;
 }
 
 void VirtualMachineImpl::InitFuncPool() {
   func_pool_.resize(exec_->func_table.size());
+  // Resolve the packed functions in one pass, which later VMs of the libraries find cached.
+  std::vector<String> func_names;
+  for (const VMFuncInfo& info : exec_->func_table) {
+    if (info.kind == VMFuncInfo::FuncKind::kPackedFunc) {
+      func_names.push_back(info.name);
+    }
+  }
+  for (const Module& lib : this->imports_) {
+    PrelinkLibraryModules(lib, func_names);
+  }
 
   for (size_t func_index = 0; func_index < exec_->func_table.size(); ++func_index) {
     const VMFuncInfo& info = exec_->func_table[func_index];
@@ -731,6 +861,191 @@ void VirtualMachineImpl::InitFuncPool() {
   }
 }
 
+void VirtualMachineImpl::DecodeInstructions() {
+  size_t num_instrs = exec_->instr_offset.size();
+  decoded_instrs_.clear();
+  decoded_instrs_.resize(num_instrs);
+  for (size_t pc = 0; pc < num_instrs; ++pc) {
+    DecodedInstr& decoded = decoded_instrs_[pc];
+    decoded.instr = exec_->GetInstruction(pc);
+    if (decoded.instr.op == Opcode::Call) {
+      ICHECK_LT(static_cast<size_t>(decoded.instr.func_idx), this->func_pool_.size());
+      const TVMRetValue& callee = func_pool_[decoded.instr.func_idx];
+      if (callee.type_code() == kTVMPackedFuncHandle) {
+        decoded.packed_func = static_cast<const PackedFuncObj*>(callee.value().v_handle);
+      }
+    }
+  }
+  // Compute the length of PackedFunc call runs backwards, so that a jump
+  // into the middle of a run still executes the remainder as one unit.
+  for (size_t pc = num_instrs; pc-- > 0;) {
+    DecodedInstr& decoded = decoded_instrs_[pc];
+    if (decoded.packed_func != nullptr) {
+      decoded.num_packed_calls =
+          1 + (pc + 1 < num_instrs ? decoded_instrs_[pc + 1].num_packed_calls : 0);
+    }
+  }
+}
+
+void VirtualMachineImpl::InitShapePrologues() {
+  static const std::unordered_set<std::string> kPrologueBuiltins = {
+      "vm.builtin.alloc_shape_heap", "vm.builtin.match_shape",
+      "vm.builtin.match_prim_value", "vm.builtin.check_tensor_info",
+      "vm.builtin.check_shape_info", "vm.builtin.check_prim_value_info",
+  };
+  shape_prologues_.clear();
+  shape_prologues_.resize(exec_->func_table.size());
+  for (size_t func_index = 0; func_index < exec_->func_table.size(); ++func_index) {
+    const VMFuncInfo& info = exec_->func_table[func_index];
+    if (info.kind != VMFuncInfo::FuncKind::kVMFunc) continue;
+    ShapePrologue& prologue = shape_prologues_[func_index];
+    RegName heap_reg = Instruction::kVoidRegister;
+
+    Index pc = info.start_instr;
+    for (; pc < info.end_instr; ++pc) {
+      const DecodedInstr& decoded = decoded_instrs_[pc];
+      if (decoded.packed_func == nullptr) break;
+      const Instruction& instr = decoded.instr;
+      const std::string& callee = GetFuncName(instr.func_idx);
+      bool is_alloc_heap = callee == "vm.builtin.alloc_shape_heap";
+      // Shape functions generated by VMShapeLower only take the shape heap.
+      bool is_shape_func = callee.compare(0, 10, "shape_func") == 0 && instr.num_args == 1 &&
+                           instr.args[0].kind() == Instruction::ArgKind::kRegister &&
+                           instr.args[0].value() == heap_reg;
+      if (!kPrologueBuiltins.count(callee) && !is_shape_func) break;
+      if (is_alloc_heap) {
+        if (prologue.alloc_heap_pc != -1 || instr.dst >= Instruction::kBeginSpecialReg) break;
+      } else if (instr.dst < Instruction::kBeginSpecialReg) {
+        break;
+      }
+      // The prologue may only read the arguments, the shape heap and the constants.
+      bool pure_args = true;
+      for (Index i = 0; i < instr.num_args; ++i) {
+        Instruction::Arg arg = instr.args[i];
+        if (arg.kind() == Instruction::ArgKind::kFuncIdx) {
+          pure_args = false;
+        } else if (arg.kind() == Instruction::ArgKind::kRegister) {
+          RegName reg = arg.value();
+          pure_args &=
+              reg < info.num_args || reg == heap_reg || reg >= Instruction::kBeginSpecialReg;
+        }
+      }
+      if (!pure_args) break;
+      if (is_alloc_heap) {
+        prologue.alloc_heap_pc = pc;
+        heap_reg = instr.dst;
+      }
+    }
+    prologue.num_instrs = pc - info.start_instr;
+  }
+}
+
+void VirtualMachineImpl::RunShapePrologue(Index gf_idx, VMFrame* curr_frame,
+                                          const std::vector<RegType>& args) {
+  ShapePrologue& prologue = shape_prologues_[gf_idx];
+  if (prologue.num_instrs == 0) return;
+
+  // Compute the shape signature of the arguments. Arguments whose checks are not
+  // determined by their type, dtype and shape disable the caching.
+  std::vector<int64_t> signature;
+  for (const RegType& arg : args) {
+    int type_code = arg.type_code();
+    signature.push_back(type_code);
+    if (type_code == kTVMNDArrayHandle) {
+      const DLTensor* tensor = arg.operator DLTensor*();
+      signature.push_back(tensor->dtype.code);
+      signature.push_back(tensor->dtype.bits);
+      signature.push_back(tensor->dtype.lanes);
+      signature.push_back(tensor->ndim);
+      signature.insert(signature.end(), tensor->shape, tensor->shape + tensor->ndim);
+    } else if (type_code == kTVMObjectHandle && arg.IsObjectRef<ShapeTuple>()) {
+      ShapeTuple shape = arg;
+      signature.push_back(shape.size());
+      signature.insert(signature.end(), shape.begin(), shape.end());
+    } else if (type_code == kDLInt) {
+      signature.push_back(arg.operator int64_t());
+    } else {
+      return;
+    }
+  }
+
+  const DecodedInstr* heap_alloc =
+      prologue.alloc_heap_pc == -1 ? nullptr : &decoded_instrs_[prologue.alloc_heap_pc];
+  Index end_pc = pc_ + prologue.num_instrs;
+  auto it = prologue.cache.find(signature);
+  if (it != prologue.cache.end()) {
+    // Cache hit: only allocate the shape heap and restore its content.
+    if (heap_alloc != nullptr) {
+      pc_ = prologue.alloc_heap_pc;
+      this->RunDecodedPackedCall(curr_frame, *heap_alloc);
+      DLTensor* heap = curr_frame->register_file[heap_alloc->instr.dst];
+      std::memcpy(heap->data, it->second.data(), it->second.size() * sizeof(int64_t));
+    }
+    pc_ = end_pc;
+    return;
+  }
+
+  // Cache miss: run the prologue, which throws if any check fails.
+  for (; pc_ < end_pc; ++pc_) {
+    this->RunDecodedPackedCall(curr_frame, decoded_instrs_[pc_]);
+  }
+  std::vector<int64_t> heap_values;
+  if (heap_alloc != nullptr) {
+    DLTensor* heap = curr_frame->register_file[heap_alloc->instr.dst];
+    const int64_t* heap_data = static_cast<const int64_t*>(heap->data);
+    heap_values.assign(heap_data, heap_data + heap->shape[0]);
+  }
+  if (prologue.cache.size() >= ShapePrologue::kMaxCacheEntries) {
+    prologue.cache.clear();
+  }
+  prologue.cache.emplace(std::move(signature), std::move(heap_values));
+}
+
+void VirtualMachineImpl::RunDecodedPackedCall(VMFrame* curr_frame, const DecodedInstr& decoded) {
+  const Instruction& instr = decoded.instr;
+  curr_frame->call_arg_values.resize(instr.num_args);
+  curr_frame->call_arg_tcodes.resize(instr.num_args);
+  TVMValue* values = curr_frame->call_arg_values.data();
+  int* tcodes = curr_frame->call_arg_tcodes.data();
+
+  runtime::TVMArgsSetter setter(values, tcodes);
+  for (Index i = 0; i < instr.num_args; ++i) {
+    Instruction::Arg arg = instr.args[i];
+    switch (arg.kind()) {
+      case Instruction::ArgKind::kRegister: {
+        RegName reg = arg.value();
+        if (reg < Instruction::kBeginSpecialReg) {
+          // Avoid copying the register value, the register file outlives the call.
+          setter(i, curr_frame->register_file[reg]);
+        } else {
+          setter(i, ReadRegister(curr_frame, reg));
+        }
+        break;
+      }
+      case Instruction::ArgKind::kImmediate: {
+        setter(i, arg.value());
+        break;
+      }
+      case Instruction::ArgKind::kConstIdx: {
+        setter(i, this->const_pool_[arg.value()]);
+        break;
+      }
+      case Instruction::ArgKind::kFuncIdx: {
+        setter(i, this->func_pool_[arg.value()]);
+        break;
+      }
+      default: {
+        LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+      }
+    }
+  }
+  TVMRetValue ret;
+  decoded.packed_func->CallPacked(TVMArgs(values, tcodes, instr.num_args), &ret);
+  if (instr.dst < Instruction::kBeginSpecialReg) {
+    WriteRegister(curr_frame, instr.dst, ret);
+  }
+}
+
 void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   DLOG(INFO) << "\n  pc = " << pc_ << ", execute: " << GetFuncName(instr.func_idx);
   int args_begin_offset = instrument_ != nullptr ? 4 : 0;
@@ -776,6 +1091,7 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   TVMRetValue ret;
 
   ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
+  profiling::TraceScope trace("relax_vm", GetFuncName(instr.func_idx));
 
   if (instrument_ == nullptr) {
     this->InvokeClosurePacked(func_pool_[instr.func_idx], args, &ret);
@@ -819,47 +1135,84 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
 
 void VirtualMachineImpl::RunLoop() {
   VMFrame* curr_frame = frames_.back().get();
-
+  const bool fast_dispatch = this->UseFastDispatch();
+  const DecodedInstr* decoded = nullptr;
+
+#if TVM_RELAX_VM_USE_COMPUTED_GOTO
+  // Indexed by Opcode, whose values start from 1.
+  static void* const kDispatchTable[] = {&&op_invalid, &&op_call, &&op_ret, &&op_goto, &&op_if};
+#define TVM_RELAX_VM_DISPATCH()                                                              \
+  do {                                                                                      \
+    ICHECK_LT(static_cast<size_t>(pc_), decoded_instrs_.size()) << "run into invalid section"; \
+    decoded = &decoded_instrs_[pc_];                                                        \
+    Opcode op = decoded->instr.op;                                                          \
+    goto* kDispatchTable[op >= Opcode::Call && op <= Opcode::If ? static_cast<int>(op) : 0]; \
+  } while (0)
+#define TVM_RELAX_VM_CASE(label, opcode) label:
+  TVM_RELAX_VM_DISPATCH();
+  {
+#else
+#define TVM_RELAX_VM_DISPATCH() continue
+#define TVM_RELAX_VM_CASE(label, opcode) case opcode:
   while (true) {
-    ICHECK_LT(static_cast<size_t>(pc_), exec_->instr_offset.size()) << "run into invalid section";
-    Instruction instr = exec_->GetInstruction(pc_);
-    switch (instr.op) {
-      case Opcode::Call: {
-        this->RunInstrCall(curr_frame, instr);
-        break;
-      }
-      case Opcode::Ret: {
-        // If we have hit the point from which we started
-        // running, we should return to the caller breaking
-        // the dispatch loop.
-        return_value_ = ReadRegister(curr_frame, instr.result);
-        RegName caller_return_register = curr_frame->caller_return_register;
-        if (frames_.size() <= 1) {
-          // directly return if no other frame in the call stack.
-        } else {
-          // return from a local call.
-          // Update the current frame to be the parent frame.
-          VMFrame* parent_frame = frames_.end()[-2].get();
-          WriteRegister(parent_frame, caller_return_register, return_value_);
+    ICHECK_LT(static_cast<size_t>(pc_), decoded_instrs_.size()) << "run into invalid section";
+    decoded = &decoded_instrs_[pc_];
+    switch (decoded->instr.op) {
+#endif
+    TVM_RELAX_VM_CASE(op_call, Opcode::Call) {
+      if (fast_dispatch && decoded->num_packed_calls != 0) {
+        // Run the whole PackedFunc call run as a superinstruction.
+        Index end_pc = pc_ + decoded->num_packed_calls;
+        for (; pc_ < end_pc; ++pc_) {
+          this->RunDecodedPackedCall(curr_frame, decoded_instrs_[pc_]);
         }
-        return;
+      } else {
+        this->RunInstrCall(curr_frame, decoded->instr);
       }
-      case Opcode::Goto: {
-        pc_ += instr.pc_offset;
-        break;
+      TVM_RELAX_VM_DISPATCH();
+    }
+    TVM_RELAX_VM_CASE(op_ret, Opcode::Ret) {
+      // If we have hit the point from which we started
+      // running, we should return to the caller breaking
+      // the dispatch loop.
+      return_value_ = ReadRegister(curr_frame, decoded->instr.result);
+      RegName caller_return_register = curr_frame->caller_return_register;
+      if (frames_.size() <= 1) {
+        // directly return if no other frame in the call stack.
+      } else {
+        // return from a local call.
+        // Update the current frame to be the parent frame.
+        VMFrame* parent_frame = frames_.end()[-2].get();
+        WriteRegister(parent_frame, caller_return_register, return_value_);
       }
-      case Opcode::If: {
-        int64_t cond_val = ReadRegister(curr_frame, instr.cond);
-        if (cond_val != 0) {
-          pc_++;
-        } else {
-          ICHECK_GT(instr.false_offset, 1);
-          pc_ += instr.false_offset;
-        }
-        break;
+      return;
+    }
+    TVM_RELAX_VM_CASE(op_goto, Opcode::Goto) {
+      pc_ += decoded->instr.pc_offset;
+      TVM_RELAX_VM_DISPATCH();
+    }
+    TVM_RELAX_VM_CASE(op_if, Opcode::If) {
+      int64_t cond_val = ReadRegister(curr_frame, decoded->instr.cond);
+      if (cond_val != 0) {
+        pc_++;
+      } else {
+        ICHECK_GT(decoded->instr.false_offset, 1);
+        pc_ += decoded->instr.false_offset;
       }
+      TVM_RELAX_VM_DISPATCH();
     }
+#if TVM_RELAX_VM_USE_COMPUTED_GOTO
+  op_invalid:
+    LOG(FATAL) << "Unknown opcode " << static_cast<int>(decoded->instr.op);
   }
+#else
+      default:
+        LOG(FATAL) << "Unknown opcode " << static_cast<int>(decoded->instr.op);
+    }
+  }
+#endif
+#undef TVM_RELAX_VM_DISPATCH
+#undef TVM_RELAX_VM_CASE
 }
 
 ObjectPtr<VirtualMachine> VirtualMachine::Create() { return make_object<VirtualMachineImpl>(); }
@@ -1086,6 +1439,11 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
     }
   }
 
+  bool UseFastDispatch() const override {
+    // Every call needs to go through RunInstrCall while profiling.
+    return !(prof_ && prof_->IsRunning()) && VirtualMachineImpl::UseFastDispatch();
+  }
+
  private:
   std::optional<profiling::Profiler> prof_;
 };
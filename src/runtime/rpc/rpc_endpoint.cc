@@ -24,6 +24,7 @@
 #include "rpc_endpoint.h"
 
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
@@ -39,6 +40,7 @@
 #include <vector>
 
 #include "../../support/arena.h"
+#include "../../support/lz4.h"
 #include "../../support/ring_buffer.h"
 #include "../../support/utils.h"
 #include "../object_internal.h"
@@ -102,6 +104,15 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   /*! \brief Finish the copy ack stage. */
   void FinishCopyAck() { this->SwitchToState(kRecvPacketNumBytes); }
 
+  /*! \brief Discard the remaining payload of the copy ack and finish the copy ack stage. */
+  void DiscardCopyAck() {
+    char buffer[4096];
+    while (pending_request_bytes_ != 0) {
+      this->Read(buffer, std::min(pending_request_bytes_, sizeof(buffer)));
+    }
+    this->FinishCopyAck();
+  }
+
   /*!
    * \brief Enter the io loop until the next event.
    * \param client_mode Whether we are in the client.
@@ -363,11 +374,11 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
           break;
         }
         case RPCCode::kCopyFromRemote: {
-          this->HandleCopyFromRemote();
+          this->HandleCopyFromRemote(false);
           break;
         }
         case RPCCode::kCopyToRemote: {
-          this->HandleCopyToRemote();
+          this->HandleCopyToRemote(false);
           break;
         }
         case RPCCode::kException:
@@ -447,15 +458,40 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
 
   void HandleSyscall(RPCCode code);
 
-  void HandleCopyFromRemote() {
+  /*!
+   * \brief Handle the request to copy data from the serving session.
+   * \param compressed Whether to reply with the compressed data, where the reply
+   *  carries the number of payload bytes before the payload. The payload is only
+   *  compressed when it is smaller than the data.
+   */
+  void HandleCopyFromRemote(bool compressed) {
     DLTensor* arr = RPCReference::ReceiveDLTensor(this);
     uint64_t data_bytes;
     this->Read(&data_bytes);
     size_t elem_bytes = (arr->dtype.bits * arr->dtype.lanes + 7) / 8;
     auto* sess = GetServingSession();
     // Return Copy Ack with the given data
-    auto fcopyack = [this](char* dptr, size_t num_bytes) {
+    auto fcopyack = [this, compressed](char* dptr, size_t num_bytes) {
       RPCCode code = RPCCode::kCopyAck;
+      if (compressed) {
+        char* payload = dptr;
+        uint64_t payload_bytes = num_bytes;
+        if (num_bytes != 0) {
+          char* buffer = this->ArenaAlloc<char>(num_bytes);
+          uint64_t compressed_bytes = support::LZ4Compress(dptr, num_bytes, buffer, num_bytes - 1);
+          if (compressed_bytes != 0) {
+            payload = buffer;
+            payload_bytes = compressed_bytes;
+          }
+        }
+        uint64_t packet_nbytes = sizeof(code) + sizeof(payload_bytes) + payload_bytes;
+        this->Write(packet_nbytes);
+        this->Write(code);
+        this->Write(payload_bytes);
+        this->WriteArray(payload, payload_bytes);
+        this->SwitchToState(kRecvPacketNumBytes);
+        return;
+      }
       uint64_t packet_nbytes = sizeof(code) + num_bytes;
 
       this->Write(packet_nbytes);
@@ -490,18 +526,36 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
     }
   }
 
-  void HandleCopyToRemote() {
+  /*!
+   * \brief Handle the request to copy data into the serving session.
+   * \param compressed Whether the request carries compressed data, preceded
+   *  by the number of payload bytes.
+   */
+  void HandleCopyToRemote(bool compressed) {
     DLTensor* arr = RPCReference::ReceiveDLTensor(this);
     uint64_t data_bytes;
     this->Read(&data_bytes);
     size_t elem_bytes = (arr->dtype.bits * arr->dtype.lanes + 7) / 8;
     auto* sess = GetServingSession();
+    // Read the data of the request into dptr.
+    auto fread_data = [this, compressed, data_bytes](char* dptr) {
+      if (compressed) {
+        uint64_t payload_bytes;
+        this->Read(&payload_bytes);
+        char* payload = this->ArenaAlloc<char>(payload_bytes);
+        this->ReadArray(payload, payload_bytes);
+        ICHECK(support::LZ4Decompress(payload, payload_bytes, dptr, data_bytes))
+            << "Server[" << name_ << "]: Invalid compressed data in CopyToRemote";
+      } else {
+        this->ReadArray(dptr, data_bytes);
+      }
+    };
 
     // When session is local, we can directly treat handle
     // as the cpu pointer without allocating a temp space.
     if (arr->device.device_type == kDLCPU && sess->IsLocalSession()) {
       char* dptr = reinterpret_cast<char*>(arr->data) + arr->byte_offset;
-      this->ReadArray(dptr, data_bytes);
+      fread_data(dptr);
 
       if (!DMLC_IO_NO_ENDIAN_SWAP) {
         dmlc::ByteSwap(dptr, elem_bytes, data_bytes / elem_bytes);
@@ -510,7 +564,7 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
       this->SwitchToState(kRecvPacketNumBytes);
     } else {
       char* temp_data = this->ArenaAlloc<char>(data_bytes);
-      this->ReadArray(temp_data, data_bytes);
+      fread_data(temp_data);
 
       if (!DMLC_IO_NO_ENDIAN_SWAP) {
         dmlc::ByteSwap(temp_data, elem_bytes, data_bytes / elem_bytes);
@@ -871,46 +925,168 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_v
   ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
 }
 
-void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+void RPCEndpoint::FlushWriter() {
+  while (writer_.bytes_available() != 0) {
+    writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+  }
+}
+
+void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                               const RPCBulkTransferConfig& config) {
   std::lock_guard<std::mutex> lock(mutex_);
-  RPCCode code = RPCCode::kCopyToRemote;
+  auto tbegin = std::chrono::high_resolution_clock::now();
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
   ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ICHECK_GT(config.chunk_bytes, 0U) << "CopyToRemote: Invalid block size!";
+  ICHECK_GT(config.max_outstanding_chunks, 0);
+
+  uint64_t base_offset = to->byte_offset;
+  int num_outstanding = 0;
+  // The first error from the remote, which is raised after all the outstanding
+  // chunks are acknowledged, so that the channel stays in sync.
+  std::exception_ptr error = nullptr;
+  auto fwait_ack = [&]() {
+    try {
+      ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+    } catch (const std::exception&) {
+      if (error == nullptr) error = std::current_exception();
+    }
+    --num_outstanding;
+  };
 
-  uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, nbytes);
-  uint64_t packet_nbytes = overhead + nbytes;
+  for (uint64_t offset = 0; offset < nbytes && error == nullptr; offset += config.chunk_bytes) {
+    uint64_t chunk_bytes = std::min(config.chunk_bytes, nbytes - offset);
+    char* chunk = static_cast<char*>(from_bytes) + offset;
+    to->byte_offset = base_offset + offset;
+
+    // Only keep the compressed payload when it is smaller than the chunk.
+    uint64_t payload_bytes = 0;
+    if (config.compression) {
+      compress_buffer_.resize(chunk_bytes);
+      payload_bytes =
+          support::LZ4Compress(chunk, chunk_bytes, compress_buffer_.data(), chunk_bytes - 1);
+    }
+    RPCCode code = payload_bytes != 0 ? RPCCode::kCopyToRemoteCompressed : RPCCode::kCopyToRemote;
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, chunk_bytes);
+
+    if (payload_bytes != 0) {
+      handler_->Write(overhead + sizeof(payload_bytes) + payload_bytes);
+      handler_->Write(code);
+      RPCReference::SendDLTensor(handler_, to);
+      handler_->Write(chunk_bytes);
+      handler_->Write(payload_bytes);
+      handler_->WriteArray(compress_buffer_.data(), payload_bytes);
+      ++transfer_stats_.num_compressed_chunks;
+    } else {
+      payload_bytes = chunk_bytes;
+      handler_->Write(overhead + chunk_bytes);
+      handler_->Write(code);
+      RPCReference::SendDLTensor(handler_, to);
+      handler_->Write(chunk_bytes);
+      handler_->WriteArray(chunk, chunk_bytes);
+    }
+    this->FlushWriter();
+    transfer_stats_.bytes_to_remote += chunk_bytes;
+    transfer_stats_.wire_bytes_to_remote += payload_bytes;
+    ++transfer_stats_.num_chunks;
 
-  handler_->Write(packet_nbytes);
-  handler_->Write(code);
-  RPCReference::SendDLTensor(handler_, to);
-  handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+    if (++num_outstanding == config.max_outstanding_chunks) fwait_ack();
+  }
+  while (num_outstanding != 0) fwait_ack();
+  to->byte_offset = base_offset;
+
+  auto tend = std::chrono::high_resolution_clock::now();
+  transfer_stats_.transfer_time_us +=
+      std::chrono::duration_cast<std::chrono::microseconds>(tend - tbegin).count();
+  if (error != nullptr) std::rethrow_exception(error);
 }
 
-void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
+void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                 const RPCBulkTransferConfig& config) {
   std::lock_guard<std::mutex> lock(mutex_);
-  RPCCode code = RPCCode::kCopyFromRemote;
+  auto tbegin = std::chrono::high_resolution_clock::now();
+  RPCCode code = config.compression ? RPCCode::kCopyFromRemoteCompressed : RPCCode::kCopyFromRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
   ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ICHECK_GT(config.chunk_bytes, 0U) << "CopyFromRemote: Invalid block size!";
+  ICHECK_GT(config.max_outstanding_chunks, 0);
+
+  uint64_t base_offset = from->byte_offset;
+  uint64_t request_offset = 0;
+  uint64_t recv_offset = 0;
+  int num_outstanding = 0;
+  // The first error from the remote, which is raised after all the outstanding
+  // requests are answered, so that the channel stays in sync.
+  std::exception_ptr error = nullptr;
+
+  while (recv_offset < nbytes) {
+    // Keep the pipeline of requests full.
+    while (request_offset < nbytes && num_outstanding < config.max_outstanding_chunks &&
+           error == nullptr) {
+      uint64_t chunk_bytes = std::min(config.chunk_bytes, nbytes - request_offset);
+      from->byte_offset = base_offset + request_offset;
+      handler_->Write(RemoteCopyCalculatePacketOverheadSize(from, code, chunk_bytes));
+      handler_->Write(code);
+      RPCReference::SendDLTensor(handler_, from);
+      handler_->Write(chunk_bytes);
+      request_offset += chunk_bytes;
+      ++num_outstanding;
+    }
+    if (num_outstanding == 0) break;
 
-  uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(from, code, nbytes);
-  uint64_t packet_nbytes = overhead;
+    uint64_t chunk_bytes = std::min(config.chunk_bytes, nbytes - recv_offset);
+    char* chunk = static_cast<char*>(to_bytes) + recv_offset;
+    try {
+      ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+      if (error != nullptr) {
+        handler_->DiscardCopyAck();
+      } else if (config.compression) {
+        uint64_t payload_bytes;
+        handler_->Read(&payload_bytes);
+        if (payload_bytes == chunk_bytes) {
+          handler_->ReadArray(chunk, chunk_bytes);
+          handler_->FinishCopyAck();
+        } else {
+          compress_buffer_.resize(payload_bytes);
+          handler_->ReadArray(compress_buffer_.data(), payload_bytes);
+          handler_->FinishCopyAck();
+          ICHECK(support::LZ4Decompress(compress_buffer_.data(), payload_bytes, chunk, chunk_bytes))
+              << "CopyFromRemote: Invalid compressed data from the remote";
+          ++transfer_stats_.num_compressed_chunks;
+        }
+        transfer_stats_.wire_bytes_from_remote += payload_bytes;
+      } else {
+        handler_->ReadArray(chunk, chunk_bytes);
+        handler_->FinishCopyAck();
+        transfer_stats_.wire_bytes_from_remote += chunk_bytes;
+      }
+    } catch (const std::exception&) {
+      if (error == nullptr) error = std::current_exception();
+    }
+    transfer_stats_.bytes_from_remote += chunk_bytes;
+    ++transfer_stats_.num_chunks;
+    recv_offset += chunk_bytes;
+    --num_outstanding;
+  }
+  from->byte_offset = base_offset;
 
-  handler_->Write(packet_nbytes);
-  handler_->Write(code);
-  RPCReference::SendDLTensor(handler_, from);
-  handler_->Write(nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+  auto tend = std::chrono::high_resolution_clock::now();
+  transfer_stats_.transfer_time_us +=
+      std::chrono::duration_cast<std::chrono::microseconds>(tend - tbegin).count();
+  if (error != nullptr) std::rethrow_exception(error);
+}
 
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
-  handler_->FinishCopyAck();
+RPCTransferStats RPCEndpoint::GetTransferStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return transfer_stats_;
 }
 
 // SysCallEventHandler functions
@@ -1058,6 +1234,12 @@ void RPCEndpoint::EventHandler::HandleSyscall(RPCCode code) {
     case RPCCode::kCopyAmongRemote:
       SysCallHandler(RPCCopyAmongRemote);
       break;
+    case RPCCode::kCopyToRemoteCompressed:
+      this->HandleCopyToRemote(true);
+      break;
+    case RPCCode::kCopyFromRemoteCompressed:
+      this->HandleCopyFromRemote(true);
+      break;
     default:
       LOG(FATAL) << "Unknown event " << static_cast<int>(code);
   }
@@ -1088,55 +1270,13 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
   }
 
   void CopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyToRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* from_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, remainder_bytes);
-    }
+    endpoint_->CopyToRemote(local_from_bytes, remote_to, nbytes,
+                            GetBulkTransferConfig(remote_to, RPCCode::kCopyToRemote));
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyFromRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* to_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, remainder_bytes);
-    }
+    endpoint_->CopyFromRemote(remote_from, local_to_bytes, nbytes,
+                              GetBulkTransferConfig(remote_from, RPCCode::kCopyFromRemote));
   }
 
   void FreeHandle(void* handle, int type_code) final {
@@ -1210,7 +1350,47 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
 
   void Shutdown() final { endpoint_->Shutdown(); }
 
+  /*!
+   * \brief Set the options of the bulk data copies.
+   * \param config The options.
+   */
+  void SetBulkTransferConfig(const RPCBulkTransferConfig& config) {
+    ICHECK_GT(config.chunk_bytes, 0U) << "ValueError: chunk_bytes must be positive";
+    ICHECK_GT(config.max_outstanding_chunks, 0)
+        << "ValueError: max_outstanding_chunks must be positive";
+    bulk_transfer_config_ = config;
+  }
+
+  /*! \return The counters of the bulk data copies. */
+  RPCTransferStats GetTransferStats() { return endpoint_->GetTransferStats(); }
+
  private:
+  /*!
+   * \brief Get the options of a bulk data copy, bounded by the limits of the remote.
+   * \param tensor The remote tensor of the copy.
+   * \param code The RPCCode of the copy.
+   * \return The options.
+   */
+  RPCBulkTransferConfig GetBulkTransferConfig(DLTensor* tensor, RPCCode code) {
+    RPCBulkTransferConfig config = bulk_transfer_config_;
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(tensor, code, 0);
+    uint64_t rpc_max_size = GetRPCMaxTransferSize();
+    ICHECK_GT(rpc_max_size, overhead) << "Invalid block size!";
+    config.chunk_bytes = std::min(config.chunk_bytes, rpc_max_size - overhead);
+    // Remotes with a bounded packet size (e.g. microTVM) receive one packet at a time.
+    if (remote_packet_size_bounded_) {
+      config.max_outstanding_chunks = 1;
+      config.compression = false;
+    }
+    if (config.compression && remote_supports_compression_ < 0) {
+      PackedFuncHandle rpc_func = GetFunction("tvm.rpc.server.SupportsCompressedCopy");
+      remote_supports_compression_ = rpc_func != nullptr;
+      if (rpc_func != nullptr) FreeHandle(rpc_func, kTVMPackedFuncHandle);
+    }
+    config.compression = config.compression && remote_supports_compression_ == 1;
+    return config;
+  }
+
   uint64_t GetRPCMaxTransferSize() {
     if (rpc_chunk_max_size_bytes_ > 0) {
       return (uint64_t)rpc_chunk_max_size_bytes_;
@@ -1220,6 +1400,7 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     if (rpc_func == nullptr) {
       rpc_chunk_max_size_bytes_ = (int64_t)kRPCMaxTransferSizeBytesDefault;
     } else {
+      remote_packet_size_bounded_ = true;
       CallFunc(rpc_func, nullptr, nullptr, 0, [this](TVMArgs args) {
         // Use args[1] as return value, args[0] is tcode
         // Look at RPCWrappedFunc in src/runtime/rpc/rpc_module.cc
@@ -1234,12 +1415,50 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
 
   std::shared_ptr<RPCEndpoint> endpoint_;
   int64_t rpc_chunk_max_size_bytes_ = -1;
+  // Whether the remote reports a bounded packet size.
+  bool remote_packet_size_bounded_ = false;
+  // Whether the remote supports compressed copies, -1 if not yet queried.
+  int remote_supports_compression_ = -1;
+  // The options of the bulk data copies.
+  RPCBulkTransferConfig bulk_transfer_config_;
 };
 
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
   return std::make_shared<RPCClientSession>(endpoint);
 }
 
+RPCClientSession* GetRPCClientSession(Module mod) {
+  auto* sess = dynamic_cast<RPCClientSession*>(RPCModuleGetSession(mod).get());
+  ICHECK(sess != nullptr) << "ValueError: Bulk transfer options are only available to the "
+                          << "sessions connected to a remote server";
+  return sess;
+}
+
+TVM_REGISTER_GLOBAL("rpc.SessSetBulkTransferConfig")
+    .set_body_typed([](Module mod, int64_t chunk_bytes, int max_outstanding_chunks,
+                       bool compression) {
+      RPCBulkTransferConfig config;
+      ICHECK_GT(chunk_bytes, 0) << "ValueError: chunk_bytes must be positive";
+      config.chunk_bytes = chunk_bytes;
+      config.max_outstanding_chunks = max_outstanding_chunks;
+      config.compression = compression;
+      GetRPCClientSession(mod)->SetBulkTransferConfig(config);
+    });
+
+TVM_REGISTER_GLOBAL("rpc.SessTransferStats").set_body_typed([](Module mod) {
+  RPCTransferStats stats = GetRPCClientSession(mod)->GetTransferStats();
+  return ShapeTuple({static_cast<int64_t>(stats.bytes_to_remote),
+                     static_cast<int64_t>(stats.bytes_from_remote),
+                     static_cast<int64_t>(stats.wire_bytes_to_remote),
+                     static_cast<int64_t>(stats.wire_bytes_from_remote),
+                     static_cast<int64_t>(stats.num_chunks),
+                     static_cast<int64_t>(stats.num_compressed_chunks),
+                     static_cast<int64_t>(stats.transfer_time_us)});
+});
+
+// The servers built from this endpoint can decode the compressed copies.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.SupportsCompressedCopy").set_body_typed([]() { return true; });
+
 uint64_t RemoteCopyCalculatePacketOverheadSize(DLTensor* tensor, RPCCode code, uint64_t nbytes) {
   uint64_t shape_bytes = tensor->ndim * sizeof(int64_t);
   uint64_t to_data = reinterpret_cast<uint64_t>(static_cast<uint8_t*>(tensor->data));
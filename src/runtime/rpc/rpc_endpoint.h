@@ -30,6 +30,7 @@
 #include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "../../support/ring_buffer.h"
 #include "../minrpc/rpc_reference.h"
@@ -62,6 +63,39 @@ enum class TrackerCode : int {
   kGetPendingMatchKeys = 7
 };
 
+/*! \brief The default maximum size of the chunks that a bulk data copy is split into. */
+const uint64_t kRPCBulkChunkBytesDefault = 4 << 20;
+/*! \brief The default maximum number of chunks in flight during a bulk data copy. */
+const int kRPCMaxOutstandingChunksDefault = 4;
+
+/*! \brief The options of the bulk data copies through an endpoint. */
+struct RPCBulkTransferConfig {
+  /*! \brief The maximum number of bytes in each chunk. */
+  uint64_t chunk_bytes{kRPCBulkChunkBytesDefault};
+  /*! \brief The maximum number of chunks sent before waiting for their acknowledgement. */
+  int max_outstanding_chunks{kRPCMaxOutstandingChunksDefault};
+  /*! \brief Whether to compress the chunks, which requires the support of the remote. */
+  bool compression{false};
+};
+
+/*! \brief The counters of the bulk data copies through an endpoint. */
+struct RPCTransferStats {
+  /*! \brief The number of tensor bytes copied to the remote. */
+  uint64_t bytes_to_remote{0};
+  /*! \brief The number of tensor bytes copied from the remote. */
+  uint64_t bytes_from_remote{0};
+  /*! \brief The number of payload bytes sent to the remote after compression. */
+  uint64_t wire_bytes_to_remote{0};
+  /*! \brief The number of payload bytes received from the remote after compression. */
+  uint64_t wire_bytes_from_remote{0};
+  /*! \brief The number of chunks transferred. */
+  uint64_t num_chunks{0};
+  /*! \brief The number of chunks transferred with compressed payloads. */
+  uint64_t num_compressed_chunks{0};
+  /*! \brief The total wall time spent in the bulk data copies, in microseconds. */
+  uint64_t transfer_time_us{0};
+};
+
 /*!
  * \brief Communication endpoints to connect local and remote RPC sessions.
  *        An endpoint can either be a client or a server.
@@ -142,26 +176,32 @@ class RPCEndpoint {
                 const int* arg_type_codes, int num_args, RPCSession::FEncodeReturn encode_return);
   /*!
    * \brief Copy bytes into remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
-   * \param to The target array.
-   * \param to_offset The byte offset in the to.
+   *
+   *  The data is split into chunks, where up to config.max_outstanding_chunks
+   *  chunks are sent before waiting for the acknowledgement of the earliest one.
+   *
+   * \param from_bytes The source host data.
+   * \param to The target array, whose byte_offset marks the start of the copy.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_to The target device.
-   * \param type_hint Hint of content data type.
+   * \param config The options of the bulk data copy.
    */
-  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                    const RPCBulkTransferConfig& config);
   /*!
    * \brief Copy bytes from remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
-   * \param to The target array.
-   * \param to_offset The byte offset in the to.
+   *
+   *  The data is requested in chunks, where up to config.max_outstanding_chunks
+   *  requests are sent before receiving the data of the earliest one.
+   *
+   * \param from The source array, whose byte_offset marks the start of the copy.
+   * \param to_bytes The target host data.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_from The source device.
-   * \param type_hint Hint of content data type.
+   * \param config The options of the bulk data copy.
    */
-  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
+  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                      const RPCBulkTransferConfig& config);
+  /*! \return The counters of the bulk data copies through this endpoint. */
+  RPCTransferStats GetTransferStats();
 
   /*!
    * \brief Call a remote defined system function with arguments.
@@ -191,6 +231,8 @@ class RPCEndpoint {
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
   // Initalization
   void Init();
+  // Send all the pending bytes in the writer to the channel.
+  void FlushWriter();
   // Internal channel.
   std::unique_ptr<RPCChannel> channel_;
 
@@ -208,6 +250,10 @@ class RPCEndpoint {
   std::string remote_key_;
   // Invoked when the RPC session is terminated
   TypedPackedFunc<void()> fcleanup_;
+  // The counters of the bulk data copies.
+  RPCTransferStats transfer_stats_;
+  // The buffer of the compressed chunks.
+  std::vector<char> compress_buffer_;
 };
 
 /*!
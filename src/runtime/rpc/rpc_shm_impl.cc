@@ -0,0 +1,232 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_shm_impl.cc
+ * \brief Shared memory based RPC channel for the sessions on the same host.
+ *
+ *  The channel consists of two single-producer single-consumer byte rings
+ *  in a shared memory segment, one for each direction. The data never goes
+ *  through the kernel, and the peers only make a syscall (futex) to sleep when
+ *  the ring is empty or full for a while.
+ */
+// Linux only for now, as linux is the most common usecase.
+#if defined(__linux__) || defined(__ANDROID__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../../support/shared_memory_ring.h"
+#include "rpc_endpoint.h"
+#include "rpc_local_session.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief The header of the shared memory segment. */
+struct SharedMemorySegmentHeader {
+  /*! \brief The magic number to validate the segment. */
+  uint64_t magic;
+  /*! \brief The capacity of each ring in bytes. */
+  uint64_t ring_bytes;
+  /*! \brief The process ids of the client and the server. */
+  std::atomic<int32_t> pid[2];
+  /*! \brief Set when either side closes the channel. */
+  std::atomic<uint32_t> closed;
+  /*! \brief The ring from the client to the server, and the one backwards. */
+  support::SharedMemoryRingHeader ring[2];
+};
+
+/*! \brief The magic number of the shared memory segment of the RPC channel. */
+constexpr uint64_t kSharedMemoryRPCMagic = 0x54564d53484d5250;  // "TVMSHMRP"
+
+/*!
+ * \brief RPC channel on a shared memory segment.
+ *
+ *  The segment is created by the client and inherited by the server process
+ *  as a file descriptor, so it is released when both processes exit.
+ */
+class SharedMemoryChannel final : public RPCChannel {
+ public:
+  /*!
+   * \brief Map the shared memory segment.
+   * \param fd The file descriptor of the segment.
+   * \param is_server Whether this is the server side of the channel.
+   * \param child_pid The process id of the server to be killed on close, or -1.
+   */
+  SharedMemoryChannel(int fd, bool is_server, pid_t child_pid)
+      : fd_(fd), side_(is_server ? 1 : 0), child_pid_(child_pid) {
+    struct stat st;
+    ICHECK_EQ(fstat(fd_, &st), 0) << "Cannot stat the shared memory segment: " << strerror(errno);
+    map_bytes_ = st.st_size;
+    void* ptr = mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    ICHECK(ptr != MAP_FAILED) << "Cannot map the shared memory segment: " << strerror(errno);
+    header_ = static_cast<SharedMemorySegmentHeader*>(ptr);
+    ICHECK_EQ(header_->magic, kSharedMemoryRPCMagic) << "Invalid shared memory RPC segment";
+    uint64_t ring_bytes = header_->ring_bytes;
+    char* data = static_cast<char*>(ptr) + sizeof(SharedMemorySegmentHeader);
+    send_ring_ = support::SharedMemoryRing(&header_->ring[side_], data + side_ * ring_bytes,
+                                           ring_bytes);
+    recv_ring_ = support::SharedMemoryRing(&header_->ring[1 - side_],
+                                           data + (1 - side_) * ring_bytes, ring_bytes);
+    header_->pid[side_].store(getpid());
+  }
+
+  ~SharedMemoryChannel() { Close(); }
+
+  /*!
+   * \brief Create a shared memory segment for a channel.
+   * \param ring_bytes The capacity of the ring of each direction.
+   * \return The file descriptor of the segment.
+   */
+  static int CreateSegment(uint64_t ring_bytes) {
+    // Close-on-exec, so that the segment only leaks into the server it is meant for.
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "tvm-rpc-shm", MFD_CLOEXEC));
+    ICHECK_GE(fd, 0) << "Cannot create the shared memory segment: " << strerror(errno);
+    uint64_t total_bytes = sizeof(SharedMemorySegmentHeader) + 2 * ring_bytes;
+    ICHECK_EQ(ftruncate(fd, total_bytes), 0)
+        << "Cannot allocate the shared memory segment: " << strerror(errno);
+    void* ptr = mmap(nullptr, total_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ICHECK(ptr != MAP_FAILED) << "Cannot map the shared memory segment: " << strerror(errno);
+    // The segment is zero-filled, which is the initial state of the rings.
+    auto* header = new (ptr) SharedMemorySegmentHeader();
+    header->ring_bytes = ring_bytes;
+    header->pid[0].store(-1);
+    header->pid[1].store(-1);
+    header->magic = kSharedMemoryRPCMagic;
+    munmap(ptr, total_bytes);
+    return fd;
+  }
+
+  size_t Send(const void* data, size_t size) final {
+    size_t nbytes = send_ring_.Write(data, size, [this]() { return PeerAlive(); });
+    if (nbytes == 0 && size != 0) {
+      LOG(FATAL) << "Shared memory channel is closed by the peer";
+    }
+    return nbytes;
+  }
+
+  size_t Recv(void* data, size_t size) final {
+    // Returns 0 when the peer is gone, which is handled as the end of the channel.
+    return recv_ring_.Read(data, size, [this]() { return PeerAlive(); });
+  }
+
+  void Close() {
+    if (header_ == nullptr) return;
+    header_->closed.store(1);
+    send_ring_.WakeAll();
+    recv_ring_.WakeAll();
+    munmap(header_, map_bytes_);
+    header_ = nullptr;
+    close(fd_);
+    if (child_pid_ > 0 && !child_exited_) {
+      kill(child_pid_, SIGKILL);
+      waitpid(child_pid_, nullptr, 0);
+    }
+  }
+
+ private:
+  /*! \return Whether the peer may still use the channel. */
+  bool PeerAlive() {
+    if (header_->closed.load() != 0) return false;
+    if (child_pid_ > 0) {
+      // The server is our child, reap it so that an exited server is not kept as a zombie.
+      if (!child_exited_ && waitpid(child_pid_, nullptr, WNOHANG) == child_pid_) {
+        child_exited_ = true;
+      }
+      return !child_exited_;
+    }
+    int32_t peer_pid = header_->pid[1 - side_].load();
+    if (peer_pid < 0) return true;
+    // The client forks the server, so the server is orphaned once the client is gone.
+    if (side_ == 1 && getppid() != peer_pid) return false;
+    return kill(peer_pid, 0) == 0 || errno != ESRCH;
+  }
+
+  int fd_;
+  int side_;
+  pid_t child_pid_;
+  bool child_exited_{false};
+  size_t map_bytes_{0};
+  SharedMemorySegmentHeader* header_{nullptr};
+  support::SharedMemoryRing send_ring_;
+  support::SharedMemoryRing recv_ring_;
+};
+
+Module CreateSharedMemoryClient(uint64_t ring_bytes, std::vector<std::string> cmd) {
+  int fd = SharedMemoryChannel::CreateSegment(ring_bytes);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    // child process, which inherits the segment.
+    if (fcntl(fd, F_SETFD, 0) != 0) _exit(127);
+    std::string sfd = std::to_string(fd);
+    std::vector<char*> argv;
+    for (auto& str : cmd) {
+      argv.push_back(dmlc::BeginPtr(str));
+    }
+    argv.push_back(dmlc::BeginPtr(sfd));
+    argv.push_back(nullptr);
+    execvp(argv[0], &argv[0]);
+    _exit(127);
+  }
+  ICHECK_GT(pid, 0) << "Cannot fork the shared memory RPC server: " << strerror(errno);
+  // parent process
+  auto endpt = RPCEndpoint::Create(std::make_unique<SharedMemoryChannel>(fd, false, pid),
+                                   "SharedMemoryClient", "shm");
+  endpt->InitRemoteSession(TVMArgs(nullptr, nullptr, 0));
+  return CreateRPCSessionModule(CreateClientSession(endpt));
+}
+
+void SharedMemoryServerLoop(int fd) {
+  RPCEndpoint::Create(std::make_unique<SharedMemoryChannel>(fd, true, -1),
+                      "SharedMemoryServerLoop", "")
+      ->ServerLoop();
+}
+
+TVM_REGISTER_GLOBAL("rpc.CreateSharedMemoryClient").set_body([](TVMArgs args, TVMRetValue* rv) {
+  int64_t ring_bytes = args[0];
+  ICHECK_GT(ring_bytes, 0) << "ValueError: ring_bytes must be positive";
+  std::vector<std::string> cmd;
+  for (int i = 1; i < args.size(); ++i) {
+    cmd.push_back(args[i].operator std::string());
+  }
+  *rv = CreateSharedMemoryClient(ring_bytes, cmd);
+});
+
+TVM_REGISTER_GLOBAL("rpc.SharedMemoryServerLoop").set_body_typed(SharedMemoryServerLoop);
+
+}  // namespace runtime
+}  // namespace tvm
+#endif
@@ -79,6 +79,9 @@ class SystemLibrary : public Library {
     return reg_->GetSymbol(name);
   }
 
+  // Symbols can be registered or overridden at any time, e.g. by a library loaded later.
+  bool HasFixedSymbols() const final { return false; }
+
  private:
   SystemLibSymbolRegistry* reg_ = SystemLibSymbolRegistry::Global();
   std::string symbol_prefix_;
@@ -29,6 +29,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/threading_backend.h>
+#include <tvm/runtime/tracing.h>
 #if TVM_THREADPOOL_USE_OPENMP
 #include <omp.h>
 #endif
@@ -128,8 +129,11 @@ class ParallelLauncher {
   // Local env
   TVMParallelGroupEnv env;
   // Whether this thread is worker of the pool.
-  // used to prevent recursive launch.
+  // used to run recursive launches inline.
   bool is_worker{false};
+  // Whether this thread is running a parallel job of its own.
+  // used to run recursive launches inline.
+  bool is_launching{false};
 
  private:
   // The pending jobs.
@@ -286,8 +290,15 @@ class ThreadPool {
 
   int Launch(FTVMParallelLambda flambda, void* cdata, int num_task, int need_sync) {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
-    ICHECK(!launcher->is_worker)
-        << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    if (launcher->is_worker || launcher->is_launching) {
+      // A job launched from inside a parallel task, e.g. by an operator that itself runs as a
+      // task, cannot use the busy workers. Run it inline as a single task instead.
+      std::atomic<int32_t> sync_counter{0};
+      TVMParallelGroupEnv env;
+      env.num_task = 1;
+      env.sync_handle = &sync_counter;
+      return (*flambda)(0, &env, cdata) == 0 ? 0 : -1;
+    }
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -296,7 +307,9 @@ class ThreadPool {
           << "Request parallel sync task larger than number of threads used "
           << " workers=" << num_workers_used_ << " request=" << num_task;
     }
+    profiling::TraceScope trace("thread_pool", "ParallelLaunch");
     launcher->Init(flambda, cdata, num_task, need_sync != 0);
+    launcher->is_launching = true;
     SpscTaskQueue::Task tsk;
     tsk.launcher = launcher;
     // if worker0 is taken by the main, queues_[0] is abandoned
@@ -306,6 +319,7 @@ class ThreadPool {
     }
     // use the main thread to run task 0
     if (exclude_worker0_) {
+      profiling::TraceScope task_trace("thread_pool", "ParallelTask");
       TVMParallelGroupEnv* penv = &(tsk.launcher->env);
       if ((*tsk.launcher->flambda)(0, penv, cdata) == 0) {
         tsk.launcher->SignalJobFinish();
@@ -314,6 +328,7 @@ class ThreadPool {
       }
     }
     int res = launcher->WaitForJobs();
+    launcher->is_launching = false;
     return res;
   }
 
@@ -353,8 +368,10 @@ class ThreadPool {
     // the global first use of the ThreadPool.
     // TODO(tulloch): should we make this configurable via standard APIs?
     static size_t spin_count = GetSpinCount();
+    profiling::SetTraceThreadName("tvm thread pool worker " + std::to_string(worker_id));
     while (queue->Pop(&task, spin_count)) {
       ICHECK(task.launcher != nullptr);
+      profiling::TraceScope trace("thread_pool", "ParallelTask");
       TVMParallelGroupEnv* penv = &(task.launcher->env);
       void* cdata = task.launcher->cdata;
       if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
@@ -0,0 +1,261 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/tracing.cc
+ * \brief Per-thread trace event buffers and their Chrome trace export.
+ */
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/tracing.h>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+namespace {
+
+/*! \brief An event recorded by a thread. */
+struct TraceEvent {
+  int64_t begin_ns;
+  int64_t end_ns;
+  const char* category;
+  char name[kMaxTraceNameLength];
+};
+
+/*!
+ * \brief The events of a thread in a tracing session. Only the owner thread appends to it,
+ *  and it publishes each event by incrementing the size, so that the events can be exported
+ *  while the thread is still recording.
+ */
+struct ThreadTraceBuffer {
+  explicit ThreadTraceBuffer(int64_t capacity, int tid)
+      : events(new TraceEvent[capacity]), capacity(capacity), tid(tid) {}
+
+  std::unique_ptr<TraceEvent[]> events;
+  const int64_t capacity;
+  const int tid;
+  std::atomic<int64_t> size{0};
+  std::atomic<int64_t> num_dropped{0};
+  /*! \brief The name of the thread, guarded by the mutex of the tracer. */
+  std::string thread_name;
+};
+
+/*!
+ * \brief The global state of tracing. Starting a session bumps the generation, after which
+ *  each thread switches to a new buffer on its next event. The buffers of the old session
+ *  are released by their threads, so that a session never races with a stale writer.
+ */
+class Tracer {
+ public:
+  static Tracer* Global() {
+    static Tracer* inst = new Tracer();
+    return inst;
+  }
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void Start(int64_t events_per_thread) {
+    CHECK_GT(events_per_thread, 0) << "ValueError: The trace buffer must hold some events";
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.clear();
+    events_per_thread_ = events_per_thread;
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    enabled_.store(true, std::memory_order_release);
+  }
+
+  void Stop() { enabled_.store(false, std::memory_order_release); }
+
+  void Record(const char* category, const char* name, int64_t begin_ns, int64_t end_ns) {
+    ThreadTraceBuffer* buffer = CurrentBuffer();
+    int64_t index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= buffer->capacity) {
+      buffer->num_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    TraceEvent& event = buffer->events[index];
+    event.begin_ns = begin_ns;
+    event.end_ns = end_ns;
+    event.category = category;
+    std::strncpy(event.name, name, kMaxTraceNameLength - 1);
+    event.name[kMaxTraceNameLength - 1] = '\0';
+    buffer->size.store(index + 1, std::memory_order_release);
+  }
+
+  void SetThreadName(const std::string& name) {
+    ThreadState* state = ThreadState::Get();
+    std::lock_guard<std::mutex> lock(mutex_);
+    state->name = name;
+    if (state->buffer != nullptr) {
+      state->buffer->thread_name = name;
+    }
+  }
+
+  std::string ExportChromeTrace() {
+    std::lock_guard<std::mutex> lock(mutex_);
+#ifdef _WIN32
+    int pid = _getpid();
+#else
+    int pid = getpid();
+#endif
+    std::ostringstream os;
+    os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    int64_t num_dropped = 0;
+    char ts[64];
+    for (const std::shared_ptr<ThreadTraceBuffer>& buffer : buffers_) {
+      if (!buffer->thread_name.empty()) {
+        os << (first ? "\n" : ",\n")
+           << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid << ", \"tid\": "
+           << buffer->tid << ", \"args\": {\"name\": \"" << Escape(buffer->thread_name) << "\"}}";
+        first = false;
+      }
+      int64_t size = buffer->size.load(std::memory_order_acquire);
+      for (int64_t i = 0; i < size; ++i) {
+        const TraceEvent& event = buffer->events[i];
+        // The timestamps of the Chrome trace are in microseconds.
+        std::snprintf(ts, sizeof(ts), "\"ts\": %.3f, \"dur\": %.3f", event.begin_ns / 1e3,
+                      (event.end_ns - event.begin_ns) / 1e3);
+        os << (first ? "\n" : ",\n") << "{\"name\": \"" << Escape(event.name) << "\", \"cat\": \""
+           << event.category << "\", \"ph\": \"X\", " << ts << ", \"pid\": " << pid
+           << ", \"tid\": " << buffer->tid << "}";
+        first = false;
+      }
+      num_dropped += buffer->num_dropped.load(std::memory_order_relaxed);
+    }
+    os << "\n]}\n";
+    if (num_dropped != 0) {
+      LOG(WARNING) << num_dropped << " trace events were dropped because the buffers of their "
+                   << "threads were full. Please start tracing with larger buffers.";
+    }
+    return os.str();
+  }
+
+ private:
+  /*! \brief The tracing state of a thread. */
+  struct ThreadState {
+    /*! \brief The id of the thread in the trace. */
+    int tid = -1;
+    /*! \brief The generation of the session of the buffer. */
+    uint64_t generation = 0;
+    /*! \brief The name of the thread. */
+    std::string name;
+    /*! \brief The buffer of the current session, shared with the tracer. */
+    std::shared_ptr<ThreadTraceBuffer> buffer;
+
+    static ThreadState* Get() {
+      static thread_local ThreadState inst;
+      return &inst;
+    }
+  };
+
+  ThreadTraceBuffer* CurrentBuffer() {
+    ThreadState* state = ThreadState::Get();
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (state->buffer == nullptr || state->generation != generation) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (state->tid < 0) {
+        state->tid = next_tid_++;
+      }
+      state->generation = generation_.load(std::memory_order_relaxed);
+      state->buffer = std::make_shared<ThreadTraceBuffer>(events_per_thread_, state->tid);
+      state->buffer->thread_name = state->name;
+      buffers_.push_back(state->buffer);
+    }
+    return state->buffer.get();
+  }
+
+  static std::string Escape(const std::string& str) {
+    std::string result;
+    for (char c : str) {
+      if (c == '"' || c == '\\') {
+        result += '\\';
+        result += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        result += buf;
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint64_t> generation_{0};
+  /*! \brief Guards the fields below. */
+  std::mutex mutex_;
+  int64_t events_per_thread_ = 1 << 16;
+  int next_tid_ = 0;
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers_;
+};
+
+}  // namespace
+
+bool TracingEnabled() { return Tracer::Global()->enabled(); }
+
+void StartTracing(int64_t events_per_thread) { Tracer::Global()->Start(events_per_thread); }
+
+void StopTracing() { Tracer::Global()->Stop(); }
+
+std::string ExportChromeTrace() { return Tracer::Global()->ExportChromeTrace(); }
+
+void SetTraceThreadName(const std::string& name) { Tracer::Global()->SetThreadName(name); }
+
+int64_t TraceClockNs() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                              epoch)
+      .count();
+}
+
+void RecordTraceEvent(const char* category, const char* name, int64_t begin_ns, int64_t end_ns) {
+  Tracer::Global()->Record(category, name, begin_ns, end_ns);
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.StartTracing").set_body_typed(StartTracing);
+TVM_REGISTER_GLOBAL("runtime.profiling.StopTracing").set_body_typed(StopTracing);
+TVM_REGISTER_GLOBAL("runtime.profiling.TracingEnabled").set_body_typed(TracingEnabled);
+TVM_REGISTER_GLOBAL("runtime.profiling.ExportChromeTrace").set_body_typed(ExportChromeTrace);
+TVM_REGISTER_GLOBAL("runtime.profiling.SetTraceThreadName").set_body_typed(SetTraceThreadName);
+TVM_REGISTER_GLOBAL("runtime.profiling.RecordTraceEvent")
+    .set_body_typed([](String name, int64_t begin_ns, int64_t end_ns) {
+      RecordTraceEvent("user", name.c_str(), begin_ns, end_ns);
+    });
+TVM_REGISTER_GLOBAL("runtime.profiling.TraceClockNs").set_body_typed(TraceClockNs);
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,207 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file lz4.h
+ * \brief A fast LZ77 compressor that emits the LZ4 block format.
+ *
+ *  The compressor favors speed over ratio, so that it can be used to reduce
+ *  the bytes sent through slow links (e.g. RPC) without becoming the bottleneck.
+ */
+#ifndef TVM_SUPPORT_LZ4_H_
+#define TVM_SUPPORT_LZ4_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace tvm {
+namespace support {
+namespace lz4 {
+/*! \brief The minimum length of a match. */
+constexpr size_t kMinMatch = 4;
+/*! \brief The last bytes of a block are always encoded as literals. */
+constexpr size_t kLastLiterals = 5;
+/*! \brief The last match must start at least this number of bytes before the end. */
+constexpr size_t kMatchFindLimit = 12;
+/*! \brief The maximum distance of a match. */
+constexpr size_t kMaxDistance = 65535;
+/*! \brief The log2 size of the hash table of the compressor. */
+constexpr int kHashLog = 14;
+
+inline uint32_t Read32(const uint8_t* ptr) {
+  uint32_t value;
+  std::memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+inline uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - kHashLog); }
+
+inline uint8_t* WriteLength(uint8_t* op, size_t length) {
+  for (; length >= 255; length -= 255) {
+    *op++ = 255;
+  }
+  *op++ = static_cast<uint8_t>(length);
+  return op;
+}
+
+inline bool ReadLength(const uint8_t** ip, const uint8_t* iend, size_t* length) {
+  uint8_t byte;
+  do {
+    if (*ip >= iend) return false;
+    byte = *(*ip)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+}  // namespace lz4
+
+/*!
+ * \brief Get the maximum size of the compressed data.
+ * \param size The size of the input.
+ * \return The bound of the compressed size.
+ */
+inline size_t LZ4CompressBound(size_t size) { return size + size / 255 + 16; }
+
+/*!
+ * \brief Compress the data into the LZ4 block format.
+ * \param src The input data.
+ * \param src_size The size of the input data.
+ * \param dst The output buffer.
+ * \param dst_capacity The capacity of the output buffer.
+ * \return The size of the compressed data, or 0 when it does not fit into the output buffer.
+ */
+inline size_t LZ4Compress(const void* src, size_t src_size, void* dst, size_t dst_capacity) {
+  using namespace lz4;
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  const uint8_t* iend = in + src_size;
+  const uint8_t* anchor = in;
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  uint8_t* op = out;
+  uint8_t* oend = out + dst_capacity;
+
+  if (src_size > kMatchFindLimit) {
+    std::vector<uint32_t> table(1 << kHashLog, 0);
+    const uint8_t* match_find_limit = iend - kMatchFindLimit;
+    const uint8_t* match_end_limit = iend - kLastLiterals;
+    const uint8_t* ip = in;
+    // Skip faster over the incompressible data.
+    size_t num_misses = 0;
+    while (ip < match_find_limit) {
+      uint32_t sequence = Read32(ip);
+      uint32_t hash = Hash(sequence);
+      const uint8_t* ref = in + table[hash];
+      table[hash] = static_cast<uint32_t>(ip - in);
+      if (ref >= ip || static_cast<size_t>(ip - ref) > kMaxDistance || Read32(ref) != sequence) {
+        ip += 1 + (num_misses++ >> 6);
+        continue;
+      }
+      num_misses = 0;
+      const uint8_t* match_end = ip + kMinMatch;
+      const uint8_t* ref_end = ref + kMinMatch;
+      while (match_end < match_end_limit && *match_end == *ref_end) {
+        ++match_end;
+        ++ref_end;
+      }
+      while (ip > anchor && ref > in && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+      size_t literal_length = ip - anchor;
+      size_t match_length = match_end - ip - kMinMatch;
+      size_t max_bytes = 1 + literal_length / 255 + 1 + literal_length + 2 + match_length / 255 + 1;
+      if (static_cast<size_t>(oend - op) < max_bytes) return 0;
+      uint8_t* token = op++;
+      *token = static_cast<uint8_t>((std::min<size_t>(literal_length, 15) << 4) |
+                                    std::min<size_t>(match_length, 15));
+      if (literal_length >= 15) op = WriteLength(op, literal_length - 15);
+      std::memcpy(op, anchor, literal_length);
+      op += literal_length;
+      size_t offset = ip - ref;
+      *op++ = static_cast<uint8_t>(offset & 0xFF);
+      *op++ = static_cast<uint8_t>(offset >> 8);
+      if (match_length >= 15) op = WriteLength(op, match_length - 15);
+      ip = anchor = match_end;
+    }
+  }
+
+  size_t literal_length = iend - anchor;
+  if (static_cast<size_t>(oend - op) < 1 + literal_length / 255 + 1 + literal_length) return 0;
+  *op++ = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4);
+  if (literal_length >= 15) op = lz4::WriteLength(op, literal_length - 15);
+  if (literal_length != 0) std::memcpy(op, anchor, literal_length);
+  op += literal_length;
+  return op - out;
+}
+
+/*!
+ * \brief Decompress the data in the LZ4 block format.
+ * \param src The compressed data.
+ * \param src_size The size of the compressed data.
+ * \param dst The output buffer.
+ * \param dst_size The size of the decompressed data.
+ * \return Whether the compressed data is valid and decompresses to exactly dst_size bytes.
+ */
+inline bool LZ4Decompress(const void* src, size_t src_size, void* dst, size_t dst_size) {
+  using namespace lz4;
+  const uint8_t* ip = static_cast<const uint8_t*>(src);
+  const uint8_t* iend = ip + src_size;
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  uint8_t* op = out;
+  uint8_t* oend = out + dst_size;
+
+  while (ip < iend) {
+    uint8_t token = *ip++;
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !ReadLength(&ip, iend, &literal_length)) return false;
+    if (literal_length > static_cast<size_t>(iend - ip) ||
+        literal_length > static_cast<size_t>(oend - op)) {
+      return false;
+    }
+    std::memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+    // The last sequence only contains literals.
+    if (ip == iend) return op == oend;
+
+    if (iend - ip < 2) return false;
+    size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - out)) return false;
+    size_t match_length = token & 15;
+    if (match_length == 15 && !ReadLength(&ip, iend, &match_length)) return false;
+    match_length += kMinMatch;
+    if (match_length > static_cast<size_t>(oend - op)) return false;
+    // An overlapping match repeats the last `offset` bytes, where the
+    // copied period doubles in each step.
+    const uint8_t* match = op - offset;
+    while (match_length != 0) {
+      size_t num_bytes = std::min<size_t>(op - match, match_length);
+      std::memcpy(op, match, num_bytes);
+      op += num_bytes;
+      match_length -= num_bytes;
+    }
+  }
+  return false;
+}
+
+}  // namespace support
+}  // namespace tvm
+#endif  // TVM_SUPPORT_LZ4_H_
@@ -24,7 +24,13 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
-#include <future>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -32,6 +38,141 @@
 namespace tvm {
 namespace support {
 
+namespace {
+
+/*!
+ * \brief The state of one parallel loop, shared by the calling thread and the pool threads that
+ *  help to run it. The tasks are fetched from an atomic counter, so the calling thread finishes
+ *  the loop on its own if no pool thread is available.
+ */
+class ParallelLoop {
+ public:
+  ParallelLoop(int begin, int end, const std::function<void(int, int)>& f)
+      : counter_(begin), end_(end), f_(f) {}
+
+  /*! \brief Run tasks until there are none left, or the loop is cancelled by an error. */
+  void Run(int thread_id) {
+    try {
+      for (int task_id; !cancelled_ && (task_id = counter_++) < end_;) {
+        f_(thread_id, task_id);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      cancelled_ = true;
+    }
+  }
+
+  /*! \brief Run tasks on a pool thread, unless the calling thread has already finished. */
+  void Help(int thread_id) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) return;
+      ++num_helpers_;
+    }
+    Run(thread_id);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --num_helpers_;
+    }
+    cv_.notify_all();
+  }
+
+  /*! \brief Wait for the running helpers and rethrow the first error of any task. */
+  void Join() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      closed_ = true;
+      cv_.wait(lock, [this] { return num_helpers_ == 0; });
+    }
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+ private:
+  std::atomic<int> counter_;
+  const int end_;
+  const std::function<void(int, int)>& f_;
+  std::atomic<bool> cancelled_{false};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /*! \brief Whether the calling thread has finished, after which helpers no longer join. */
+  bool closed_{false};
+  int num_helpers_{0};
+  std::exception_ptr error_;
+};
+
+/*!
+ * \brief The threads that help to run parallel loops. They are created on demand and persist
+ *  across loops, to avoid the cost of creating threads for each loop.
+ */
+class ParallelLoopPool {
+ public:
+  static ParallelLoopPool* Global() {
+    // Intentionally leaked, so that the threads are never joined during static destruction.
+    static ParallelLoopPool* pool = new ParallelLoopPool();
+    return pool;
+  }
+
+  /*! \brief Request `num_helpers` pool threads to help running the loop. */
+  void Submit(const std::shared_ptr<ParallelLoop>& loop, int num_helpers) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int thread_id = 1; thread_id <= num_helpers; ++thread_id) {
+        queue_.emplace_back(loop, thread_id);
+      }
+      while (static_cast<int>(threads_.size()) < num_helpers) {
+        threads_.emplace_back([this] { this->WorkerLoop(); });
+        threads_.back().detach();
+      }
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  void WorkerLoop() {
+    for (;;) {
+      std::pair<std::shared_ptr<ParallelLoop>, int> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !queue_.empty(); });
+        job = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      job.first->Help(job.second);
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /*! \brief The pending requests for help, each with the thread index to run as. */
+  std::deque<std::pair<std::shared_ptr<ParallelLoop>, int>> queue_;
+  std::vector<std::thread> threads_;
+};
+
+/*!
+ * \brief Run f(thread_id, task_id) for each task in [begin, end) on `num_threads` threads, where
+ *  the calling thread is thread 0. Rethrows the first error of any task.
+ */
+void RunParallelLoop(int begin, int end, int num_threads,
+                     const std::function<void(int, int)>& f) {
+  auto loop = std::make_shared<ParallelLoop>(begin, end, f);
+  int num_helpers = std::min(num_threads, end - begin) - 1;
+  if (num_helpers > 0) {
+    ParallelLoopPool::Global()->Submit(loop, num_helpers);
+  }
+  loop->Run(0);
+  loop->Join();
+}
+
+/*! \brief Whether the current thread is running a task of parallel_for. */
+thread_local bool in_parallel_for = false;
+
+}  // namespace
+
 std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int num_threads) {
   int total_task_count = (end - begin) / step;
   ICHECK_GE(total_task_count, 0) << "Infinite loop condition with begin: " << begin
@@ -49,45 +190,24 @@ std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int n
 
 void parallel_for(int begin, int end, const std::function<void(int)>& f, int step,
                   const PartitionerFuncType partitioner) {
-  static bool GLOBAL_PARALLEL_FOR_FLAG{false};
-  static std::mutex M_GLOBAL_PARALLEL_FOR_FLAG;
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(!GLOBAL_PARALLEL_FOR_FLAG) << "There's another parallel_for running. Maybe you're "
-                                      << "currently inside another parallel_for loop.";
-    GLOBAL_PARALLEL_FOR_FLAG = true;
-  }
-
+  ICHECK(!in_parallel_for) << "There's another parallel_for running. Maybe you're "
+                           << "currently inside another parallel_for loop.";
   int default_num_threads = std::thread::hardware_concurrency();
   const auto& run_partitions = partitioner(begin, end, step, default_num_threads);
-
-  std::vector<std::thread> threads;
-  threads.reserve(run_partitions.size());
-  std::vector<std::future<void>> res_vec;
-  res_vec.reserve(run_partitions.size());
-  for (const auto& run_partition : run_partitions) {
-    std::packaged_task<void(const std::vector<int>&, const std::function<void(int)>&)> task(
-        [](const std::vector<int>& run_partition, const std::function<void(int)>& f) {
-          for (const auto& i : run_partition) {
-            f(i);
-          }
-        });
-    res_vec.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), run_partition, f);
-  }
-
-  for (auto&& thread : threads) {
-    thread.join();
-  }
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(GLOBAL_PARALLEL_FOR_FLAG);
-    GLOBAL_PARALLEL_FOR_FLAG = false;
-  }
+  int num_partitions = run_partitions.size();
   try {
-    for (auto&& i : res_vec) {
-      i.get();
-    }
+    RunParallelLoop(0, num_partitions, num_partitions, [&](int thread_id, int partition_id) {
+      in_parallel_for = true;
+      try {
+        for (const auto& i : run_partitions[partition_id]) {
+          f(i);
+        }
+      } catch (...) {
+        in_parallel_for = false;
+        throw;
+      }
+      in_parallel_for = false;
+    });
   } catch (const std::exception& e) {
     LOG(FATAL) << "Parallel_for error with " << e.what();
   }
@@ -101,40 +221,10 @@ void parallel_for_dynamic(int begin, int end, int num_threads,
   }
   CHECK_LE(begin, end) << "ValueError: The interval [begin, end) requires `begin <= end`";
   CHECK_GT(num_threads, 0) << "ValueError: `num_threads` should be positive";
-  // Step 2. Launch threads
-  // Step 2.1. Launch worker 1 to worker `num_threads - 1`
-  std::atomic<int> counter{begin};
-  std::vector<std::future<void>> futures;
-  std::vector<std::thread> threads;
-  futures.reserve(num_threads - 1);
-  threads.reserve(num_threads - 1);
-  auto worker = [end, &counter, &f](int thread_id) -> void {
-    for (int task_id; (task_id = counter++) < end;) {
-      f(thread_id, task_id);
-    }
-  };
-  for (int thread_id = 1; thread_id < num_threads; ++thread_id) {
-    std::packaged_task<void(int)> task(worker);
-    futures.emplace_back(task.get_future());
-    threads.emplace_back(std::move(task), thread_id);
-  }
-  // Step 2.2. Launch worker 0 inplace
-  try {
-    worker(0);
-  } catch (const std::exception& e) {
-    for (auto&& thread : threads) {
-      thread.join();
-    }
-    LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
-  }
-  // Step 3. Join threads and check exceptions
-  for (auto&& thread : threads) {
-    thread.join();
-  }
+  // Step 2. Run the loop on the calling thread and `num_threads - 1` pool threads, and check
+  // exceptions
   try {
-    for (auto&& future : futures) {
-      future.get();
-    }
+    RunParallelLoop(begin, end, num_threads, f);
   } catch (const std::exception& e) {
     LOG(FATAL) << "RuntimeError: parallel_for_dynamic error with " << e.what();
   }
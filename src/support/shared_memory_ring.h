@@ -0,0 +1,252 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file shared_memory_ring.h
+ * \brief Single-producer single-consumer byte ring in shared memory, used for IPC.
+ */
+#ifndef TVM_SUPPORT_SHARED_MEMORY_RING_H_
+#define TVM_SUPPORT_SHARED_MEMORY_RING_H_
+
+#if defined(__linux__) || defined(__ANDROID__)
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+namespace tvm {
+namespace support {
+
+/*!
+ * \brief The control block of a ring in shared memory.
+ *  A zero-filled control block is an empty ring.
+ */
+struct SharedMemoryRingHeader {
+  /*! \brief The total number of bytes consumed, only advanced by the consumer. */
+  alignas(64) std::atomic<uint64_t> head;
+  /*! \brief Bumped after each consumption, the futex the producer sleeps on. */
+  std::atomic<uint32_t> head_seq;
+  /*! \brief The number of producers sleeping on head_seq. */
+  std::atomic<uint32_t> num_producers_waiting;
+  /*! \brief The total number of bytes produced, only advanced by the producer. */
+  alignas(64) std::atomic<uint64_t> tail;
+  /*! \brief Bumped after each production, the futex the consumer sleeps on. */
+  std::atomic<uint32_t> tail_seq;
+  /*! \brief The number of consumers sleeping on tail_seq. */
+  std::atomic<uint32_t> num_consumers_waiting;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "The shared memory ring requires lock-free atomics");
+
+/*!
+ * \brief A single-producer single-consumer byte ring whose control block and data
+ *  live in memory shared by two processes.
+ *
+ *  The peers never make a syscall while the ring is neither empty nor full. When it
+ *  is, a peer spins for a while and then sleeps on a futex. The sleep times out
+ *  periodically so that a peer that is gone can be detected by the fpeer_alive
+ *  callback passed to the blocking functions.
+ */
+class SharedMemoryRing {
+ public:
+  /*! \brief The number of polls before sleeping on an empty or full ring. */
+  static constexpr int kSpinCount = 4096;
+  /*! \brief The timeout of each sleep in nanoseconds. */
+  static constexpr int64_t kWaitTimeoutNs = 100 * 1000 * 1000;
+
+  SharedMemoryRing() = default;
+  /*!
+   * \brief Attach to a ring.
+   * \param header The control block.
+   * \param data The data of the ring.
+   * \param capacity The capacity of the ring in bytes.
+   */
+  SharedMemoryRing(SharedMemoryRingHeader* header, char* data, uint64_t capacity)
+      : header_(header), data_(data), capacity_(capacity) {}
+
+  /*! \return The capacity of the ring in bytes. */
+  uint64_t capacity() const { return capacity_; }
+
+  /*!
+   * \brief Write a prefix of the data, blocking until there is space.
+   * \param data The data to write.
+   * \param size The size of the data.
+   * \param fpeer_alive Returns whether the consumer may still read the ring.
+   * \return The number of bytes written, 0 if the consumer is gone.
+   */
+  template <typename FPeerAlive>
+  size_t Write(const void* data, size_t size, FPeerAlive fpeer_alive) {
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    uint64_t free_bytes = 0;
+    Wait(&header_->head_seq, &header_->num_producers_waiting, fpeer_alive, [&]() {
+      free_bytes = capacity_ - (tail - header_->head.load(std::memory_order_acquire));
+      return free_bytes != 0;
+    });
+    size_t nbytes = std::min<uint64_t>(size, free_bytes);
+    const char* src = static_cast<const char*>(data);
+    size_t offset = tail % capacity_;
+    size_t first = std::min<uint64_t>(nbytes, capacity_ - offset);
+    std::memcpy(data_ + offset, src, first);
+    std::memcpy(data_, src + first, nbytes - first);
+    header_->tail.store(tail + nbytes, std::memory_order_release);
+    Notify(&header_->tail_seq, &header_->num_consumers_waiting);
+    return nbytes;
+  }
+
+  /*!
+   * \brief Read a prefix of the data, blocking until there is data.
+   * \param data The buffer to read into.
+   * \param size The size of the buffer.
+   * \param fpeer_alive Returns whether the producer may still write the ring.
+   * \return The number of bytes read, 0 if the producer is gone.
+   */
+  template <typename FPeerAlive>
+  size_t Read(void* data, size_t size, FPeerAlive fpeer_alive) {
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    uint64_t used_bytes = 0;
+    Wait(&header_->tail_seq, &header_->num_consumers_waiting, fpeer_alive, [&]() {
+      used_bytes = header_->tail.load(std::memory_order_acquire) - head;
+      return used_bytes != 0;
+    });
+    size_t nbytes = std::min<uint64_t>(size, used_bytes);
+    char* dst = static_cast<char*>(data);
+    size_t offset = head % capacity_;
+    size_t first = std::min<uint64_t>(nbytes, capacity_ - offset);
+    std::memcpy(dst, data_ + offset, first);
+    std::memcpy(dst + first, data_, nbytes - first);
+    Release(head + nbytes);
+    return nbytes;
+  }
+
+  /*!
+   * \brief Reserve a contiguous region for the producer to fill in place, if there is
+   *  space for it now. The region is handed to the consumer out of band, and the consumer
+   *  releases the data up to the end of a region once it is done with all the regions
+   *  reserved before.
+   * \param size The size of the region, which must not exceed the capacity.
+   * \param pos The position of the region, as the total number of bytes before it.
+   * \return Whether the region is reserved, false if the ring does not have enough space.
+   */
+  bool TryReserve(uint64_t size, uint64_t* pos) {
+    uint64_t end = header_->tail.load(std::memory_order_relaxed);
+    uint64_t tail = end;
+    // Skip the end of the ring if the region does not fit there.
+    if (tail % capacity_ + size > capacity_) {
+      tail += capacity_ - tail % capacity_;
+    }
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    // The skipped bytes are never released, so an empty ring is always enough.
+    if (head != end && tail + size > head + capacity_) return false;
+    header_->tail.store(tail + size, std::memory_order_relaxed);
+    *pos = tail;
+    return true;
+  }
+
+  /*! \return The address of the data at a position. */
+  char* At(uint64_t pos) const { return data_ + pos % capacity_; }
+
+  /*!
+   * \brief Release the data before a position to the producer.
+   * \param pos The new head of the ring.
+   */
+  void Release(uint64_t pos) {
+    header_->head.store(pos, std::memory_order_release);
+    Notify(&header_->head_seq, &header_->num_producers_waiting);
+  }
+
+  /*! \brief Wake up all the peers sleeping on the ring, e.g. when the channel is closed. */
+  void WakeAll() {
+    FutexWake(&header_->head_seq);
+    FutexWake(&header_->tail_seq);
+  }
+
+ private:
+  /*!
+   * \brief Wait until fready returns true, or the peer is gone.
+   * \param seq The futex to sleep on, which is bumped by the peer when the ring changes.
+   * \param num_waiting The counter of sleepers on the futex.
+   * \param fpeer_alive Returns whether the peer may still change the ring.
+   * \param fready The condition to wait for.
+   */
+  template <typename FPeerAlive, typename FReady>
+  static void Wait(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* num_waiting,
+                   FPeerAlive fpeer_alive, FReady fready) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (fready()) return;
+    }
+    while (true) {
+      // The sequential consistency of the counter and the futex word makes sure that
+      // either the peer sees a sleeper, or we see the change made by the peer.
+      num_waiting->fetch_add(1);
+      uint32_t expected = seq->load();
+      if (fready()) {
+        num_waiting->fetch_sub(1);
+        return;
+      }
+      if (!fpeer_alive()) {
+        num_waiting->fetch_sub(1);
+        // Pick up the last change made by the peer before it was gone.
+        fready();
+        return;
+      }
+      struct timespec timeout;
+      timeout.tv_sec = kWaitTimeoutNs / 1000000000;
+      timeout.tv_nsec = kWaitTimeoutNs % 1000000000;
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAIT, expected, &timeout,
+              nullptr, 0);
+      num_waiting->fetch_sub(1);
+    }
+  }
+
+  /*!
+   * \brief Wake up the peer sleeping on seq after the ring changes.
+   * \param seq The futex the peer sleeps on.
+   * \param num_waiting The counter of sleepers on the futex.
+   */
+  static void Notify(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* num_waiting) {
+    seq->fetch_add(1);
+    if (num_waiting->load() != 0) {
+      FutexWake(seq);
+    }
+  }
+
+  static void FutexWake(std::atomic<uint32_t>* seq) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+            0);
+  }
+
+  SharedMemoryRingHeader* header_{nullptr};
+  char* data_{nullptr};
+  uint64_t capacity_{0};
+};
+
+}  // namespace support
+}  // namespace tvm
+
+#endif  // defined(__linux__) || defined(__ANDROID__)
+#endif  // TVM_SUPPORT_SHARED_MEMORY_RING_H_
@@ -26,13 +26,16 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/target/codegen.h>
 #include <tvm/target/target.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <fstream>
 #include <sstream>
 #include <unordered_set>
 #include <vector>
@@ -305,18 +308,62 @@ runtime::Module DeserializeModuleFromBytes(std::string blob) {
 }
 
 std::string PackImportsToBytes(const runtime::Module& mod) {
-  std::string bin = SerializeModuleToBytes(mod);
+  // Serialize after a placeholder of the size header, which saves a copy of the whole blob.
+  std::string blob(sizeof(uint64_t), '\0');
+  dmlc::MemoryStringStream ms(&blob);
+  ms.Seek(blob.length());
+  ModuleSerializer module_serializer(mod);
+  module_serializer.SerializeModuleToBytes(&ms, /*export_dso=*/true);
 
-  uint64_t nbytes = bin.length();
-  std::string header;
+  uint64_t nbytes = blob.length() - sizeof(nbytes);
   for (size_t i = 0; i < sizeof(nbytes); ++i) {
-    header.push_back(((nbytes >> (i * 8)) & 0xffUL));
+    blob[i] = static_cast<char>((nbytes >> (i * 8)) & 0xffUL);
   }
-  return header + bin;
+  return blob;
 }
 
-std::string PackImportsToC(const runtime::Module& mod, bool system_lib,
-                           const std::string& c_symbol_prefix) {
+/*!
+ * \brief Write the blob as the initializer of a C array, 20 bytes (100 columns) per line.
+ *  The text is formatted in parallel, a batch of chunks at a time, and written in order,
+ *  so that only a bounded part of it is in memory.
+ */
+void WriteBlobToC(const std::string& blob, std::ostream& os) {
+  constexpr size_t kBytesPerLine = 100 / 5;  // 100 columns, 5 chars per "0xab,"
+  constexpr size_t kBytesPerChunk = kBytesPerLine * 16384;
+  constexpr size_t kChunksPerBatch = 16;
+  static const char* kHexDigits = "0123456789abcdef";
+  size_t num_chunks = (blob.length() + kBytesPerChunk - 1) / kBytesPerChunk;
+  std::vector<std::string> texts(std::min(num_chunks, kChunksPerBatch));
+  for (size_t batch_begin = 0; batch_begin < num_chunks; batch_begin += kChunksPerBatch) {
+    size_t batch_size = std::min(kChunksPerBatch, num_chunks - batch_begin);
+    support::parallel_for(0, static_cast<int>(batch_size), [&](int index) {
+      size_t begin = (batch_begin + index) * kBytesPerChunk;
+      size_t end = std::min(begin + kBytesPerChunk, blob.length());
+      std::string& text = texts[index];
+      text.resize((end - begin) * 5 + (end - begin + kBytesPerLine - 1) / kBytesPerLine * 3);
+      char* out = &text[0];
+      for (size_t i = begin; i < end; ++i) {
+        if (i % kBytesPerLine == 0) {
+          *out++ = '\n';
+          *out++ = ' ';
+          *out++ = ' ';
+        }
+        unsigned char c = static_cast<unsigned char>(blob[i]);
+        *out++ = '0';
+        *out++ = 'x';
+        *out++ = kHexDigits[c >> 4];
+        *out++ = kHexDigits[c & 0xf];
+        *out++ = ',';
+      }
+    });
+    for (size_t i = 0; i < batch_size; ++i) {
+      os.write(texts[i].data(), texts[i].length());
+    }
+  }
+}
+
+void PackImportsToC(const runtime::Module& mod, bool system_lib,
+                    const std::string& c_symbol_prefix, std::ostream& os) {
   if (c_symbol_prefix.length() != 0) {
     CHECK(system_lib)
         << "c_symbol_prefix advanced option should be used in conjuction with system-lib";
@@ -326,7 +373,6 @@ std::string PackImportsToC(const runtime::Module& mod, bool system_lib,
   std::string blob = PackImportsToBytes(mod);
 
   // translate to C program
-  std::ostringstream os;
   os << "#ifdef _WIN32\n"
      << "#define TVM_EXPORT __declspec(dllexport)\n"
      << "#else\n"
@@ -337,15 +383,7 @@ std::string PackImportsToC(const runtime::Module& mod, bool system_lib,
      << "#endif\n";
   os << "TVM_EXPORT extern const unsigned char " << mdev_blob_name << "[];\n";
   os << "const unsigned char " << mdev_blob_name << "[" << blob.length() << "] = {";
-  os << std::hex;
-  size_t nunit = 100 / 5;  // 100 columns, 5 chars per "0xab,"
-  for (size_t i = 0; i < blob.length(); ++i) {
-    if (i % nunit == 0) {
-      os << "\n  ";
-    }
-    int c = blob[i];
-    os << "0x" << std::setw(2) << std::setfill('0') << (c & 0xff) << ',';
-  }
+  WriteBlobToC(blob, os);
   os << "\n};\n";
   if (system_lib) {
     os << "extern int TVMBackendRegisterSystemLibSymbol(const char*, void*);\n";
@@ -356,9 +394,24 @@ std::string PackImportsToC(const runtime::Module& mod, bool system_lib,
   os << "#ifdef __cplusplus\n"
      << "}\n"
      << "#endif\n";
+}
+
+std::string PackImportsToC(const runtime::Module& mod, bool system_lib,
+                           const std::string& c_symbol_prefix) {
+  std::ostringstream os;
+  PackImportsToC(mod, system_lib, c_symbol_prefix, os);
   return os.str();
 }
 
+void PackImportsToCFile(const runtime::Module& mod, bool system_lib, const std::string& file_name,
+                        const std::string& c_symbol_prefix) {
+  std::ofstream os(file_name, std::ios::binary);
+  CHECK(os) << "Cannot open " << file_name;
+  PackImportsToC(mod, system_lib, c_symbol_prefix, os);
+  os.close();
+  CHECK(os) << "Failed to write " << file_name;
+}
+
 runtime::Module PackImportsToLLVM(const runtime::Module& mod, bool system_lib,
                                   const std::string& llvm_target_string,
                                   const std::string& c_symbol_prefix) {
@@ -403,7 +456,12 @@ TVM_REGISTER_GLOBAL("runtime.ModulePackImportsToNDArray")
       return array;
     });
 
-TVM_REGISTER_GLOBAL("runtime.ModulePackImportsToC").set_body_typed(PackImportsToC);
+TVM_REGISTER_GLOBAL("runtime.ModulePackImportsToC")
+    .set_body_typed([](const runtime::Module& mod, bool system_lib,
+                       const std::string& c_symbol_prefix) {
+      return PackImportsToC(mod, system_lib, c_symbol_prefix);
+    });
+TVM_REGISTER_GLOBAL("runtime.ModulePackImportsToCFile").set_body_typed(PackImportsToCFile);
 TVM_REGISTER_GLOBAL("runtime.ModulePackImportsToLLVM").set_body_typed(PackImportsToLLVM);
 
 }  // namespace codegen
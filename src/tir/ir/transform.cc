@@ -29,6 +29,8 @@ namespace tvm {
 namespace tir {
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.prim_func_pass_threads", Integer);
+
 /*!
  * \brief Function level pass that applies transformations to all
  *        TIR functions within the module.
@@ -58,6 +60,19 @@ class PrimFuncPassNode : public PassNode {
    */
   PassInfo Info() const override { return pass_info; }
 
+  /*!
+   * \brief Run the function pass on several threads, see "tir.prim_func_pass_threads".
+   *
+   * \param mod The module that an optimization pass is applied on.
+   * \param pass_ctx The context that an optimization pass executes on.
+   * \param memo The memoization of the pass results.
+   * \param num_threads The number of threads, or 0 to use all the cores.
+   *
+   * \return Return the updated module.
+   */
+  IRModule RunParallel(IRModule mod, const PassContext& pass_ctx,
+                       const tvm::transform::FunctionPassMemo& memo, int num_threads) const;
+
   static constexpr const char* _type_key = "tir.PrimFuncPass";
   TVM_DECLARE_FINAL_OBJECT_INFO(PrimFuncPassNode, PassNode);
 };
@@ -88,6 +103,13 @@ PrimFuncPass::PrimFuncPass(
 // Perform Module -> Module optimizations at the PrimFunc level.
 IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx) const {
   ICHECK(mod.defined());
+  tvm::transform::FunctionPassMemo memo(Info(), mod, pass_ctx);
+  int num_threads = pass_ctx->GetConfig<Integer>("tir.prim_func_pass_threads", Integer(1))
+                        .value()
+                        ->value;
+  if (num_threads != 1) {
+    return RunParallel(std::move(mod), pass_ctx, memo, num_threads);
+  }
   std::vector<GlobalVar> deleted_list;
 
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
@@ -98,7 +120,9 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
     if (kv.second->IsInstance<PrimFuncNode>()) {
       // move out the function so that it is the only copy.
       PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
-      func = pass_func(std::move(func), mod, pass_ctx);
+      func = memo.Apply(std::move(func), [&](PrimFunc f) {
+        return pass_func(std::move(f), mod, pass_ctx);
+      });
       kv.second = std::move(func);
 
       if (!kv.second.defined()) {
@@ -116,10 +140,45 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   return mod;
 }
 
+// Unlike the sequential loop above, which moves each function out of the module while it is
+// transformed, the module stays untouched until all the functions are transformed. So each
+// function sees the same module whatever the order the threads run in, and the module is
+// only updated from the calling thread.
+IRModule PrimFuncPassNode::RunParallel(IRModule mod, const PassContext& pass_ctx,
+                                       const tvm::transform::FunctionPassMemo& memo,
+                                       int num_threads) const {
+  std::vector<GlobalVar> gvars;
+  std::vector<PrimFunc> funcs;
+  for (const auto& [gvar, base_func] : mod->functions) {
+    if (auto func = base_func.as<PrimFunc>()) {
+      gvars.push_back(gvar);
+      funcs.push_back(func.value());
+    }
+  }
+
+  tvm::transform::ParallelForFunctions(
+      pass_ctx, static_cast<int>(funcs.size()), num_threads, [&](int i) {
+        funcs[i] = memo.Apply(std::move(funcs[i]), [&](PrimFunc f) {
+          return pass_func(std::move(f), mod, pass_ctx);
+        });
+      });
+
+  IRModuleNode* mod_ptr = mod.CopyOnWrite();
+  for (size_t i = 0; i < gvars.size(); ++i) {
+    if (funcs[i].defined()) {
+      mod_ptr->functions.Set(gvars[i], funcs[i]);
+    } else {
+      mod_ptr->Remove(gvars[i]);
+    }
+  }
+  return mod;
+}
+
 Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required, bool traceable) {
-  PassInfo pass_info = PassInfo(opt_level, name, required, traceable);
+    int opt_level, String name, tvm::Array<String> required, bool traceable,
+    Optional<Array<ObjectRef>> memo_key) {
+  PassInfo pass_info = PassInfo(opt_level, name, required, traceable, std::move(memo_key));
   return PrimFuncPass(pass_func, pass_info);
 }
 
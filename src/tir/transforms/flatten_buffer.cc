@@ -283,7 +283,8 @@ Pass FlattenBuffer() {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     return FlattenBuffer(std::move(f));
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.FlattenBuffer", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.FlattenBuffer", {}, /* traceable */ false,
+                            /* memo_key */ Array<ObjectRef>{});
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.FlattenBuffer").set_body_typed(FlattenBuffer);
@@ -840,7 +840,8 @@ Pass LoopPartition() {
                             cfg.value()->unroll_loop_with_partition_hint_no_interval);
     return f;
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.LoopPartition", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.LoopPartition", {}, /* traceable */ false,
+                            /* memo_key */ Array<ObjectRef>{});
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.LoopPartition").set_body_typed(LoopPartition);
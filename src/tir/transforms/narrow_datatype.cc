@@ -317,7 +317,8 @@ Pass NarrowDataType(int target_bits) {
     n->body = NarrowDataTypeRewriter(target_bits)(std::move(n->body));
     return f;
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.NarrowDataType", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.NarrowDataType", {}, /* traceable */ false,
+                            /* memo_key */ Array<ObjectRef>{Integer(target_bits)});
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.NarrowDataType").set_body_typed(NarrowDataType);
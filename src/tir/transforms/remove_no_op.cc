@@ -332,7 +332,8 @@ Pass RemoveNoOp() {
     }
     return f;
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.RemoveNoOp", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.RemoveNoOp", {}, /* traceable */ false,
+                            /* memo_key */ Array<ObjectRef>{});
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.RemoveNoOp").set_body_typed(RemoveNoOp);
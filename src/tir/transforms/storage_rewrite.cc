@@ -1810,7 +1810,8 @@ Pass StorageRewrite() {
     return PointerValueTypeRewrite(std::move(f), true, false, false, true, true, true, false,
                                    false);
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.StorageRewrite", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.StorageRewrite", {}, /* traceable */ false,
+                            /* memo_key */ Array<ObjectRef>{});
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.StorageRewrite").set_body_typed(StorageRewrite);
@@ -1819,7 +1820,8 @@ Pass PointerValueTypeRewrite() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
     return PointerValueTypeRewrite(std::move(f));
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.PointerValueTypeRewrite", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.PointerValueTypeRewrite", {}, /* traceable */ false,
+                            /* memo_key */ Array<ObjectRef>{});
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.PointerValueTypeRewrite")
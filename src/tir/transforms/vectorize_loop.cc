@@ -1012,7 +1012,8 @@ Pass VectorizeLoop(bool enable_vectorize) {
     }
     return f;
   };
-  return CreatePrimFuncPass(pass_func, 0, "tir.VectorizeLoop", {});
+  return CreatePrimFuncPass(pass_func, 0, "tir.VectorizeLoop", {}, /* traceable */ false,
+                            /* memo_key */ Array<ObjectRef>{Bool(enable_vectorize)});
 }
 
 TVM_REGISTER_GLOBAL("tir.transform.VectorizeLoop").set_body_typed(VectorizeLoop);
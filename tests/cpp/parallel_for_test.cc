@@ -22,6 +22,7 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
+#include <atomic>
 #include <thread>
 #include <vector>
 
@@ -158,3 +159,30 @@ TEST(ParallelForDynamic, ExceptionOnArbitrary) {
   }
   ICHECK(exception);
 }
+
+TEST(ParallelForDynamic, Nested) {
+  using tvm::support::parallel_for_dynamic;
+  std::atomic<int> count{0};
+  parallel_for_dynamic(0, 16, 4, [&count](int thread_id, int i) {
+    parallel_for_dynamic(0, 16, 4, [&count](int thread_id, int j) { ++count; });
+  });
+  ICHECK_EQ(count.load(), 256);
+}
+
+TEST(ParallelMap, Basic) {
+  using tvm::support::parallel_map;
+  std::vector<int> squares =
+      parallel_map<int>(10, 1010, 4, [](int thread_id, int i) { return i * i; });
+  ICHECK_EQ(squares.size(), 1000);
+  for (int i = 0; i < 1000; i++) {
+    ICHECK_EQ(squares[i], (i + 10) * (i + 10));
+  }
+}
+
+TEST(ParallelReduce, Basic) {
+  using tvm::support::parallel_reduce;
+  int64_t sum = parallel_reduce<int64_t>(
+      0, 1001, 4, 0, [](int i) { return i; },
+      [](const int64_t& a, const int64_t& b) { return a + b; });
+  ICHECK_EQ(sum, 500500);
+}
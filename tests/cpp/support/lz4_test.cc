@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../../src/support/lz4.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace tvm {
+namespace support {
+namespace {
+
+void CheckRoundTrip(const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> compressed(LZ4CompressBound(data.size()));
+  size_t compressed_size =
+      LZ4Compress(data.data(), data.size(), compressed.data(), compressed.size());
+  ASSERT_GT(compressed_size, 0U);
+  std::vector<uint8_t> output(data.size() + 1);
+  ASSERT_TRUE(LZ4Decompress(compressed.data(), compressed_size, output.data(), data.size()));
+  output.pop_back();
+  ASSERT_EQ(output, data);
+  // The size of the decompressed data must match exactly.
+  if (!data.empty()) {
+    ASSERT_FALSE(LZ4Decompress(compressed.data(), compressed_size, output.data(), data.size() - 1));
+  }
+}
+
+TEST(LZ4, RoundTrip) {
+  std::mt19937 rng(0);
+  for (size_t size : {0, 1, 12, 13, 100, 4096, 65537, 300000}) {
+    std::vector<uint8_t> random_data(size), zeros(size), periodic(size), sparse(size);
+    for (size_t i = 0; i < size; ++i) {
+      random_data[i] = static_cast<uint8_t>(rng());
+      periodic[i] = static_cast<uint8_t>(i % 7);
+      sparse[i] = rng() % 4 == 0 ? static_cast<uint8_t>(rng()) : 0;
+    }
+    CheckRoundTrip(random_data);
+    CheckRoundTrip(zeros);
+    CheckRoundTrip(periodic);
+    CheckRoundTrip(sparse);
+  }
+}
+
+TEST(LZ4, CompressRatio) {
+  std::vector<uint8_t> zeros(1 << 20);
+  std::vector<uint8_t> compressed(LZ4CompressBound(zeros.size()));
+  size_t compressed_size =
+      LZ4Compress(zeros.data(), zeros.size(), compressed.data(), compressed.size());
+  ASSERT_GT(compressed_size, 0U);
+  ASSERT_LT(compressed_size, zeros.size() / 100);
+  // Report the failure when the output buffer is too small.
+  ASSERT_EQ(LZ4Compress(zeros.data(), zeros.size(), compressed.data(), 16), 0U);
+}
+
+TEST(LZ4, InvalidInput) {
+  std::vector<uint8_t> output(64);
+  // The match offset points before the start of the output.
+  std::vector<uint8_t> bad_offset = {0x10, 'a', 0x10, 0x00, 0x00};
+  ASSERT_FALSE(LZ4Decompress(bad_offset.data(), bad_offset.size(), output.data(), 20));
+  // The literals run past the end of the input.
+  std::vector<uint8_t> truncated = {0x50, 'a', 'b'};
+  ASSERT_FALSE(LZ4Decompress(truncated.data(), truncated.size(), output.data(), 5));
+}
+
+}  // namespace
+}  // namespace support
+}  // namespace tvm
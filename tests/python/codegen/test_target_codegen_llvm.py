@@ -151,6 +151,39 @@ def test_llvm_persist_parallel():
     check_llvm()
 
 
+@tvm.testing.requires_llvm
+def test_llvm_nested_parallel_launch():
+    """A parallel job launched from a task of another parallel job runs inline"""
+    n = 64
+    num_tasks = 4
+
+    @T.prim_func
+    def inner(A: T.Buffer(n, "float32"), B: T.Buffer(n, "float32")):
+        T.func_attr({"global_symbol": "inner"})
+        for i in T.parallel(n):
+            B[i] = A[i] + T.float32(1)
+
+    @T.prim_func
+    def outer():
+        T.func_attr({"global_symbol": "outer"})
+        for i in T.parallel(num_tasks):
+            T.evaluate(T.call_packed("testing.nested_parallel_launch", i))
+
+    finner = tvm.build(inner, target="llvm")
+    fouter = tvm.build(outer, target="llvm")
+    dev = tvm.cpu(0)
+    a = [tvm.nd.array(np.full(n, i, "float32"), dev) for i in range(num_tasks)]
+    b = [tvm.nd.empty((n,), "float32", dev) for _ in range(num_tasks)]
+
+    def run_inner(task_id):
+        finner(a[task_id], b[task_id])
+
+    tvm.register_func("testing.nested_parallel_launch", run_inner, override=True)
+    fouter()
+    for i in range(num_tasks):
+        tvm.testing.assert_allclose(b[i].numpy(), np.full(n, i + 1, "float32"))
+
+
 @tvm.testing.requires_llvm
 def test_llvm_flip_pipeline():
     def check_llvm(nn, base):
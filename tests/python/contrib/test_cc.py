@@ -0,0 +1,60 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test contrib.cc"""
+import tvm
+import tvm.testing
+from tvm.contrib.cc import _get_compile_options
+
+
+def test_get_compile_options():
+    # The link-only options are dropped from the per-source "-c" compiles.
+    options = [
+        "-O2",
+        "-I/opt/include",
+        "-DNDEBUG",
+        "-lfoo",
+        "-l",
+        "bar",
+        "-L/opt/lib",
+        "-L",
+        "/usr/local/lib",
+        "-Wl,-rpath,/opt/lib",
+        "-Xlinker",
+        "--no-undefined",
+        "-shared",
+        "-static",
+        "-rdynamic",
+        "dep.o",
+        "libdep.a",
+        "libdep.so",
+        "-std=c++17",
+        "-fPIC",
+    ]
+    assert _get_compile_options(options) == [
+        "-O2",
+        "-I/opt/include",
+        "-DNDEBUG",
+        "-std=c++17",
+        "-fPIC",
+    ]
+    assert _get_compile_options("-O3") == ["-O3"]
+    assert _get_compile_options("-lm") == []
+    assert _get_compile_options(None) == []
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -187,9 +187,48 @@ def test_random_fill_mt():
     assert no_exception_happened
 
 
+def test_random_deterministic_across_threads():
+    """Check that a seeded engine produces the same values regardless of the thread pool size."""
+    if not tvm.get_global_func("tvm.contrib.random.seed", True):
+        print("skip because extern function is not available")
+        return
+    m = 1024
+    n = 1027
+    A = random.normal(0, 1, size=(m, n))
+    B = random.randint(-127, 128, size=(m, n), dtype="int32")
+    f = tvm.build(te.create_schedule([A.op, B.op]), [A, B], "llvm")
+
+    def run(results, num_threads=None):
+        if num_threads is not None:
+            tvm.get_global_func("runtime.config_threadpool")(1, num_threads)
+        random.seed(7)
+        a = tvm.nd.empty((m, n), A.dtype)
+        b = tvm.nd.empty((m, n), B.dtype)
+        f(a, b)
+        results.append((a.numpy(), b.numpy()))
+
+    expected = []
+    run(expected)
+    # ThreadPool object is thread local. To eliminate effect on other test cases put it into thread
+    single_thread = []
+    x = threading.Thread(target=run, args=(single_thread, 1))
+    x.start()
+    x.join()
+    np.testing.assert_equal(expected[0][0], single_thread[0][0])
+    np.testing.assert_equal(expected[0][1], single_thread[0][1])
+    assert abs(np.mean(expected[0][0])) < 1e-2
+    assert abs(np.std(expected[0][0]) - 1) < 1e-2
+
+    # Reseeding restarts the random stream.
+    again = []
+    run(again)
+    np.testing.assert_equal(expected[0][0], again[0][0])
+
+
 if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
     test_random_fill()
     test_random_fill_mt()
+    test_random_deterministic_across_threads()
@@ -128,7 +128,95 @@ def test_sort_by_key_gpu():
             tvm.testing.assert_allclose(values_out.numpy(), ref_values_out, rtol=1e-5)
 
 
+def test_argsort_and_topk_long_rows():
+    """Tests the parallel, radix and partial sort paths with long rows"""
+    dev = tvm.cpu(0)
+    target = "llvm"
+    # The rows are sorted in parallel from 16384 elements, and radix sorted from 256 elements.
+    dshape = (16, 4096)
+    k = 16
+    for dtype in ["float32", "float16", "int32", "int64"]:
+        data = te.placeholder(dshape, name="data", dtype=dtype)
+        argsort_out = te.extern(
+            data.shape,
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.argsort", ins[0], outs[0], 1, False
+            ),
+            dtype="int32",
+            name="argsort_tensor",
+        )
+        topk_out = te.extern(
+            [(dshape[0], k), (dshape[0], k)],
+            [data],
+            lambda ins, outs: tvm.tir.call_packed(
+                "tvm.contrib.sort.topk", ins[0], outs[0], outs[1], k, 1, "both", True
+            ),
+            dtype=[dtype, "int32"],
+            name="topk_tensor",
+        )
+        s = te.create_schedule([argsort_out.op, topk_out[0].op])
+        f = tvm.build(s, [data, argsort_out, topk_out[0], topk_out[1]], target)
+
+        # Use a small value range, so that there are many ties.
+        np_data = np.random.randint(-50, 50, size=dshape).astype(dtype)
+        assert len(np.unique(np_data[0])) < dshape[1]
+        a = tvm.nd.array(np_data, dev)
+        b = tvm.nd.array(np.zeros(dshape, dtype="int32"), dev)
+        c = tvm.nd.array(np.zeros((dshape[0], k), dtype=dtype), dev)
+        d = tvm.nd.array(np.zeros((dshape[0], k), dtype="int32"), dev)
+        f(a, b, c, d)
+
+        # The ties keep the order of their indices, in both directions.
+        ref_desc = np.argsort(-np_data.astype("float64"), axis=1, kind="stable")
+        ref_asc = np.argsort(np_data, axis=1, kind="stable")[:, :k]
+        tvm.testing.assert_allclose(b.numpy(), ref_desc)
+        tvm.testing.assert_allclose(d.numpy(), ref_asc)
+        tvm.testing.assert_allclose(c.numpy(), np.take_along_axis(np_data, ref_asc, axis=1))
+
+
+def test_argsort_long_rows_nan():
+    """Tests the order of NaNs in the radix sort of long rows"""
+    dev = tvm.cpu(0)
+    target = "llvm"
+    dshape = (4, 1024)
+    for dtype in ["float32", "float64"]:
+        data = te.placeholder(dshape, name="data", dtype=dtype)
+        outs = [
+            te.extern(
+                data.shape,
+                [data],
+                lambda ins, outs, is_ascend=is_ascend: tvm.tir.call_packed(
+                    "tvm.contrib.sort.argsort", ins[0], outs[0], 1, is_ascend
+                ),
+                dtype="int32",
+                name="argsort_tensor",
+            )
+            for is_ascend in [True, False]
+        ]
+        s = te.create_schedule([out.op for out in outs])
+        f = tvm.build(s, [data] + outs, target)
+
+        np_data = np.random.randint(-50, 50, size=dshape).astype(dtype)
+        np_data[np.random.uniform(size=dshape) < 0.1] = np.nan
+        a = tvm.nd.array(np_data, dev)
+        asc = tvm.nd.array(np.zeros(dshape, dtype="int32"), dev)
+        desc = tvm.nd.array(np.zeros(dshape, dtype="int32"), dev)
+        f(a, asc, desc)
+
+        # NaNs go after all the numbers in ascending order, and before them in descending
+        # order, in the order of their indices in both cases.
+        for row, row_asc, row_desc in zip(np_data, asc.numpy(), desc.numpy()):
+            nan_indices = np.flatnonzero(np.isnan(row))
+            num_indices = np.flatnonzero(~np.isnan(row))
+            ref_desc = num_indices[np.argsort(-row[num_indices], kind="stable")]
+            tvm.testing.assert_allclose(row_asc, np.argsort(row, kind="stable"))
+            tvm.testing.assert_allclose(row_desc, np.concatenate([nan_indices, ref_desc]))
+
+
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_argsort_and_topk_long_rows()
+    test_argsort_long_rows_nan()
     test_sort_by_key_gpu()
@@ -0,0 +1,196 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-docstring
+"""Tests for the CPU collective library of disco"""
+
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.runtime import disco as di
+
+_all_session_kinds = [di.ThreadedSession, di.ProcessSession]
+_reduce_ops = [
+    ("sum", np.add),
+    ("prod", np.multiply),
+    ("min", np.minimum),
+    ("max", np.maximum),
+    ("avg", lambda a, b: (a + b) / 2),
+]
+
+
+def _to_ndarray(array, dtype):
+    """Convert a numpy array to an NDArray, rounding to the nearest even for bfloat16."""
+    if dtype != "bfloat16":
+        return tvm.nd.array(array.astype(dtype))
+    bits = array.astype("float32").view("uint32")
+    bits = (bits + 0x7FFF + ((bits >> 16) & 1)) >> 16
+    return tvm.nd.empty(array.shape, "bfloat16").copyfrom(bits.astype("uint16"))
+
+
+def _to_numpy(array):
+    """Convert an NDArray to a numpy array, as float32 for bfloat16."""
+    if array.dtype != "bfloat16":
+        return array.numpy()
+    return (array.numpy().astype("uint32") << 16).view("float32")
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("dtype", ["float32", "float16", "int32"])
+def test_allreduce(session_kind, dtype):
+    sess = session_kind(num_workers=2)
+    sess.init_ccl("cpu", 0, 1)
+
+    array_1 = np.arange(12).reshape(3, 4).astype(dtype)
+    array_2 = np.arange(start=1, stop=-11, step=-1).reshape(3, 4).astype(dtype)
+    d_array = sess.empty((3, 4), dtype)
+    d_array.debug_copy_from(0, array_1)
+    d_array.debug_copy_from(1, array_2)
+    for op, np_op in _reduce_ops:  # pylint: disable=invalid-name
+        dst_array = sess.empty((3, 4), dtype)
+        sess.allreduce(d_array, dst_array, op=op)
+        expected = np_op(array_1, array_2).astype(dtype)
+        for worker_id in range(2):
+            np.testing.assert_equal(dst_array.debug_get_from_remote(worker_id).numpy(), expected)
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("num_workers", [3, 4])
+def test_allreduce_large(session_kind, num_workers):
+    # Larger than a staging slot, so that the allreduce runs in several chunks.
+    shape = (3, 100003)
+    sess = session_kind(num_workers=num_workers)
+    sess.init_ccl("cpu", *range(num_workers))
+
+    arrays = [np.random.randint(-8, 8, size=shape).astype("float32") for _ in range(num_workers)]
+    d_array = sess.empty(shape, "float32")
+    for worker_id, array in enumerate(arrays):
+        d_array.debug_copy_from(worker_id, array)
+    sess.allreduce(d_array, d_array, op="sum")
+    expected = np.sum(arrays, axis=0)
+    for worker_id in range(num_workers):
+        np.testing.assert_equal(d_array.debug_get_from_remote(worker_id).numpy(), expected)
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("num_workers", [4, 8])
+@pytest.mark.parametrize("dtype", ["float16", "bfloat16"])
+def test_allreduce_half_precision(session_kind, num_workers, dtype):
+    # Each one added to the large value is a tie which rounds down to the even value, so the
+    # result is only exact if the partial sums are not rounded at each step.
+    large = 2048 if dtype == "float16" else 256
+    shape = (3, 4)
+    sess = session_kind(num_workers=num_workers)
+    sess.init_ccl("cpu", *range(num_workers))
+
+    arrays = [np.full(shape, large, dtype="float32")]
+    arrays += [np.ones(shape, dtype="float32") for _ in range(1, num_workers)]
+    d_array = sess.empty(shape, dtype)
+    for worker_id, array in enumerate(arrays):
+        d_array.debug_copy_from(worker_id, _to_ndarray(array, dtype))
+    dst_array = sess.empty(shape, dtype)
+    sess.allreduce(d_array, dst_array, op="sum")
+    expected = _to_numpy(_to_ndarray(np.sum(arrays, axis=0), dtype))
+    for worker_id in range(num_workers):
+        result = _to_numpy(dst_array.debug_get_from_remote(worker_id))
+        np.testing.assert_equal(result.astype("float32"), expected.astype("float32"))
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_group_allreduce(session_kind):
+    sess = session_kind(num_workers=4, num_groups=2)
+    sess.init_ccl("cpu", 0, 1, 2, 3)
+
+    array_1 = np.arange(12, dtype="float32").reshape(3, 4)
+    array_2 = np.multiply(array_1, -2)
+    d_array = sess.empty((3, 4), "float32")
+    d_array.debug_copy_from(0, array_1)
+    d_array.debug_copy_from(1, array_2)
+    d_array.debug_copy_from(2, array_2)
+    d_array.debug_copy_from(3, array_2)
+    dst_array = sess.empty((3, 4), "float32")
+    sess.allreduce(d_array, dst_array, op="max", in_group=True)
+    np.testing.assert_equal(
+        dst_array.debug_get_from_remote(1).numpy(), np.maximum(array_1, array_2)
+    )
+    np.testing.assert_equal(dst_array.debug_get_from_remote(3).numpy(), array_2)
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_allgather(session_kind):
+    sess = session_kind(num_workers=2)
+    sess.init_ccl("cpu", 0, 1)
+
+    array = np.arange(36, dtype="float32")
+    d_src = sess.empty((3, 3, 2), "float32")
+    d_dst = sess.empty((3, 4, 3), "float32")
+    d_src.debug_copy_from(0, array[:18])
+    d_src.debug_copy_from(1, array[18:])
+    sess.allgather(d_src, d_dst)
+    for worker_id in range(2):
+        np.testing.assert_equal(
+            d_dst.debug_get_from_remote(worker_id).numpy(), array.reshape(3, 4, 3)
+        )
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_broadcast_scatter_gather(session_kind):
+    sess = session_kind(num_workers=2)
+    sess.init_ccl("cpu", 0, 1)
+
+    array = np.arange(12, dtype="float32").reshape(3, 4)
+    d_array = sess.broadcast(array)
+    np.testing.assert_equal(d_array.debug_get_from_remote(1).numpy(), array)
+
+    d_shard = sess.scatter(array.reshape(2, 6))
+    np.testing.assert_equal(d_shard.debug_get_from_remote(1).numpy(), array.reshape(2, 6)[1])
+
+    d_dst = sess.empty((2, 6), "float32", worker0_only=True)
+    sess.gather_to_worker0(d_shard, d_dst)
+    np.testing.assert_equal(d_dst.debug_get_from_remote(0).numpy(), array.reshape(2, 6))
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_send_to_next_group_receive_from_prev_group(session_kind):
+    sess = session_kind(num_workers=4, num_groups=2)
+    sess.init_ccl("cpu", 0, 1, 2, 3)
+
+    array_1 = np.arange(12, dtype="float32").reshape(3, 4)
+    array_2 = np.arange(start=1, stop=-11, step=-1, dtype="float32").reshape(3, 4)
+    d_array = sess.empty((3, 4), "float32")
+    d_array.debug_copy_from(0, array_1)
+    d_array.debug_copy_from(1, array_2)
+    sess.get_global_func("runtime.disco.cpu.test_send_to_next_group_recv_from_prev_group")(d_array)
+    np.testing.assert_equal(d_array.debug_get_from_remote(2).numpy(), array_1)
+    np.testing.assert_equal(d_array.debug_get_from_remote(3).numpy(), array_2)
+
+
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_worker2_send_to_worker0(session_kind):
+    sess = session_kind(num_workers=4, num_groups=2)
+    sess.init_ccl("cpu", 0, 1, 2, 3)
+
+    array = np.arange(start=1, stop=-11, step=-1, dtype="float32").reshape(3, 4)
+    d_array = sess.empty((3, 4), "float32")
+    d_array.debug_copy_from(2, array)
+    sess.get_global_func("runtime.disco.cpu.test_worker2_sends_to_worker0")(d_array)
+    np.testing.assert_equal(d_array.debug_get_from_remote(0).numpy(), array)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
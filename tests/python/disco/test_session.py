@@ -16,6 +16,7 @@
 # under the License.
 """Basic tests for a Disco session"""
 # pylint: disable=missing-docstring
+import os
 import tempfile
 
 import numpy as np
@@ -154,6 +155,93 @@ def test_ndarray(session_kind):
     np.testing.assert_equal(y_nd, y_np)
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_ndarray_debug_copy(session_kind):
+    num_workers = 4
+    sess = session_kind(num_workers=num_workers)
+    device = tvm.cpu(0)
+    # The arrays of the process session are passed through shared memory, and the pool
+    # wraps around several times.
+    for _ in range(8):
+        x_np = np.random.uniform(size=(1024, 2048)).astype("float32")
+        x_disc = sess.empty(x_np.shape, "float32", device=device)
+        for i in range(1, num_workers):
+            x_disc.debug_copy_from(i, x_np + i)
+        for i in range(1, num_workers):
+            np.testing.assert_equal(x_disc.debug_get_from_remote(i).numpy(), x_np + i)
+
+
+def test_custom_entrypoint(monkeypatch):
+    # A custom entrypoint negotiates the shared memory segment with the controller as the
+    # built-in one does.
+    entrypoint = """
+import sys
+
+import tvm
+from tvm.exec import disco_worker  # pylint: disable=unused-import
+
+args = [int(arg) for arg in sys.argv[1:6]]
+tvm.get_global_func("runtime.disco.WorkerProcess")(*args)
+"""
+    num_workers = 2
+    with tempfile.TemporaryDirectory() as tmpdir:
+        with open(os.path.join(tmpdir, "custom_disco_worker.py"), "w") as f:
+            f.write(entrypoint)
+        pythonpath = os.environ.get("PYTHONPATH")
+        monkeypatch.setenv(
+            "PYTHONPATH", tmpdir if not pythonpath else os.pathsep.join([tmpdir, pythonpath])
+        )
+        sess = di.ProcessSession(num_workers=num_workers, entrypoint="custom_disco_worker")
+        x_np = np.random.uniform(size=(16, 32)).astype("float32")
+        x_disc = sess.empty(x_np.shape, "float32", device=tvm.cpu(0))
+        x_disc.debug_copy_from(1, x_np)
+        np.testing.assert_equal(x_disc.debug_get_from_remote(1).numpy(), x_np)
+        sess.shutdown()
+
+
+def test_custom_process_pool():
+    created = []
+
+    @tvm.register_func("testing.disco.create_process_pool", override=True)
+    def _create_process_pool(num_workers, num_groups, entrypoint):
+        created.append(num_workers)
+        return tvm.get_global_func("runtime.disco.create_process_pool")(
+            num_workers, num_groups, entrypoint
+        )
+
+    num_workers = 2
+    sess = tvm.get_global_func("runtime.disco.SessionProcess")(
+        num_workers, 1, "testing.disco.create_process_pool", "tvm.exec.disco_worker"
+    )
+    assert created == [num_workers]
+    x_np = np.random.uniform(size=(16, 32)).astype("float32")
+    x_disc = sess.empty(x_np.shape, "float32", device=tvm.cpu(0))
+    x_disc.debug_copy_from(1, x_np)
+    np.testing.assert_equal(x_disc.debug_get_from_remote(1).numpy(), x_np)
+    sess.shutdown()
+
+
+def test_ndarray_debug_copy_exceeds_pool():
+    sess = di.ProcessSession(num_workers=2)
+    device = tvm.cpu(0)
+    # Each array takes more than a third of the 64 MB pool, and the arrays received are held,
+    # so the pool runs out and the later arrays are serialized into the messages instead.
+    x_np = np.random.uniform(size=(6, 1024, 1024)).astype("float32")
+    x_disc = sess.empty(x_np.shape, "float32", device=device)
+    received = []
+    for i in range(4):
+        x_disc.debug_copy_from(1, x_np + i)
+        received.append(x_disc.debug_get_from_remote(1))
+    for i, x_nd in enumerate(received):
+        np.testing.assert_equal(x_nd.numpy(), x_np + i)
+    # An array larger than the pool is always serialized.
+    y_np = np.random.uniform(size=(20, 1024, 1024)).astype("float32")
+    y_disc = sess.empty(y_np.shape, "float32", device=device)
+    y_disc.debug_copy_from(1, y_np)
+    np.testing.assert_equal(y_disc.debug_get_from_remote(1).numpy(), y_np)
+    sess.shutdown()
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 def test_string(session_kind):
     num_workers = 4
@@ -195,5 +195,21 @@ def test_alloc_const():
     np.testing.assert_array_equal(np_data, alloc_const2.data.numpy())
 
 
+def test_binary_roundtrip():
+    dev = tvm.cpu(0)
+    dtype = "float32"
+    shape = (3, 5)
+    buf = tvm.tir.decl_buffer(shape, dtype)
+    np_data = np.random.rand(*shape).astype(dtype)
+    data = tvm.nd.array(np_data, device=dev)
+    body = tvm.tir.Evaluate(0)
+    alloc_const = tvm.tir.AllocateConst(buf.data, dtype, shape, data, body)
+    x = tvm.runtime.convert({"const": alloc_const, "name": "binary", "value": 1.5})
+    y = tvm.ir.load_binary(tvm.ir.save_binary(x))
+    tvm.ir.assert_structural_equal(x, y)
+    np.testing.assert_array_equal(np_data, y["const"].data.numpy())
+    assert tvm.ir.save_json(x) == tvm.ir.save_json(y)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
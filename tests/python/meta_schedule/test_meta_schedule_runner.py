@@ -902,5 +902,62 @@ def test_meta_schedule_local_runner_add_test():
     _clean_build(builder_result.artifact_path)
 
 
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.PerfEventMetricCollector", allow_missing=True) is None,
+    reason="perf_event profiling not enabled",
+)
+@pytest.mark.parametrize("runner_kind", ["local", "rpc"])
+def test_meta_schedule_runner_perf_counters(runner_kind):
+    """Test the performance counters returned through the runner results"""
+    mod = MatmulModule
+    builder = LocalBuilder()
+    (builder_result,) = builder.build([BuilderInput(mod, Target("llvm"))])
+    assert builder_result.artifact_path is not None
+    assert builder_result.error_msg is None
+
+    runner_input = RunnerInput(
+        builder_result.artifact_path,
+        "llvm",
+        [
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+            TensorInfo("float32", (MATMUL_N, MATMUL_N)),
+        ],
+    )
+    evaluator_config = EvaluatorConfig(
+        number=1,
+        repeat=1,
+        min_repeat_ms=0,
+        enable_cpu_cache_flush=False,
+        perf_counters=True,
+    )
+    if runner_kind == "local":
+        runner = LocalRunner(timeout_sec=100, evaluator_config=evaluator_config)
+        (runner_future,) = runner.run([runner_input])
+        runner_result = runner_future.result()
+    else:
+        with LocalRPC() as rpc:
+            rpc_config = RPCConfig(
+                tracker_host=rpc.tracker_host,
+                tracker_port=rpc.tracker_port,
+                tracker_key=rpc.tracker_key,
+                session_priority=1,
+                session_timeout_sec=100,
+            )
+            runner = RPCRunner(rpc_config, evaluator_config)
+            (runner_future,) = runner.run([runner_input])
+            runner_result = runner_future.result()
+    assert runner_result.error_msg is None
+    assert runner_result.perf_counters is not None
+    perf_counters = {name: value.value for name, value in runner_result.perf_counters.items()}
+    _clean_build(builder_result.artifact_path)
+    if "cycles" not in perf_counters or "instructions" not in perf_counters:
+        pytest.skip("The hardware counters are not available")
+    if perf_counters["cycles"] > 0 and perf_counters["instructions"] >= 0:
+        assert perf_counters["IPC"] == pytest.approx(
+            perf_counters["instructions"] / perf_counters["cycles"]
+        )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -14,6 +14,9 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os
+import sys
+
 import tvm
 import tvm.testing
 from tvm.contrib import tvmjs, utils
@@ -188,6 +191,68 @@ def test_ndarray_cache():
         np.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_ndarray_cache_mmap():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load_mmap")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    param_dict = {
+        "y_0": np.array([1, 2, 3], dtype="int32"),
+        "y_1": np.random.uniform(size=[10, 20]).astype("float32"),
+        "y_2": np.random.uniform(size=[7]).astype("float16"),
+    }
+
+    temp = utils.tempdir()
+    tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format="raw")
+    fload(str(temp.path), tvm.cpu().device_type, 0)
+    res = fget_params("y", -1)
+    assert len(res) == len(param_dict)
+    for i, v in enumerate(res):
+        np.testing.assert_equal(v.numpy(), param_dict[f"y_{i}"])
+
+    if not sys.platform.startswith("linux"):
+        return
+    # The arrays are views into the mapped shards rather than copies.
+    mapped_ranges = []
+    with open("/proc/self/maps") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 6 and fields[5].startswith(os.path.realpath(temp.path)):
+                begin, end = (int(addr, 16) for addr in fields[0].split("-"))
+                mapped_ranges.append((begin, end))
+    assert mapped_ranges
+    for v in res:
+        addr = v.handle.contents.data + v.handle.contents.byte_offset
+        assert any(begin <= addr and addr + v.numpy().nbytes <= end for begin, end in mapped_ranges)
+
+
+def test_ndarray_cache_load_with_progress():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load_with_progress")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    param_dict = {
+        f"z_{i}": np.random.uniform(size=[200 + i]).astype("float32") for i in range(8)
+    }
+
+    temp = utils.tempdir()
+    tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format="f32-to-bf16", shard_cap_mb=0.002)
+    progress = []
+
+    def on_progress(loaded_bytes, total_bytes, elapsed):
+        progress.append((loaded_bytes, total_bytes))
+
+    # A staging budget smaller than one shard still makes progress.
+    fload(str(temp.path), tvm.cpu().device_type, 0, 3, 1024, on_progress)
+    assert len(progress) > 1
+    assert progress[-1][0] == progress[-1][1]
+    assert all(a[0] < b[0] for a, b in zip(progress, progress[1:]))
+
+    res = fget_params("z", -1)
+    assert len(res) == len(param_dict)
+    for i, v in enumerate(res):
+        v_np = tvmjs._convert_bf16_to_f32(tvmjs._convert_f32_to_bf16(param_dict[f"z_{i}"]))
+        np.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
+
+
 def test_ndarray_cache_update():
     fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
     fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
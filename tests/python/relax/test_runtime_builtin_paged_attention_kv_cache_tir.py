@@ -14,6 +14,7 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import contextlib
 import enum
 import itertools
 from typing import Dict, List, Optional, Tuple, Union
@@ -66,6 +67,12 @@ fcommit_accepted_token_tree_nodes = None
 fattention_with_fuse_qkv = None
 fis_empty = None
 fdebug_get_kv = None
+fenable_prefix_caching = None
+fadd_sequence_with_prefix = None
+fenable_host_offloading = None
+foffload_sequence = None
+fprefetch_sequence = None
+fget_residency_stats = None
 
 ftranspose_append = None
 fcopy_cache = None
@@ -87,6 +94,8 @@ def set_global_func(head_dim, dtype):
     global fclear, fadd_sequence, fremove_sequence, ffork_sequence, fenable_sliding_window_for_seq
     global fpopn, fbegin_forward, fend_forward, fcommit_accepted_token_tree_nodes
     global fattention_with_fuse_qkv, fis_empty, fdebug_get_kv
+    global fenable_prefix_caching, fadd_sequence_with_prefix
+    global fenable_host_offloading, foffload_sequence, fprefetch_sequence, fget_residency_stats
     global ftranspose_append, fcopy_cache, fattn_prefill, fattn_decode
     global fattn_prefill_ragged, fattn_prefill_with_tree_mask, fattn_prefill_with_tree_mask_paged_kv_cache
     global fattn_prefill_sliding_window, fattn_decode_sliding_window
@@ -110,8 +119,44 @@ def set_global_func(head_dim, dtype):
     )
     fis_empty = tvm.get_global_func("vm.builtin.attention_kv_cache_empty")
     fdebug_get_kv = tvm.get_global_func("vm.builtin.attention_kv_cache_debug_get_kv")
+    fenable_prefix_caching = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_enable_prefix_caching"
+    )
+    fadd_sequence_with_prefix = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_add_sequence_with_prefix"
+    )
+    fenable_host_offloading = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_enable_host_offloading"
+    )
+    foffload_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_offload_sequence")
+    fprefetch_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_prefetch_sequence")
+    fget_residency_stats = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_residency_stats"
+    )
 
     target = tvm.target.Target.from_device(device)
+    if target.kind.name == "llvm":
+        # There are no attention kernels for CPU, where the tests only check the KV data.
+        def skip_kernel(*args):  # pylint: disable=unused-argument
+            return None
+
+        def build_cpu(tir_func):
+            return tvm.build(tir_func, target=target).entry_func
+
+        ftranspose_append = build_cpu(_kv_cache_transpose_append(num_kv_heads, head_dim, dtype))
+        fcopy_cache = build_cpu(_kv_cache_debug_get_kv(num_layers, num_kv_heads, head_dim, dtype))
+        fsplit_rotary = build_cpu(
+            llama_rope_with_position_map(
+                rope_theta, rope_scale, head_dim, num_qo_heads, num_kv_heads, dtype, rope_scaling
+            )
+        )
+        fattn_prefill = fattn_decode = skip_kernel
+        fattn_prefill_sliding_window = fattn_decode_sliding_window = skip_kernel
+        fattn_prefill_ragged = skip_kernel
+        fattn_prefill_with_tree_mask = fattn_prefill_with_tree_mask_paged_kv_cache = skip_kernel
+        fmerge_state = fcopy_single_page = fcompact_copy = skip_kernel
+        return
+
     builts = []
     for tir_func in [
         _kv_cache_transpose_append(num_kv_heads, head_dim, dtype),
@@ -159,6 +204,20 @@ def set_global_func(head_dim, dtype):
     ) = builts
 
 
+@contextlib.contextmanager
+def cpu_kv_cache_globals():
+    """Switch the device, the config and the kernels in the module globals to CPU, and restore
+    all of them afterwards, so that the other tests still run on their own device."""
+    global device, head_dim, dtype
+    saved = dict(globals())
+    try:
+        device, head_dim, dtype = tvm.cpu(), 64, "float32"
+        set_global_func(head_dim, dtype)
+        yield
+    finally:
+        globals().update(saved)
+
+
 def create_kv_cache(head_dim, dtype, rope_mode, support_sliding_window):
     fcreate = tvm.get_global_func("vm.builtin.paged_attention_kv_cache_create_reduced")
     cache = fcreate(
@@ -277,6 +336,7 @@ def apply_attention(
     attn_sink_sizes: Optional[List[int]] = None,
     token_tree_parent_ptr_list: Optional[List[List[int]]] = None,
     accepted_leaf_indices: Optional[List[int]] = None,
+    check_attention: bool = True,
 ) -> None:
     seq_ids = []
     append_lengths = []
@@ -389,6 +449,8 @@ def apply_attention(
         qkv = tvm.nd.array(np.concatenate([queries_np, keys_np, values_np], axis=1), device)
         outputs = tvm.nd.empty(queries_np.shape, dtype, device=device)
         fattention_with_fuse_qkv(kv_cache, layer_id, 1.0, qkv, outputs)
+        if not check_attention:
+            continue
 
         # Compute attention expected results.
         outputs = np.expand_dims(outputs.numpy(), axis=0)
@@ -950,6 +1012,122 @@ def test_paged_attention_kv_cache_tree_attn(kv_cache_and_config):
         )
 
 
+def run_prefix_caching(kv_cache, rope_mode, check_attention=True):
+    fclear(kv_cache)
+    fenable_prefix_caching(kv_cache, True)
+
+    cached_k = {}
+    cached_v = {}
+    prompt = list(range(100, 140))
+    assert fadd_sequence_with_prefix(kv_cache, 0, ShapeTuple(prompt)) == 0
+    cached_k[0] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    cached_v[0] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    apply_attention(
+        kv_cache,
+        rope_mode,
+        [(0, len(prompt))],
+        cached_k,
+        cached_v,
+        check_attention=check_attention,
+    )
+    prefix_k = cached_k.pop(0)
+    prefix_v = cached_v.pop(0)
+    fremove_sequence(kv_cache, 0)
+    assert not fis_empty(kv_cache), "The prefix of the removed sequence is not retained"
+
+    # The prompts sharing the first two pages reuse the retained KV data.
+    for seq_id, prompt_length in [(1, 36), (2, 33), (3, 40)]:
+        new_prompt = prompt[: prompt_length - 1] + [seq_id]
+        matched_length = fadd_sequence_with_prefix(kv_cache, seq_id, ShapeTuple(new_prompt))
+        assert matched_length == 2 * page_size
+        cached_k[seq_id] = prefix_k[:, :matched_length]
+        cached_v[seq_id] = prefix_v[:, :matched_length]
+        apply_attention(
+            kv_cache,
+            rope_mode,
+            [(seq_id, prompt_length - matched_length)],
+            cached_k,
+            cached_v,
+            check_attention=check_attention,
+        )
+    verify_cached_kv(kv_cache, seq_ids=[1, 2, 3], expected_k=cached_k, expected_v=cached_v)
+
+    # A prompt diverging in the first page does not match.
+    assert fadd_sequence_with_prefix(kv_cache, 4, ShapeTuple([0] + prompt[1:])) == 0
+
+    for seq_id in range(1, 5):
+        fremove_sequence(kv_cache, seq_id)
+    fenable_prefix_caching(kv_cache, False)
+    assert fis_empty(kv_cache), "The KV cache is not empty after disabling prefix caching"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_prefix_caching(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        return
+    run_prefix_caching(kv_cache, rope_mode)
+
+
+@tvm.testing.requires_llvm
+def test_paged_attention_kv_cache_prefix_caching_cpu():
+    with cpu_kv_cache_globals():
+        kv_cache = create_kv_cache(head_dim, dtype, RopeMode.NONE, False)
+        run_prefix_caching(kv_cache, RopeMode.NONE, check_attention=False)
+
+
+def run_host_offloading(kv_cache, rope_mode, check_attention=True):
+    fclear(kv_cache)
+    fenable_host_offloading(kv_cache, 16)
+    cached_k = {}
+    cached_v = {}
+
+    def append(batch):
+        apply_attention(
+            kv_cache, rope_mode, batch, cached_k, cached_v, check_attention=check_attention
+        )
+
+    append([(0, 40), (1, 20)])
+    append([((2, 0, 32), 5)])
+
+    # Sequence 0 shares its first two pages with sequence 2, so only its last page is offloaded.
+    foffload_sequence(kv_cache, 0)
+    foffload_sequence(kv_cache, 1)
+    num_resident, num_offloaded, num_free_host, num_out, num_in = fget_residency_stats(kv_cache)
+    assert (num_offloaded, num_free_host, num_out, num_in) == (3, 13, 3, 0)
+    assert num_resident == 3
+    verify_cached_kv(kv_cache, seq_ids=[2], expected_k=cached_k, expected_v=cached_v)
+
+    # Offloaded sequences are swapped in by prefetch, or on demand when used.
+    fprefetch_sequence(kv_cache, 1)
+    append([(0, 1), (1, 1), (2, 1)])
+    verify_cached_kv(kv_cache, seq_ids=[0, 1, 2], expected_k=cached_k, expected_v=cached_v)
+    _, num_offloaded, num_free_host, _, num_in = fget_residency_stats(kv_cache)
+    assert (num_offloaded, num_free_host, num_in) == (0, 16, 3)
+
+    for seq_id in range(3):
+        fremove_sequence(kv_cache, seq_id)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+    fenable_host_offloading(kv_cache, 0)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_host_offloading(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        return
+    run_host_offloading(kv_cache, rope_mode)
+
+
+@tvm.testing.requires_llvm
+def test_paged_attention_kv_cache_host_offloading_cpu():
+    with cpu_kv_cache_globals():
+        kv_cache = create_kv_cache(head_dim, dtype, RopeMode.NONE, False)
+        run_host_offloading(kv_cache, RopeMode.NONE, check_attention=False)
+
+
 if __name__ == "__main__":
     HEAD_DIMS = [64, 128]
     DTYPES = ["float16", "float32"]
@@ -968,3 +1146,7 @@ if __name__ == "__main__":
         test_paged_attention_kv_cache_sliding_window(cache_and_config)
         test_paged_attention_kv_cache_tree_attn(cache_and_config)
         test_paged_attention_kv_cache_unlimited_depth(cache_and_config)
+        test_paged_attention_kv_cache_prefix_caching(cache_and_config)
+        test_paged_attention_kv_cache_host_offloading(cache_and_config)
+    test_paged_attention_kv_cache_prefix_caching_cpu()
+    test_paged_attention_kv_cache_host_offloading_cpu()
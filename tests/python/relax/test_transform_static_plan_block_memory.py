@@ -1504,5 +1504,110 @@ def test_view():
     tvm.ir.assert_structural_equal(after, Expected)
 
 
+def test_arena():
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main():
+            cls = Before
+            x = R.builtin.alloc_tensor(R.shape([16, 16]), dtype="float32", runtime_device_index=0)
+            y = R.builtin.alloc_tensor(R.shape([120]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(x, y)
+            z = R.builtin.alloc_tensor(R.shape([256]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(y, z)
+            w = R.builtin.alloc_tensor(R.shape([128]), dtype="float32", runtime_device_index=0)
+            cls.tir_exp(z, w)
+            return w
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func
+        def tir_exp(var_rxplaceholder: T.handle, var_compute: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main() -> R.Tensor((128,), dtype="float32"):
+            cls = Expected
+            arena: R.Object = R.memory.alloc_storage(
+                R.shape([1504]), R.prim_value(0), R.str("global"), R.dtype("uint8")
+            )
+            x: R.Tensor((16, 16), dtype="float32") = R.memory.alloc_tensor(
+                arena, R.prim_value(0), R.shape([16, 16]), R.dtype("float32")
+            )
+            y: R.Tensor((120,), dtype="float32") = R.memory.alloc_tensor(
+                arena, R.prim_value(1024), R.shape([120]), R.dtype("float32")
+            )
+            cls.tir_exp(x, y)
+            z: R.Tensor((256,), dtype="float32") = R.memory.alloc_tensor(
+                arena, R.prim_value(0), R.shape([256]), R.dtype("float32")
+            )
+            cls.tir_exp(y, z)
+            w: R.Tensor((128,), dtype="float32") = R.builtin.alloc_tensor(
+                R.shape([128]), R.dtype("float32"), R.prim_value(0), R.str("global")
+            )
+            cls.tir_exp(z, w)
+            return w
+
+    with tvm.transform.PassContext(config={"relax.memory_plan.use_arena": True}):
+        after = relax.transform.StaticPlanBlockMemory()(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_arena_conditional_first_allocation():
+    @I.ir_module
+    class Before:
+        @T.prim_func
+        def exp(A: T.Buffer((2, 3), "float32"), B: T.Buffer((2, 3), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(
+            cond: R.Tensor((), dtype="bool"), x: R.Tensor((2, 3), dtype="float32")
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Before
+            if cond:
+                alloc: R.Tensor((2, 3), dtype="float32") = R.builtin.alloc_tensor(
+                    R.shape([2, 3]), dtype="float32", runtime_device_index=0
+                )
+                _: R.Tuple() = cls.exp(x, alloc)
+                alloc1: R.Tensor((2, 3), dtype="float32") = R.builtin.alloc_tensor(
+                    R.shape([2, 3]), dtype="float32", runtime_device_index=0
+                )
+                _1: R.Tuple() = cls.exp(alloc, alloc1)
+                y: R.Tensor((2, 3), dtype="float32") = alloc1
+            else:
+                y: R.Tensor((2, 3), dtype="float32") = x
+            alloc2: R.Tensor((2, 3), dtype="float32") = R.builtin.alloc_tensor(
+                R.shape([2, 3]), dtype="float32", runtime_device_index=0
+            )
+            _2: R.Tuple() = cls.exp(y, alloc2)
+            alloc3: R.Tensor((2, 3), dtype="float32") = R.builtin.alloc_tensor(
+                R.shape([2, 3]), dtype="float32", runtime_device_index=0
+            )
+            _3: R.Tuple() = cls.exp(alloc2, alloc3)
+            return alloc3
+
+    with tvm.transform.PassContext(config={"relax.memory_plan.use_arena": True}):
+        after = relax.transform.StaticPlanBlockMemory()(Before)
+    assert relax.analysis.well_formed(after)
+
+    # The arena is allocated at the entry of the function, as its first tensor is carved out
+    # in a branch which does not dominate the tensors after the branch.
+    bindings = [binding for block in after["main"].body.blocks for binding in block.bindings]
+    arena_binding = bindings[0]
+    assert arena_binding.value.op.same_as(tvm.ir.Op.get("relax.memory.alloc_storage"))
+    if_binding = [b for b in bindings if isinstance(b.value, relax.If)][0]
+    alloc = if_binding.value.true_branch.blocks[0].bindings[0].value
+    alloc2 = [b.value for b in bindings if b.var.name_hint == "alloc2"][0]
+    for call in [alloc, alloc2]:
+        assert call.op.same_as(tvm.ir.Op.get("relax.memory.alloc_tensor"))
+        assert call.args[0].same_as(arena_binding.var)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -550,6 +550,36 @@ def test_vm_relax_symbolic_shape_tuple(exec_mode):
         func(R.prim_value(2))
 
 
+def test_vm_relax_repeated_shape_signature(exec_mode):
+    @I.ir_module
+    class mod:
+        @R.function
+        def main(x: R.Tensor(["n"], "float32"), y: R.Tensor(["n"], "float32")):
+            n = T.int64()
+            return R.shape([2 * n])
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.build(mod, target, exec_mode=exec_mode)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    func = vm["main"]
+    x3 = tvm.nd.array(np.zeros(3, "float32"))
+    x5 = tvm.nd.array(np.zeros(5, "float32"))
+
+    # Repeated signatures reuse the validated shape heap.
+    assert func(x3, x3) == [6]
+    assert func(x3, x3) == [6]
+    assert func(x5, x5) == [10]
+    assert func(x3, x3) == [6]
+
+    # A signature that was never validated still goes through the checks.
+    with pytest.raises(ValueError):
+        func(x3, x5)
+    with pytest.raises(ValueError):
+        func(x3, tvm.nd.array(np.zeros(3, "int32")))
+    assert func(x5, x5) == [10]
+
+
 def test_vm_relax_symbolic_prim_value(exec_mode):
     @I.ir_module
     class mod:
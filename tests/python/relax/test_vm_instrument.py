@@ -21,6 +21,8 @@ import tvm.testing
 from tvm import relax
 from tvm.relax.testing import nn
 from tvm.relax.testing.lib_comparator import LibCompareVMInstrument
+from tvm.script import ir as I
+from tvm.script import relax as R
 
 
 def get_exec(data_shape):
@@ -98,5 +100,52 @@ def test_lib_comparator():
     vm["main"](tvm.nd.array(data_np))
 
 
+@I.ir_module
+class DispatchModule:
+    @R.function
+    def square(x: R.Tensor(("n",), "float32")) -> R.Tensor(("n",), "float32"):
+        return R.multiply(x, x)
+
+    @R.function
+    def main(
+        x: R.Tensor(("n",), "float32"),
+        y: R.Tensor(("n",), "float32"),
+        cond: R.Tensor((), "bool"),
+    ) -> R.Tensor(("n",), "float32"):
+        cls = DispatchModule
+        z = R.add(x, y)
+        w = R.nn.relu(R.subtract(z, R.const(1, "float32")))
+        if cond:
+            r = cls.square(w)
+        else:
+            r = R.add(w, x)
+        return r
+
+
+def test_decoded_dispatch_matches_instrumented_run():
+    ex = relax.build(DispatchModule, "llvm")
+    x_np = np.random.randn(33).astype("float32")
+    y_np = np.random.randn(33).astype("float32")
+
+    def run(instrumented, cond):
+        vm = relax.VirtualMachine(ex, tvm.cpu())
+        if instrumented:
+            # An instrument makes the VM run every call through the generic call path, instead
+            # of the pre-decoded instructions and the fused runs of PackedFunc calls.
+            vm.set_instrument(lambda *args: relax.VMInstrumentReturnKind.NO_OP)
+        args = [tvm.nd.array(x_np), tvm.nd.array(y_np), tvm.nd.array(np.array(cond))]
+        # Run twice, so that the second run reuses the state of the first.
+        first = vm["main"](*args).numpy()
+        second = vm["main"](*args).numpy()
+        tvm.testing.assert_allclose(first, second)
+        return first
+
+    for cond in [True, False]:
+        w_np = np.maximum(x_np + y_np - 1, 0)
+        expected = w_np * w_np if cond else w_np + x_np
+        tvm.testing.assert_allclose(run(False, cond), run(True, cond), rtol=1e-6)
+        tvm.testing.assert_allclose(run(False, cond), expected, rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
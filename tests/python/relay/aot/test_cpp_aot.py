@@ -16,7 +16,10 @@
 # under the License.
 """AOT with C++ Runtime Tests"""
 
+import os
 import re
+import subprocess
+import sys
 import textwrap
 
 import numpy as np
@@ -286,5 +289,89 @@ def test_aot_incorrect_input_name(target_kind: str):
         runner.get_input_index(incorrect_input_name)
 
 
+def test_parallel_dispatch():
+    """Test that independent operators give the same results when dispatched in parallel."""
+    dtype = "float32"
+    data = relay.var("data", shape=(10, 5), dtype=dtype)
+    lhs = relay.nn.relu(relay.add(data, relay.const(1.0, dtype)))
+    rhs = relay.tanh(relay.multiply(data, relay.const(2.0, dtype)))
+    func = relay.Function([data], relay.subtract(lhs, rhs))
+
+    input_data = np.random.rand(10, 5).astype(dtype)
+    expected_output = np.maximum(input_data + 1.0, 0.0) - np.tanh(input_data * 2.0)
+
+    with tvm.transform.PassContext(opt_level=3):
+        mod = tvm.relay.build(
+            tvm.IRModule.from_expr(func),
+            target="llvm",
+            executor=backend.Executor(
+                "aot", {"interface-api": "packed", "parallel-dispatch": True}
+            ),
+        )
+    temp_dir = tvm.contrib.utils.TempDirectory()
+    test_so_path = temp_dir / "test.so"
+    mod.export_library(test_so_path, cc="c++", options=["-std=gnu++17", "-g3", "-O0"])
+    loaded_mod = tvm.runtime.load_module(test_so_path)
+    runner = tvm.runtime.executor.AotModule(loaded_mod["default"](tvm.cpu(0)))
+    for _ in range(2):
+        runner.set_input(data=input_data)
+        runner.run()
+        np.testing.assert_allclose(runner.get_output(0).numpy(), expected_output, rtol=1e-5)
+
+
+def test_parallel_dispatch_num_threads():
+    """Test parallel dispatch on a thread pool of several workers, with operators whose
+    default schedules use parallel loops."""
+    dtype = "float32"
+    data = relay.var("data", shape=(16, 64), dtype=dtype)
+    weight = relay.var("weight", shape=(32, 64), dtype=dtype)
+    lhs = relay.nn.relu(relay.nn.dense(data, weight))
+    rhs = relay.tanh(relay.nn.dense(relay.multiply(data, relay.const(2.0, dtype)), weight))
+    func = relay.Function([data, weight], relay.add(lhs, rhs))
+
+    input_data = np.random.rand(16, 64).astype(dtype)
+    weight_data = np.random.rand(32, 64).astype(dtype)
+    expected_output = np.maximum(input_data @ weight_data.T, 0.0) + np.tanh(
+        (input_data * 2.0) @ weight_data.T
+    )
+
+    with tvm.transform.PassContext(opt_level=3):
+        mod = tvm.relay.build(
+            tvm.IRModule.from_expr(func),
+            target="llvm",
+            executor=backend.Executor(
+                "aot", {"interface-api": "packed", "parallel-dispatch": True}
+            ),
+        )
+    temp_dir = tvm.contrib.utils.TempDirectory()
+    test_so_path = temp_dir / "test.so"
+    mod.export_library(test_so_path, cc="c++", options=["-std=gnu++17"])
+    np.save(temp_dir / "data.npy", input_data)
+    np.save(temp_dir / "weight.npy", weight_data)
+    np.save(temp_dir / "expected.npy", expected_output)
+
+    # The size of the thread pool is fixed on first use, so run in a fresh process.
+    script = textwrap.dedent(
+        f"""\
+        import numpy as np
+        import tvm
+        import tvm.runtime.executor
+
+        assert tvm.runtime.num_threads() == 4
+        loaded_mod = tvm.runtime.load_module("{test_so_path}")
+        runner = tvm.runtime.executor.AotModule(loaded_mod["default"](tvm.cpu(0)))
+        for _ in range(8):
+            runner.set_input(data=np.load("{temp_dir / "data.npy"}"))
+            runner.set_input(weight=np.load("{temp_dir / "weight.npy"}"))
+            runner.run()
+            np.testing.assert_allclose(
+                runner.get_output(0).numpy(), np.load("{temp_dir / "expected.npy"}"), rtol=1e-5
+            )
+        """
+    )
+    env = dict(os.environ, TVM_NUM_THREADS="4")
+    subprocess.run([sys.executable, "-c", script], env=env, check=True)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os
+
 import numpy as np
 import tvm
 from tvm import te
@@ -21,6 +23,7 @@ import tvm.testing
 from tvm import relay
 from tvm import autotvm
 from tvm import topi
+from tvm.contrib import graph_executor, utils
 from tvm.relay.backend import te_compiler
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
@@ -284,6 +287,52 @@ def test_compile_propogate_hash():
         assert "hash" in f.attrs.keys()
 
 
+def test_persistent_cache():
+    x = relay.var("x", shape=(8, 16), dtype="float32")
+    y = relay.nn.relu(relay.add(x, relay.const(1.0)))
+    y = relay.nn.softmax(y)
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+    data = np.random.uniform(-1, 1, size=(8, 16)).astype("float32")
+    cache_dir = utils.tempdir()
+
+    def build_and_run(**config):
+        config["relay.backend.persistent_cache_dir"] = cache_dir.path
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            lib = relay.build(mod, target="llvm")
+        module = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        module.set_input("x", data)
+        module.run()
+        return lib, module.get_output(0).numpy()
+
+    def list_entries():
+        return sorted(name for name in cache_dir.listdir() if name.endswith(".tecache"))
+
+    lib, expected = build_and_run()
+    entries = list_entries()
+    assert entries
+    # A hit refreshes the modification time of the entry.
+    for name in entries:
+        os.utime(cache_dir.relpath(name), (0, 0))
+    # The second build loads all the lowered functions from the cache.
+    cached_lib, result = build_and_run()
+    assert list_entries() == entries
+    assert all(os.path.getmtime(cache_dir.relpath(name)) > 0 for name in entries)
+    assert lib.function_metadata.keys() == cached_lib.function_metadata.keys()
+    tvm.testing.assert_allclose(result, expected)
+
+    # The cache is not used when the lowering depends on tuning records, or on config
+    # values which cannot be hashed.
+    for name in entries:
+        os.remove(cache_dir.relpath(name))
+    with autotvm.apply_history_best(None):
+        _, result = build_and_run()
+    tvm.testing.assert_allclose(result, expected)
+    lower_pass = tvm.tir.transform.prim_func_pass(lambda f, mod, ctx: f, opt_level=0)
+    _, result = build_and_run(**{"tir.add_lower_pass": [(1, lower_pass)]})
+    tvm.testing.assert_allclose(result, expected)
+    assert not list_entries()
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -293,3 +342,4 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_persistent_cache()
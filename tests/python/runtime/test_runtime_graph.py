@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os
+import sys
 import tempfile
 import tvm
 import tvm.testing
@@ -151,5 +153,57 @@ def test_save_load_file():
         np.testing.assert_equal(p, params_loaded["x"].numpy())
 
 
+def test_map_params():
+    x = relay.var("x", shape=(1, 10))
+    w = relay.var("w", shape=(7, 10))
+    y = relay.var("y", shape=(1, 10))
+    func = relay.Function([x, w, y], relay.Tuple([relay.add(x, y), relay.nn.dense(y, w)]))
+
+    x_in = np.random.uniform(size=(1, 10)).astype("float32")
+    w_in = np.random.uniform(size=(7, 10)).astype("float32")
+    graph, lib, params = relay.build(func, target="llvm", params={"x": x_in, "w": w_in})
+
+    with tempfile.NamedTemporaryFile() as fp:
+        tvm.runtime.save_param_dict_to_file(params, fp.name, indexed=True)
+        # The indexed format is also readable without mapping.
+        params_loaded = tvm.runtime.load_param_dict_from_file(fp.name)
+        params_mapped = tvm.runtime.load_param_dict_from_file(fp.name, mmap=True)
+        for name in params:
+            np.testing.assert_equal(params_loaded[name].numpy(), params[name].numpy())
+            np.testing.assert_equal(params_mapped[name].numpy(), params[name].numpy())
+
+        mod_mapped = graph_executor.create(graph, lib, tvm.cpu(0))
+        mod_mapped.map_params(fp.name)
+        mods = [graph_executor.create(graph, lib, tvm.cpu(0)) for _ in range(4)]
+        for mod in mods:
+            mod.share_params(mod_mapped, runtime.save_param_dict(params))
+        del mod_mapped
+
+        if sys.platform.startswith("linux"):
+            # The params are bound in place from the mapped file rather than copied.
+            mapped_ranges = []
+            with open("/proc/self/maps") as f:
+                for line in f:
+                    fields = line.split()
+                    if len(fields) >= 6 and fields[5] == os.path.realpath(fp.name):
+                        begin, end = (int(addr, 16) for addr in fields[0].split("-"))
+                        mapped_ranges.append((begin, end))
+            assert mapped_ranges
+            for name in params:
+                for mod in mods:
+                    arr = mod.get_input(name)
+                    addr = arr.handle.contents.data + arr.handle.contents.byte_offset
+                    nbytes = arr.numpy().nbytes
+                    assert any(
+                        begin <= addr and addr + nbytes <= end for begin, end in mapped_ranges
+                    )
+
+    a = np.random.uniform(size=(1, 10)).astype("float32")
+    for mod in mods:
+        mod.run(y=a)
+        np.testing.assert_equal(mod.get_output(0).numpy(), x_in + a)
+        tvm.testing.assert_allclose(mod.get_output(1).numpy(), a @ w_in.T, rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -20,8 +20,12 @@ import tvm
 from tvm import te
 import tvm.testing
 
-from tvm.contrib import utils
+from tvm.contrib import cc, graph_executor, utils
+import ctypes
 import os
+import re
+
+import numpy as np
 
 header_file_dir_path = utils.tempdir()
 
@@ -259,5 +263,59 @@ def test_import_static_library():
     assert not loaded_lib.is_dso_exportable
 
 
+@tvm.testing.requires_llvm
+def test_pack_imports_to_c_file():
+    A = te.placeholder((1024,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    mod = tvm.build(s, [A, B], "llvm", name="myadd")
+
+    # The C source written to a file is the same as the one returned as a string.
+    temp = utils.tempdir()
+    path_cc = temp.relpath("devc.c")
+    tvm.runtime._ffi_api.ModulePackImportsToCFile(mod, True, path_cc, "prefix_")
+    with open(path_cc) as f:
+        assert f.read() == tvm.runtime._ffi_api.ModulePackImportsToC(mod, True, "prefix_")
+
+
+@tvm.testing.requires_llvm
+def test_pack_imports_to_c_file_large_blob():
+    # The weight is serialized into the blob of the imported graph executor factory, which is
+    # larger than a batch of 16 chunks of 327680 bytes formatted in parallel.
+    x = relay.var("x", shape=(1, 1536), dtype="float32")
+    w = relay.var("w", shape=(1024, 1536), dtype="float32")
+    func = relay.Function([x, w], relay.nn.dense(x, w))
+    w_np = np.random.uniform(size=(1024, 1536)).astype("float32")
+    with tvm.transform.PassContext(opt_level=3):
+        factory = relay.build(tvm.IRModule.from_expr(func), "llvm", params={"w": w_np})
+
+    temp = utils.tempdir()
+    path_obj = temp.relpath("lib.o")
+    path_cc = temp.relpath("devc.c")
+    path_so = temp.relpath("lib.so")
+    factory.get_lib().save(path_obj)
+    tvm.runtime._ffi_api.ModulePackImportsToCFile(factory.module, False, path_cc, "")
+    cc.create_shared(path_so, [path_obj, path_cc])
+
+    # The bytes in the compiled library are the ones written as C.
+    with open(path_cc) as f:
+        text = f.read()
+    declared = re.search(r"__tvm_dev_mblob\[(\d+)\] = \{", text)
+    blob = bytes(int(byte, 16) for byte in re.findall(r"0x([0-9a-f]{2}),", text[declared.end() :]))
+    assert len(blob) == int(declared.group(1))
+    assert len(blob) > 16 * 327680
+    assert int.from_bytes(blob[:8], "little") == len(blob) - 8
+    dll = ctypes.CDLL(path_so)
+    assert bytes((ctypes.c_ubyte * len(blob)).in_dll(dll, "__tvm_dev_mblob")) == blob
+
+    # The modules and the weight are loaded back from the blob.
+    loaded = tvm.runtime.load_module(path_so)
+    gmod = graph_executor.GraphModule(loaded["default"](tvm.cpu()))
+    x_np = np.random.uniform(size=(1, 1536)).astype("float32")
+    gmod.set_input("x", x_np)
+    gmod.run()
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), x_np @ w_np.T, rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import ctypes
+
 import tvm
 from tvm import te
 from tvm.contrib import cc, utils, popen_pool
@@ -241,7 +243,66 @@ def test_combine_module_llvm():
     check_llvm()
 
 
+@tvm.testing.requires_llvm
+def test_prelink_library_module():
+    nn = 12
+    A = te.placeholder((nn,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    temp = utils.tempdir()
+    path_dso = temp.relpath("mylib.so")
+    tvm.build(s, [A, B], "llvm", name="myadd").export_library(path_dso)
+
+    m = tvm.runtime.load_module(path_dso)
+    tvm.get_global_func("runtime.ModulePrelink")(m, ["myadd", "missing"])
+    assert not m.implements_function("missing")
+    for _ in range(2):
+        a = tvm.nd.array(np.random.uniform(size=nn).astype(A.dtype))
+        b = tvm.nd.array(np.zeros(nn, dtype=A.dtype))
+        m["myadd"](a, b)
+        np.testing.assert_equal(b.numpy(), a.numpy() + 1)
+
+
+@tvm.testing.requires_llvm
+def test_system_lib_late_symbol():
+    nn = 12
+    temp = utils.tempdir()
+
+    def build_lib(value):
+        A = te.placeholder((nn,), name="A")
+        B = te.compute(A.shape, lambda *i: A(*i) + value, name="B")
+        s = te.create_schedule(B.op)
+        path_dso = temp.relpath(f"mylib{value}.so")
+        tvm.build(s, [A, B], "llvm", name="myadd").export_library(path_dso)
+        # Loading the library as a module initializes its context functions.
+        return tvm.runtime.load_module(path_dso), ctypes.CDLL(path_dso)
+
+    def register(lib):
+        tvm._ffi.base._LIB.TVMBackendRegisterSystemLibSymbol(
+            b"testing_late_symbol_myadd", ctypes.cast(lib.myadd, ctypes.c_void_p)
+        )
+
+    def check(value):
+        a = tvm.nd.array(np.random.uniform(size=nn).astype("float32"))
+        b = tvm.nd.array(np.zeros(nn, dtype="float32"))
+        syslib["myadd"](a, b)
+        np.testing.assert_equal(b.numpy(), a.numpy() + value)
+
+    libs = [build_lib(1.0), build_lib(2.0)]
+    syslib = tvm.runtime.system_lib("testing_late_symbol_")
+    assert not syslib.implements_function("myadd")
+    # A symbol registered after a failed lookup is found by the next lookup.
+    register(libs[0][1])
+    assert syslib.implements_function("myadd")
+    check(1.0)
+    # A symbol that is overridden resolves to its new address.
+    register(libs[1][1])
+    check(2.0)
+
+
 if __name__ == "__main__":
     test_combine_module_llvm()
+    test_prelink_library_module()
+    test_system_lib_late_symbol()
     test_device_module_dump()
     test_dso_module_load()
@@ -28,6 +28,7 @@ from tvm.runtime import profiler_vm
 from tvm import relay
 from tvm.relay.testing import mlp
 from tvm.contrib.debugger import debug_executor
+from tvm.contrib import graph_executor
 from tvm import rpc
 from tvm.contrib import utils
 from tvm.runtime.profiling import Report
@@ -107,6 +108,29 @@ def test_graph_executor(target, dev):
     assert "Graph" in str(report)
 
 
+def test_chrome_trace():
+    mod, params = mlp.get_workload(1)
+    exe = relay.build(mod, "llvm", params=params)
+    gr = graph_executor.GraphModule(exe["default"](tvm.cpu()))
+    gr.set_input("data", np.random.rand(1, 1, 28, 28).astype("float32"))
+
+    def graph_executor_events():
+        trace = json.loads(tvm.runtime.profiling.export_chrome_trace())
+        return [e for e in trace["traceEvents"] if e.get("cat") == "graph_executor"]
+
+    tvm.runtime.profiling.start_tracing()
+    gr.run()
+    tvm.runtime.profiling.stop_tracing()
+    events = graph_executor_events()
+    assert any("fused_nn_softmax" in e["name"] for e in events)
+    for event in events:
+        assert event["ph"] == "X"
+        assert event["dur"] >= 0
+    # The runs after stop_tracing are not recorded.
+    gr.run()
+    assert len(graph_executor_events()) == len(events)
+
+
 @tvm.testing.parametrize_targets("cuda", "llvm")
 @pytest.mark.skipif(
     tvm.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is None,
@@ -263,5 +287,57 @@ def test_profile_function(target, dev):
     assert report[metric].value > 0
 
 
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.PerfEventMetricCollector", allow_missing=True) is None,
+    reason="perf_event profiling not enabled",
+)
+def test_perf_event():
+    f = tvm.build(axpy_cpu, target="llvm")
+    dev = tvm.cpu()
+    a = tvm.nd.array(np.ones(10), device=dev)
+    b = tvm.nd.array(np.ones(10), device=dev)
+    c = tvm.nd.array(np.zeros(10), device=dev)
+    # Software counters are available even where the hardware counters are not.
+    collector = tvm.runtime.profiling.PerfEventMetricCollector(["page-faults"])
+    report = tvm.runtime.profiling.profile_function(f, dev, [collector])(a, b, c)
+    if "page-faults" not in report.keys():
+        pytest.skip("perf_event_open is not permitted")
+    assert report["page-faults"].value >= 0
+
+    with pytest.raises(tvm.TVMError):
+        tvm.runtime.profiling.PerfEventMetricCollector(["not-a-counter"])
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.skipif(
+    tvm.get_global_func("runtime.profiling.PerfEventMetricCollector", allow_missing=True) is None,
+    reason="perf_event profiling not enabled",
+)
+def test_perf_event_report():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.vm.compile(mod, "llvm", params=params)
+    vm = profiler_vm.VirtualMachineProfiler(exe, tvm.cpu())
+
+    data = tvm.nd.array(np.random.rand(1, 1, 28, 28).astype("float32"), device=tvm.cpu())
+    report = vm.profile(
+        data,
+        func_name="main",
+        collectors=[tvm.runtime.profiling.PerfEventMetricCollector()],
+    )
+    calls = json.loads(report.json())["calls"]
+    if "cycles" not in calls[0] or "instructions" not in calls[0]:
+        pytest.skip("The hardware counters are not available")
+    for metric in ["cycles", "instructions", "cache-misses", "branch-misses", "IPC"]:
+        assert metric in str(report)
+    for call in calls:
+        cycles = call["cycles"]["count"]
+        instructions = call["instructions"]["count"]
+        if cycles > 0 and instructions >= 0:
+            assert call["IPC"]["ratio"] == pytest.approx(instructions / cycles)
+        else:
+            assert "IPC" not in call
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -181,6 +181,53 @@ def test_rpc_large_array():
     check_remote()
 
 
+@tvm.testing.requires_rpc
+@pytest.mark.parametrize("compression", [False, True])
+def test_rpc_bulk_transfer(compression):
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    # Small chunks so that the copies are split and pipelined.
+    remote.set_bulk_transfer_config(
+        chunk_bytes=65536 + 12, max_outstanding_chunks=3, compression=compression
+    )
+    dev = remote.cpu(0)
+
+    sparse_np = np.zeros((1000, 300), dtype="float32")
+    sparse_np[::7, ::3] = np.random.uniform(size=sparse_np[::7, ::3].shape)
+    dense_np = np.random.uniform(size=(333, 333)).astype("float32")
+    for x_np in [sparse_np, dense_np, np.ones((3,), dtype="int8")]:
+        x = tvm.nd.array(x_np, dev)
+        np.testing.assert_equal(x.numpy(), x_np)
+
+    stats = remote.transfer_stats()
+    nbytes = sparse_np.nbytes + dense_np.nbytes + 3
+    assert stats["bytes_to_remote"] == nbytes
+    assert stats["bytes_from_remote"] == nbytes
+    assert stats["num_chunks"] > 2 * (nbytes // (65536 + 12))
+    if compression:
+        assert stats["num_compressed_chunks"] > 0
+        assert stats["wire_bytes_to_remote"] < stats["bytes_to_remote"]
+        assert stats["wire_bytes_from_remote"] < stats["bytes_from_remote"]
+    else:
+        assert stats["num_compressed_chunks"] == 0
+        assert stats["wire_bytes_to_remote"] == stats["bytes_to_remote"]
+
+
+@tvm.testing.requires_rpc
+@pytest.mark.skipif(sys.platform != "linux", reason="shared memory RPC requires Linux")
+def test_rpc_shared_memory():
+    # A small ring so that the tensors wrap around it many times.
+    remote = rpc.connect_shared_memory(ring_bytes=4096 + 7)
+    dev = remote.cpu(0)
+    fecho = remote.get_function("testing.echo")
+    assert fecho(1, 2, 3) == 1
+    assert fecho("xyz") == "xyz"
+    for shape in [(3,), (1000, 300)]:
+        x_np = np.random.uniform(size=shape).astype("float32")
+        x = tvm.nd.array(x_np, dev)
+        np.testing.assert_equal(x.numpy(), x_np)
+
+
 @tvm.testing.skip_if_32bit(reason="skipping test for i386.")
 @tvm.testing.requires_rpc
 def test_rpc_echo():
@@ -465,5 +465,48 @@ def test_all_nan_values_are_equivalent():
     assert tvm.ir.structural_hash(float_1) == tvm.ir.structural_hash(float_2)
 
 
+def test_structural_hash_cache():
+    """The cached hash values match the ones computed without the cache."""
+
+    @T.prim_func
+    def func(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+        for i in range(16):
+            with T.block("B"):
+                vi = T.axis.spatial(16, i)
+                B[vi] = A[vi] * T.float32(2) + T.float32(1)
+
+    x = tvm.tir.Var("x", "int32")
+    shared = x + 1
+    dag = tvm.tir.Add(shared, shared)
+    const = tvm.tir.const(3.5, "float32") * tvm.tir.const(2, "float32")
+    objects = [func, func.body, dag, shared, const, tvm.tir.Add(dag, dag)]
+
+    expected = [
+        (tvm.ir.structural_hash(obj), tvm.ir.structural_hash(obj, map_free_vars=True))
+        for obj in objects
+    ]
+    with tvm.ir.structural_hash_cache():
+        for _ in range(2):
+            for obj, (hash_value, hash_mapped) in zip(objects, expected):
+                assert tvm.ir.structural_hash(obj) == hash_value
+                assert tvm.ir.structural_hash(obj, map_free_vars=True) == hash_mapped
+        assert tvm.ir.structural_equal(func, func)
+        assert not tvm.ir.structural_equal(dag, shared)
+
+
+def test_structural_hash_cache_module_update():
+    """An IRModule is updated in place, so its hash is not cached."""
+    x = tvm.tir.Var("x", "int32")
+    mod = tvm.IRModule({"f": tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + 1))})
+    wrapper = tvm.runtime.convert([mod])
+    with tvm.ir.structural_hash_cache():
+        hash_before = tvm.ir.structural_hash(mod)
+        wrapper_before = tvm.ir.structural_hash(wrapper)
+        y = tvm.tir.Var("y", "int32")
+        mod["g"] = tvm.tir.PrimFunc([y], tvm.tir.Evaluate(y * 2))
+        assert tvm.ir.structural_hash(mod) != hash_before
+        assert tvm.ir.structural_hash(wrapper) != wrapper_before
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -14,9 +14,12 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import pytest
+
 import tvm
 import tvm.testing
 from tvm import te
+from tvm.ir.instrument import PassTimingInstrument
 
 
 def test_prim_func_pass():
@@ -63,6 +66,102 @@ def test_cow_pass():
     assert func_hash == mod["main"].__hash__()
 
 
+def test_incremental_pass():
+    def make_module(value):
+        x = te.var("x")
+        f = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x * value - x))
+        g = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x * 2 - x))
+        return tvm.IRModule({"f": f, "g": g})
+
+    tvm.transform.clear_function_pass_memo()
+    timing = PassTimingInstrument()
+    config = {"ir.incremental_passes": True}
+    with tvm.transform.PassContext(config=config, instruments=[timing]):
+        first = tvm.tir.transform.Simplify()(make_module(1))
+        # Only the function which changed is transformed again.
+        second = tvm.tir.transform.Simplify()(make_module(3))
+        profiles = timing.render()
+    assert "[memo hits: 1/2]" in profiles
+    assert second["g"].same_as(first["g"])
+    tvm.ir.assert_structural_equal(second["f"], tvm.tir.transform.Simplify()(make_module(3))["f"])
+    tvm.transform.clear_function_pass_memo()
+
+
+def test_incremental_pass_parameters():
+    def make_module():
+        x = te.var("x")
+        A = tvm.tir.decl_buffer((4,), "float32", name="A")
+        i = te.var("i")
+        loop = tvm.tir.For(i, 0, 4, tvm.tir.ForKind.VECTORIZED, tvm.tir.BufferStore(A, x, [i]))
+        return tvm.IRModule({"main": tvm.tir.PrimFunc([x, A], loop)})
+
+    transformed = []
+
+    @tvm.tir.transform.prim_func_pass(opt_level=0)
+    def count_transforms(func, mod, ctx):
+        transformed.append(func)
+        return func
+
+    tvm.transform.clear_function_pass_memo()
+    with tvm.transform.PassContext(config={"ir.incremental_passes": True}):
+        # The passes created with other parameters do not share results.
+        vectorized = tvm.tir.transform.VectorizeLoop(True)(make_module())
+        skipped = tvm.tir.transform.VectorizeLoop(False)(make_module())
+        # Passes without a memo key, such as the Python passes, always run.
+        count_transforms(make_module())
+        count_transforms(make_module())
+    assert len(transformed) == 2
+    assert not isinstance(vectorized["main"].body, tvm.tir.For)
+    assert isinstance(skipped["main"].body, tvm.tir.For)
+    assert skipped["main"].body.kind == tvm.tir.ForKind.SERIAL
+    tvm.transform.clear_function_pass_memo()
+
+
+def test_parallel_pass():
+    def make_module():
+        funcs = {}
+        for i in range(16):
+            x = te.var("x")
+            funcs["f%d" % i] = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x * (i + 1) - x * i))
+        return tvm.IRModule(funcs)
+
+    @tvm.tir.transform.prim_func_pass(opt_level=0)
+    def drop_first(func, mod, ctx):
+        # The pool threads run in the scope of the caller's PassContext.
+        assert int(tvm.transform.PassContext.current().config["tir.prim_func_pass_threads"]) == 4
+        return None if func.same_as(mod["f0"]) else func
+
+    pipeline = tvm.transform.Sequential([tvm.tir.transform.Simplify(), drop_first])
+    with tvm.transform.PassContext(config={"tir.prim_func_pass_threads": 4}):
+        parallel = pipeline(make_module())
+    expected = tvm.tir.transform.Simplify()(make_module())
+
+    assert "f0" not in [gvar.name_hint for gvar in parallel.get_global_vars()]
+    for i in range(1, 16):
+        tvm.ir.assert_structural_equal(parallel["f%d" % i], expected["f%d" % i])
+
+
+def test_parallel_pass_error():
+    funcs = {}
+    for i in range(16):
+        x = te.var("x")
+        funcs["f%d" % i] = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + i))
+    mod = tvm.IRModule(funcs)
+
+    @tvm.tir.transform.prim_func_pass(opt_level=0)
+    def fail(func, mod, ctx):
+        raise ValueError("fail in the pass")
+
+    # The error of a pool thread reaches the caller with its original type.
+    with tvm.transform.PassContext(config={"tir.prim_func_pass_threads": 4}):
+        with pytest.raises(ValueError, match="fail in the pass"):
+            fail(mod)
+
+
 if __name__ == "__main__":
     test_cow_pass()
     test_prim_func_pass()
+    test_incremental_pass()
+    test_incremental_pass_parameters()
+    test_parallel_pass()
+    test_parallel_pass_error()
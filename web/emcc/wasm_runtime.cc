@@ -51,6 +51,7 @@
 #include "src/runtime/rpc/rpc_module.cc"
 #include "src/runtime/rpc/rpc_session.cc"
 #include "src/runtime/system_library.cc"
+#include "src/runtime/tracing.cc"
 #include "src/runtime/workspace_pool.cc"
 // relax setup
 #include "src/runtime/memory/memory_manager.cc"